@@ -93,6 +93,19 @@ static int32_t fix_sign(uint32_t inval, int8_t number_of_bits);
  */
 static int8_t read_otp_word(uint8_t addr, uint16_t *lsb_msb, struct bmm350_dev *dev);
 
+/*!
+ * @brief This internal API is used to release the bus while keeping the first error of the
+ * sequence that held it.
+ *
+ * @param[in] rslt           : Result of the sequence that held the bus.
+ * @param[in, out] dev       : Structure instance of bmm350_dev.
+ *
+ * @return Result of API execution status
+ * @retval = 0 -> Success
+ * @retval < 0 -> Error
+ */
+static int8_t release_bus(int8_t rslt, struct bmm350_dev *dev);
+
 /*!
  * @brief This internal API is used to read raw magnetic x,y and z axis data along with temperature.
  *
@@ -105,6 +118,43 @@ static int8_t read_otp_word(uint8_t addr, uint16_t *lsb_msb, struct bmm350_dev *
  */
 static int8_t read_out_raw_data(float *out_data, struct bmm350_dev *dev);
 
+/*!
+ * @brief This internal API is used to convert the raw mag and temperature register bytes into signed
+ * raw data, honouring the enabled axes.
+ *
+ * @param[in]  mag_data      : Buffer holding BMM350_MAG_TEMP_DATA_LEN bytes starting at BMM350_REG_MAG_X_XLSB.
+ * @param[out] raw_data      : Structure instance of bmm350_raw_mag_data.
+ * @param[in]  dev           : Structure instance of bmm350_dev.
+ *
+ *  @return void
+ */
+static void parse_raw_mag_temp_data(const uint8_t *mag_data,
+                                    struct bmm350_raw_mag_data *raw_data,
+                                    const struct bmm350_dev *dev);
+
+/*!
+ * @brief This internal API is used to convert raw mag data to uT and raw temperature data to degC.
+ *
+ * @param[in]  raw_data      : Structure instance of bmm350_raw_mag_data, the sum of count samples.
+ * @param[in]  count         : Number of samples summed in raw_data, 1 for a single sample.
+ * @param[out] out_data      : Array to store mag data in uT and temperature in degC.
+ *
+ *  @return void
+ */
+static void convert_raw_data(const struct bmm350_raw_mag_data *raw_data, uint16_t count, float *out_data);
+
+/*!
+ * @brief This internal API applies the OTP based compensation to converted mag and temperature data
+ * and stores the result for the enabled axes.
+ *
+ * @param[in]  out_data        : Array of mag data in uT and temperature in degC.
+ * @param[out] mag_temp_data   : Structure instance of bmm350_mag_temp_data.
+ * @param[in]  dev             : Structure instance of bmm350_dev.
+ *
+ *  @return void
+ */
+static void compensate_data(float *out_data, struct bmm350_mag_temp_data *mag_temp_data, const struct bmm350_dev *dev);
+
 /*!
  * @brief This internal API is used to convert raw mag lsb data to uT and raw temperature data to degC.
  *
@@ -178,12 +228,92 @@ static int8_t self_test_config(uint8_t st_cmd,
  */
 static int8_t set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev *dev);
 
+/*!
+ * @brief This internal API is used to trigger a forced measurement from suspend mode with
+ * bmm350_trigger_forced and wait for it.
+ *
+ * @param[in] powermode          : BMM350_FORCED_MODE or BMM350_FORCED_MODE_FAST.
+ * @param[in] delay_us           : Wait after the trigger.
+ * @param[in, out] dev           : Structure instance of bmm350_dev.
+ *
+ * @return Result of API execution status
+ * @retval = 0 -> Success
+ * @retval < 0 -> Error
+ */
+static int8_t forced_trigger(enum bmm350_power_modes powermode, uint32_t delay_us, struct bmm350_dev *dev);
+
+/*!
+ * @brief This internal API sends a magnetic reset command, waits for it to complete and
+ * verifies it in PMU_CMD_STATUS_0.
+ *
+ * @param[in] pmu_cmd            : Magnetic reset PMU command.
+ * @param[in] delay_us           : Time to wait for the command to complete.
+ * @param[in] pmu_cmd_value      : Expected PMU_CMD_STATUS_0.pmu_cmd_value.
+ * @param[in, out] dev           : Structure instance of bmm350_dev.
+ *
+ * @return Result of API execution status
+ * @retval = 0 -> Success
+ * @retval < 0 -> Error
+ */
+static int8_t magnetic_reset_cmd(uint8_t pmu_cmd, uint32_t delay_us, uint8_t pmu_cmd_value, struct bmm350_dev *dev);
+
+/*!
+ * @brief This internal API sends the soft-reset command and waits for it to complete,
+ * or runs the soft-reset override if one is set.
+ *
+ * @param[in, out] dev  : Structure instance of bmm350_dev.
+ *
+ * @return Result of API execution status
+ * @retval = 0 -> Success
+ * @retval < 0 -> Error
+ */
+static int8_t soft_reset_cmd(struct bmm350_dev *dev);
+
+/*!
+ * @brief This internal API decodes the register values of a snapshot with the register masks.
+ *
+ * @param[in,out] snapshot : Structure instance of bmm350_reg_snapshot.
+ *
+ *  @return void
+ */
+static void decode_reg_snapshot(struct bmm350_reg_snapshot *snapshot);
+
+/*!
+ * @brief This internal API stores an event in the event log of the device, if one is attached.
+ *
+ * @param[in] type      : Event type, BMM350_EVENT_*.
+ * @param[in] code      : Result code.
+ * @param[in] arg       : Type specific argument.
+ * @param[in,out] dev   : Structure instance of bmm350_dev.
+ *
+ *  @return void
+ */
+static void log_event(uint8_t type, int8_t code, uint16_t arg, struct bmm350_dev *dev);
+
+/*!
+ * @brief This internal API packs the PMU command status 0 into the argument of a PMU status event.
+ *
+ * @param[in] pmu_cmd_stat_0 : Structure instance of bmm350_pmu_cmd_status_0.
+ *
+ * @return Event argument
+ */
+static uint16_t pmu_status_arg(const struct bmm350_pmu_cmd_status_0 *pmu_cmd_stat_0);
+
 /********************** Global function definitions ************************/
 
 /*!
  * @brief This API is the entry point. Call this API before using other APIs.
  */
 int8_t bmm350_init(struct bmm350_dev *dev)
+{
+    return bmm350_init_with_magreset(BMM350_FLUXGUIDE_9MS, dev);
+}
+
+/*!
+ * @brief This API initializes the sensor like bmm350_init, applying the given
+ * magnetic reset variant at the end of the sequence.
+ */
+int8_t bmm350_init_with_magreset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev)
 {
     /* Variable to store the function result */
     int8_t rslt;
@@ -194,9 +324,6 @@ int8_t bmm350_init(struct bmm350_dev *dev)
     /* Variable to store the command to power-off the OTP */
     uint8_t otp_cmd = BMM350_OTP_CMD_PWR_OFF_OTP;
 
-    /* Variable to store soft-reset command */
-    uint8_t soft_reset;
-
     /* Check for null pointer in the device structure */
     rslt = null_ptr_check(dev);
 
@@ -213,15 +340,7 @@ int8_t bmm350_init(struct bmm350_dev *dev)
         if (rslt == BMM350_OK)
         {
             /* Soft-reset */
-            soft_reset = BMM350_CMD_SOFTRESET;
-
-            /* Set the command in the command register */
-            rslt = bmm350_set_regs(BMM350_REG_CMD, &soft_reset, 1, dev);
-
-            if (rslt == BMM350_OK)
-            {
-                rslt = bmm350_delay_us(BMM350_SOFT_RESET_DELAY, dev);
-            }
+            rslt = soft_reset_cmd(dev);
         }
 
         if (rslt == BMM350_OK)
@@ -249,13 +368,14 @@ int8_t bmm350_init(struct bmm350_dev *dev)
 
                 if (rslt == BMM350_OK)
                 {
-                    rslt = bmm350_magnetic_reset_and_wait(dev);
+                    rslt = bmm350_magnetic_reset(reset_type, dev);
                 }
             }
         }
         else
         {
             rslt = BMM350_E_DEV_NOT_FOUND;
+            log_event(BMM350_EVENT_ERROR, rslt, dev->chip_id, dev);
         }
     }
 
@@ -277,12 +397,20 @@ int8_t bmm350_set_regs(uint8_t reg_addr, const uint8_t *reg_data, uint16_t len,
     /* Proceed if null check is fine */
     if ((rslt == BMM350_OK) && (reg_data != NULL) && (len != 0))
     {
-        /* Write the data to the reg_addr */
-        dev->intf_rslt = dev->write(reg_addr, reg_data, len, dev->intf_ptr);
+        rslt = bmm350_bus_acquire(dev);
 
-        if (dev->intf_rslt != BMM350_INTF_RET_SUCCESS)
+        if (rslt == BMM350_OK)
         {
-            rslt = BMM350_E_COM_FAIL;
+            /* Write the data to the reg_addr */
+            dev->intf_rslt = dev->write(reg_addr, reg_data, len, dev->intf_ptr);
+
+            if (dev->intf_rslt != BMM350_INTF_RET_SUCCESS)
+            {
+                rslt = BMM350_E_COM_FAIL;
+                log_event(BMM350_EVENT_ERROR, rslt, reg_addr, dev);
+            }
+
+            rslt = release_bus(rslt, dev);
         }
     }
     else
@@ -316,10 +444,24 @@ int8_t bmm350_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct
     /* Proceed if null check is fine */
     if ((rslt == BMM350_OK) && (reg_data != NULL))
     {
-        /* Read the data from the reg_addr */
-        dev->intf_rslt = dev->read(reg_addr, temp_buf, temp_len, dev->intf_ptr);
+        rslt = bmm350_bus_acquire(dev);
+
+        if (rslt == BMM350_OK)
+        {
+            /* Read the data from the reg_addr */
+            dev->intf_rslt = dev->read(reg_addr, temp_buf, temp_len, dev->intf_ptr);
+
+            if (dev->intf_rslt != BMM350_INTF_RET_SUCCESS)
+            {
+                rslt = BMM350_E_COM_FAIL;
+                log_event(BMM350_EVENT_ERROR, rslt, reg_addr, dev);
+            }
+
+            /* Release the bus before copying the data */
+            rslt = release_bus(rslt, dev);
+        }
 
-        if (dev->intf_rslt == BMM350_INTF_RET_SUCCESS)
+        if (rslt == BMM350_OK)
         {
             /* Copy data after dummy byte indices */
             while (index < len)
@@ -328,10 +470,6 @@ int8_t bmm350_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct
                 index++;
             }
         }
-        else
-        {
-            rslt = BMM350_E_COM_FAIL;
-        }
     }
     else
     {
@@ -341,6 +479,90 @@ int8_t bmm350_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct
     return rslt;
 }
 
+/*!
+ * @brief This API acquires the bus through the bus lock callback. Calls can be nested.
+ */
+int8_t bmm350_bus_acquire(struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    /* Time spent waiting for the bus */
+    uint32_t wait_us = 0;
+
+    /* Check for null pointer in the device structure */
+    rslt = null_ptr_check(dev);
+
+    if (rslt == BMM350_OK)
+    {
+        if ((dev->bus_lock != NULL) && (dev->bus_lock_depth == 0))
+        {
+            dev->intf_rslt = dev->bus_lock(&wait_us, dev->intf_ptr);
+
+            if (dev->intf_rslt == BMM350_INTF_RET_SUCCESS)
+            {
+                dev->bus_stats.lock_count++;
+                dev->bus_stats.wait_time_us += wait_us;
+
+                if (wait_us > 0)
+                {
+                    dev->bus_stats.contended_count++;
+                }
+
+                if (wait_us > dev->bus_stats.max_wait_us)
+                {
+                    dev->bus_stats.max_wait_us = wait_us;
+                }
+            }
+            else
+            {
+                rslt = BMM350_E_COM_FAIL;
+            }
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            dev->bus_lock_depth++;
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API releases the bus acquired with bmm350_bus_acquire.
+ */
+int8_t bmm350_bus_release(struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    /* Check for null pointer in the device structure */
+    rslt = null_ptr_check(dev);
+
+    if (rslt == BMM350_OK)
+    {
+        if (dev->bus_lock_depth > 0)
+        {
+            dev->bus_lock_depth--;
+
+            if ((dev->bus_unlock != NULL) && (dev->bus_lock_depth == 0))
+            {
+                if (dev->bus_unlock(dev->intf_ptr) != BMM350_INTF_RET_SUCCESS)
+                {
+                    rslt = BMM350_E_COM_FAIL;
+                }
+            }
+        }
+        else
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+    }
+
+    return rslt;
+}
+
 /*!
  * @brief This function provides the delay for required time (Microsecond) as per the input provided in some of the
  * APIs.
@@ -370,8 +592,6 @@ int8_t bmm350_soft_reset(struct bmm350_dev *dev)
     /* Variable to store the function result */
     int8_t rslt;
 
-    uint8_t reg_data;
-
     /* Variable to store the command to power-off the OTP */
     uint8_t otp_cmd = BMM350_OTP_CMD_PWR_OFF_OTP;
 
@@ -380,24 +600,16 @@ int8_t bmm350_soft_reset(struct bmm350_dev *dev)
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_CMD_SOFTRESET;
-
-        /* Set the command in the command register */
-        rslt = bmm350_set_regs(BMM350_REG_CMD, &reg_data, 1, dev);
+        rslt = soft_reset_cmd(dev);
 
         if (rslt == BMM350_OK)
         {
-            rslt = bmm350_delay_us(BMM350_SOFT_RESET_DELAY, dev);
+            /* Power off OTP */
+            rslt = bmm350_set_regs(BMM350_REG_OTP_CMD_REG, &otp_cmd, 1, dev);
 
             if (rslt == BMM350_OK)
             {
-                /* Power off OTP */
-                rslt = bmm350_set_regs(BMM350_REG_OTP_CMD_REG, &otp_cmd, 1, dev);
-
-                if (rslt == BMM350_OK)
-                {
-                    rslt = bmm350_magnetic_reset_and_wait(dev);
-                }
+                rslt = bmm350_magnetic_reset_and_wait(dev);
             }
         }
     }
@@ -427,6 +639,11 @@ int8_t bmm350_read_sensortime(uint32_t *seconds, uint32_t *nanoseconds, struct b
         {
             time = (uint32_t)(reg_data[0] + ((uint32_t)reg_data[1] << 8) + ((uint32_t)reg_data[2] << 16));
 
+            if (dev->event_log != NULL)
+            {
+                dev->event_log->sensortime = (uint32_t)time;
+            }
+
             /* 1 LSB is 39.0625us. Converting to nanoseconds */
             time *= UINT64_C(390625);
             time /= UINT64_C(10);
@@ -442,6 +659,59 @@ int8_t bmm350_read_sensortime(uint32_t *seconds, uint32_t *nanoseconds, struct b
     return rslt;
 }
 
+/*!
+ * @brief This API is used to extend the 24-bit sensortime of a sample to a 64-bit timeline.
+ */
+int8_t bmm350_extend_sensortime(uint32_t sensortime,
+                                uint32_t period_ticks,
+                                uint32_t *missed,
+                                struct bmm350_timeline *timeline)
+{
+    /* Variable to store the function result */
+    int8_t rslt = BMM350_OK;
+
+    uint32_t delta, gap = 0;
+
+    if (timeline != NULL)
+    {
+        if (timeline->started)
+        {
+            if (sensortime < timeline->last_sensortime)
+            {
+                timeline->wrap_count++;
+            }
+
+            /* Unsigned modulo difference handles a single wrap of the 24-bit counter */
+            delta = (sensortime - timeline->last_sensortime) & BMM350_SENSORTIME_MASK;
+            timeline->ticks += delta;
+
+            if ((period_ticks > 0) && ((2 * delta) > (3 * period_ticks)))
+            {
+                gap = (delta + period_ticks / 2) / period_ticks - 1;
+            }
+        }
+        else
+        {
+            timeline->ticks = sensortime;
+            timeline->wrap_count = 0;
+            timeline->started = 1;
+        }
+
+        timeline->last_sensortime = sensortime;
+
+        if (missed != NULL)
+        {
+            *missed = gap;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
 /*!
  * @brief This API is used to get the status flags of all interrupt
  * which is used to check for the assertion of interrupts
@@ -498,7 +768,8 @@ int8_t bmm350_set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev
             }
 
             if ((rslt == BMM350_OK) &&
-                ((last_pwr_mode == BMM350_PMU_CMD_NM) || (last_pwr_mode == BMM350_PMU_CMD_UPD_OAE)))
+                ((last_pwr_mode == BMM350_PMU_CMD_NM) || (last_pwr_mode == BMM350_PMU_CMD_UPD_OAE) ||
+                 (last_pwr_mode == BMM350_PMU_CMD_NM_TC)))
             {
                 reg_data = BMM350_PMU_CMD_SUS;
 
@@ -513,9 +784,55 @@ int8_t bmm350_set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev
 
             if (rslt == BMM350_OK)
             {
-                rslt = set_powermode(powermode, dev);
+                if ((powermode != BMM350_FORCED_MODE) && (powermode != BMM350_FORCED_MODE_FAST) &&
+                    (dev->seq_override.power_transition != NULL))
+                {
+                    rslt = dev->seq_override.power_transition(powermode, dev);
+                }
+                else
+                {
+                    rslt = set_powermode(powermode, dev);
+                }
             }
         }
+
+        /* Forced mode triggers are measurements, not reconfigurations */
+        if ((powermode != BMM350_FORCED_MODE) && (powermode != BMM350_FORCED_MODE_FAST))
+        {
+            log_event(BMM350_EVENT_CONFIG, rslt, (uint16_t)(BMM350_REG_PMU_CMD | ((uint16_t)powermode << 8)), dev);
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API triggers one forced mode conversion without waiting for it.
+ */
+int8_t bmm350_trigger_forced(enum bmm350_power_modes powermode, struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    uint8_t reg_data = (uint8_t)powermode;
+
+    /* Check for null pointer in the device structure */
+    rslt = null_ptr_check(dev);
+
+    if (rslt == BMM350_OK)
+    {
+        if ((powermode != BMM350_FORCED_MODE) && (powermode != BMM350_FORCED_MODE_FAST))
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else if (dev->seq_override.forced_trigger != NULL)
+        {
+            rslt = dev->seq_override.forced_trigger(powermode, dev);
+        }
+        else
+        {
+            rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &reg_data, 1, dev);
+        }
     }
 
     return rslt;
@@ -534,7 +851,10 @@ int8_t bmm350_set_odr_performance(enum bmm350_data_rates odr,
     /* Variable to get PMU command */
     uint8_t reg_data = 0;
 
-    enum bmm350_performance_parameters performance_fix = performance;
+    /* Variable to store the ODR and averaging written, for the event log */
+    uint8_t aggr_set = 0;
+
+    enum bmm350_performance_parameters performance_fix;
 
     /* Check for null pointer in the device structure */
     rslt = null_ptr_check(dev);
@@ -542,24 +862,14 @@ int8_t bmm350_set_odr_performance(enum bmm350_data_rates odr,
     if (rslt == BMM350_OK)
     {
         /* Reduce the performance setting when too high for the chosen ODR */
-        if ((odr == BMM350_DATA_RATE_400HZ) && (performance >= BMM350_AVERAGING_2))
-        {
-            performance_fix = BMM350_NO_AVERAGING;
-        }
-        else if ((odr == BMM350_DATA_RATE_200HZ) && (performance >= BMM350_AVERAGING_4))
-        {
-            performance_fix = BMM350_AVERAGING_2;
-        }
-        else if ((odr == BMM350_DATA_RATE_100HZ) && (performance >= BMM350_AVERAGING_8))
-        {
-            performance_fix = BMM350_AVERAGING_4;
-        }
+        performance_fix = bmm350_cap_averaging(odr, performance);
 
         /* ODR is an enum taking the generated constants from the register map */
         reg_data = ((uint8_t)odr & BMM350_ODR_MSK);
 
         /* AVG / performance is an enum taking the generated constants from the register map */
         reg_data = BMM350_SET_BITS(reg_data, BMM350_AVG, (uint8_t)performance_fix);
+        aggr_set = reg_data;
 
         /* Set PMU command configurations for ODR and performance */
         rslt = bmm350_set_regs(BMM350_REG_PMU_CMD_AGGR_SET, &reg_data, 1, dev);
@@ -577,25 +887,51 @@ int8_t bmm350_set_odr_performance(enum bmm350_data_rates odr,
                 rslt = bmm350_delay_us(BMM350_UPD_OAE_DELAY, dev);
             }
         }
+
+        log_event(BMM350_EVENT_CONFIG, rslt, (uint16_t)(BMM350_REG_PMU_CMD_AGGR_SET | ((uint16_t)aggr_set << 8)), dev);
     }
 
     return rslt;
 }
 
 /*!
- * @brief This API is used to enable or disable the magnetic
- * measurement of x,y,z axes
+ * @brief This API returns the averaging used at an ODR.
  */
-int8_t bmm350_enable_axes(enum bmm350_x_axis_en_dis en_x,
-                          enum bmm350_y_axis_en_dis en_y,
-                          enum bmm350_z_axis_en_dis en_z,
-                          struct bmm350_dev *dev)
+enum bmm350_performance_parameters bmm350_cap_averaging(enum bmm350_data_rates odr,
+                                                        enum bmm350_performance_parameters avg)
 {
-    /* Variable to store the function result */
-    int8_t rslt;
+    enum bmm350_performance_parameters avg_fix = avg;
 
-    /* Variable to store axis data */
-    uint8_t data;
+    if ((odr == BMM350_DATA_RATE_400HZ) && (avg >= BMM350_AVERAGING_2))
+    {
+        avg_fix = BMM350_NO_AVERAGING;
+    }
+    else if ((odr == BMM350_DATA_RATE_200HZ) && (avg >= BMM350_AVERAGING_4))
+    {
+        avg_fix = BMM350_AVERAGING_2;
+    }
+    else if ((odr == BMM350_DATA_RATE_100HZ) && (avg >= BMM350_AVERAGING_8))
+    {
+        avg_fix = BMM350_AVERAGING_4;
+    }
+
+    return avg_fix;
+}
+
+/*!
+ * @brief This API is used to enable or disable the magnetic
+ * measurement of x,y,z axes
+ */
+int8_t bmm350_enable_axes(enum bmm350_x_axis_en_dis en_x,
+                          enum bmm350_y_axis_en_dis en_y,
+                          enum bmm350_z_axis_en_dis en_z,
+                          struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    /* Variable to store axis data */
+    uint8_t data;
 
     /* Check for null pointer in the device structure */
     rslt = null_ptr_check(dev);
@@ -622,6 +958,8 @@ int8_t bmm350_enable_axes(enum bmm350_x_axis_en_dis en_x,
                 /* Assign axis_en with the axis selection done */
                 dev->axis_en = data;
             }
+
+            log_event(BMM350_EVENT_CONFIG, rslt, (uint16_t)(BMM350_REG_PMU_CMD_AXIS_EN | ((uint16_t)data << 8)), dev);
         }
     }
 
@@ -639,15 +977,23 @@ int8_t bmm350_enable_interrupt(enum bmm350_interrupt_enable_disable enable_disab
     /* Variable to store the function result */
     int8_t rslt;
 
-    /* Get interrupt control configuration */
-    rslt = bmm350_get_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_DRDY_DATA_REG_EN, (uint8_t)enable_disable);
+        /* Get interrupt control configuration */
+        rslt = bmm350_get_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
 
-        /* Finally transfer the interrupt configurations */
-        rslt = bmm350_set_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+        if (rslt == BMM350_OK)
+        {
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_DRDY_DATA_REG_EN, (uint8_t)enable_disable);
+
+            /* Finally transfer the interrupt configurations */
+            rslt = bmm350_set_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+        }
+
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -668,18 +1014,26 @@ int8_t bmm350_configure_interrupt(enum bmm350_intr_latch latching,
     /* Variable to store the function result */
     int8_t rslt;
 
-    /* Get interrupt control configuration */
-    rslt = bmm350_get_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_INT_MODE, latching);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_POL, polarity);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_OD, drivertype);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_OUTPUT_EN, map_nomap);
+        /* Get interrupt control configuration */
+        rslt = bmm350_get_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_INT_MODE, latching);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_POL, polarity);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_OD, drivertype);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_INT_OUTPUT_EN, map_nomap);
 
-        /* Finally transfer the interrupt configurations */
-        rslt = bmm350_set_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+            /* Finally transfer the interrupt configurations */
+            rslt = bmm350_set_regs(BMM350_REG_INT_CTRL, &reg_data, 1, dev);
+        }
+
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -693,9 +1047,7 @@ int8_t bmm350_read_uncomp_mag_temp_data(struct bmm350_raw_mag_data *raw_data, st
     /* Variable to store the function result */
     int8_t rslt;
 
-    uint8_t mag_data[12] = { 0 };
-
-    uint32_t raw_mag_x, raw_mag_y, raw_mag_z, raw_temp;
+    uint8_t mag_data[BMM350_MAG_TEMP_DATA_LEN] = { 0 };
 
     if (raw_data != NULL)
     {
@@ -704,39 +1056,7 @@ int8_t bmm350_read_uncomp_mag_temp_data(struct bmm350_raw_mag_data *raw_data, st
 
         if (rslt == BMM350_OK)
         {
-            raw_mag_x = mag_data[0] + ((uint32_t)mag_data[1] << 8) + ((uint32_t)mag_data[2] << 16);
-            raw_mag_y = mag_data[3] + ((uint32_t)mag_data[4] << 8) + ((uint32_t)mag_data[5] << 16);
-            raw_mag_z = mag_data[6] + ((uint32_t)mag_data[7] << 8) + ((uint32_t)mag_data[8] << 16);
-            raw_temp = mag_data[9] + ((uint32_t)mag_data[10] << 8) + ((uint32_t)mag_data[11] << 16);
-
-            if ((dev->axis_en & BMM350_EN_X_MSK) == BMM350_DISABLE)
-            {
-                raw_data->raw_xdata = BMM350_DISABLE;
-            }
-            else
-            {
-                raw_data->raw_xdata = fix_sign(raw_mag_x, BMM350_SIGNED_24_BIT);
-            }
-
-            if ((dev->axis_en & BMM350_EN_Y_MSK) == BMM350_DISABLE)
-            {
-                raw_data->raw_ydata = BMM350_DISABLE;
-            }
-            else
-            {
-                raw_data->raw_ydata = fix_sign(raw_mag_y, BMM350_SIGNED_24_BIT);
-            }
-
-            if ((dev->axis_en & BMM350_EN_Z_MSK) == BMM350_DISABLE)
-            {
-                raw_data->raw_zdata = BMM350_DISABLE;
-            }
-            else
-            {
-                raw_data->raw_zdata = fix_sign(raw_mag_z, BMM350_SIGNED_24_BIT);
-            }
-
-            raw_data->raw_data_t = fix_sign(raw_temp, BMM350_SIGNED_24_BIT);
+            parse_raw_mag_temp_data(mag_data, raw_data, dev);
         }
     }
     else
@@ -760,22 +1080,30 @@ int8_t bmm350_set_int_ctrl_ibi(enum bmm350_drdy_int_map_to_ibi en_dis,
     /* Variable to get interrupt control configuration */
     uint8_t reg_data = 0;
 
-    /* Get interrupt control configuration */
-    rslt = bmm350_get_regs(BMM350_REG_INT_CTRL_IBI, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_DRDY_INT_MAP_TO_IBI, en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_CLEAR_DRDY_INT_STATUS_UPON_IBI, clear_on_ibi);
-
-        /* Set the IBI control configuration */
-        rslt = bmm350_set_regs(BMM350_REG_INT_CTRL_IBI, &reg_data, 1, dev);
+        /* Get interrupt control configuration */
+        rslt = bmm350_get_regs(BMM350_REG_INT_CTRL_IBI, &reg_data, 1, dev);
 
-        if (en_dis == BMM350_IBI_ENABLE)
+        if (rslt == BMM350_OK)
         {
-            /* Enable data ready interrupt if IBI is enabled */
-            rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, dev);
+            reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_DRDY_INT_MAP_TO_IBI, en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_CLEAR_DRDY_INT_STATUS_UPON_IBI, clear_on_ibi);
+
+            /* Set the IBI control configuration */
+            rslt = bmm350_set_regs(BMM350_REG_INT_CTRL_IBI, &reg_data, 1, dev);
+
+            if (en_dis == BMM350_IBI_ENABLE)
+            {
+                /* Enable data ready interrupt if IBI is enabled */
+                rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, dev);
+            }
         }
+
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -808,21 +1136,75 @@ int8_t bmm350_set_pad_drive(uint8_t drive, struct bmm350_dev *dev)
  * It sends flux guide or bit reset to the device in suspend mode.
  */
 int8_t bmm350_magnetic_reset_and_wait(struct bmm350_dev *dev)
+{
+    return bmm350_magnetic_reset(BMM350_FLUXGUIDE_9MS, dev);
+}
+
+/*!
+ * @brief This API is used to perform the selected magnetic reset variant.
+ */
+int8_t bmm350_magnetic_reset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev)
 {
     /* Variable to store the function result */
     int8_t rslt;
 
-    uint8_t pmu_cmd = 0;
     struct bmm350_pmu_cmd_status_0 pmu_cmd_stat_0 = { 0 };
     uint8_t restore_normal = BMM350_DISABLE;
+    uint8_t last_pwr_mode = BMM350_PMU_CMD_NM;
+
+    /* Bit reset and flux guide reset steps of the selected variant */
+    uint8_t br_cmd = BMM350_PMU_CMD_BR, fgr_cmd = BMM350_PMU_CMD_FGR;
+    uint8_t br_status = BMM350_PMU_CMD_STATUS_0_BR, fgr_status = BMM350_PMU_CMD_STATUS_0_FGR;
+    uint32_t br_delay = BMM350_BR_DELAY, fgr_delay = BMM350_FGR_DELAY;
+    uint8_t do_br = BMM350_ENABLE, do_fgr = BMM350_ENABLE;
 
     rslt = null_ptr_check(dev);
 
-    if ((rslt == BMM350_OK) && (dev->mraw_override) && (dev->var_id >= BMM350_MIN_VAR))
+    switch (reset_type)
+    {
+        case BMM350_FLUXGUIDE_9MS:
+            break;
+
+        case BMM350_FLUXGUIDE_FAST:
+            br_cmd = BMM350_PMU_CMD_BR_FAST;
+            br_status = BMM350_PMU_CMD_STATUS_0_BR_FAST;
+            br_delay = BMM350_BR_FAST_DELAY;
+            fgr_cmd = BMM350_PMU_CMD_FGR_FAST;
+            fgr_status = BMM350_PMU_CMD_STATUS_0_FGR_FAST;
+            fgr_delay = BMM350_FGR_FAST_DELAY;
+            break;
+
+        case BMM350_BITRESET_9MS:
+            do_fgr = BMM350_DISABLE;
+            break;
+
+        case BMM350_BITRESET_FAST:
+            br_cmd = BMM350_PMU_CMD_BR_FAST;
+            br_status = BMM350_PMU_CMD_STATUS_0_BR_FAST;
+            br_delay = BMM350_BR_FAST_DELAY;
+            do_fgr = BMM350_DISABLE;
+            break;
+
+        case BMM350_NOMAGRESET:
+            do_br = BMM350_DISABLE;
+            do_fgr = BMM350_DISABLE;
+            break;
+
+        default:
+            if (rslt == BMM350_OK)
+            {
+                rslt = BMM350_E_INVALID_INPUT;
+            }
+
+            break;
+    }
+
+    if ((rslt == BMM350_OK) && (reset_type == BMM350_FLUXGUIDE_9MS) && (dev->mraw_override) &&
+        (dev->var_id >= BMM350_MIN_VAR))
     {
         rslt = dev->mraw_override(dev);
     }
-    else
+    else if ((rslt == BMM350_OK) && (do_br == BMM350_ENABLE))
     {
         /* Read PMU CMD status */
         rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
@@ -832,61 +1214,38 @@ int8_t bmm350_magnetic_reset_and_wait(struct bmm350_dev *dev)
         {
             restore_normal = BMM350_ENABLE;
 
-            /* Reset can only be triggered in suspend */
-            rslt = bmm350_set_powermode(BMM350_SUSPEND_MODE, dev);
-        }
-
-        if (rslt == BMM350_OK)
-        {
-            /* Set BR to PMU_CMD register */
-            pmu_cmd = BMM350_PMU_CMD_BR;
-
-            rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &pmu_cmd, 1, dev);
+            /* Remember whether normal mode was entered with or without TC */
+            rslt = bmm350_get_regs(BMM350_REG_PMU_CMD, &last_pwr_mode, 1, dev);
 
             if (rslt == BMM350_OK)
             {
-                rslt = bmm350_delay_us(BMM350_BR_DELAY, dev);
+                /* Reset can only be triggered in suspend */
+                rslt = bmm350_set_powermode(BMM350_SUSPEND_MODE, dev);
             }
         }
 
         if (rslt == BMM350_OK)
         {
-            /* Verify if PMU_CMD_STATUS_0 register has BR set */
-            rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
-
-            if ((rslt == BMM350_OK) && (pmu_cmd_stat_0.pmu_cmd_value != BMM350_PMU_CMD_STATUS_0_BR))
-            {
-                rslt = BMM350_E_PMU_CMD_VALUE;
-            }
+            /* Set BR to PMU_CMD register and verify it in PMU_CMD_STATUS_0 */
+            rslt = magnetic_reset_cmd(br_cmd, br_delay, br_status, dev);
         }
 
-        if (rslt == BMM350_OK)
+        if ((rslt == BMM350_OK) && (do_fgr == BMM350_ENABLE))
         {
-            /* Set FGR to PMU_CMD register */
-            pmu_cmd = BMM350_PMU_CMD_FGR;
-
-            rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &pmu_cmd, 1, dev);
-
-            if (rslt == BMM350_OK)
-            {
-                rslt = bmm350_delay_us(BMM350_FGR_DELAY, dev);
-            }
+            /* Set FGR to PMU_CMD register and verify it in PMU_CMD_STATUS_0 */
+            rslt = magnetic_reset_cmd(fgr_cmd, fgr_delay, fgr_status, dev);
         }
 
-        if (rslt == BMM350_OK)
+        if ((rslt == BMM350_OK) && (restore_normal == BMM350_ENABLE))
         {
-            /* Verify if PMU_CMD_STATUS_0 register has FGR set */
-            rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
-
-            if ((rslt == BMM350_OK) && (pmu_cmd_stat_0.pmu_cmd_value != BMM350_PMU_CMD_STATUS_0_FGR))
+            if (last_pwr_mode == BMM350_PMU_CMD_NM_TC)
             {
-                rslt = BMM350_E_PMU_CMD_VALUE;
+                rslt = bmm350_set_powermode(BMM350_NORMAL_MODE_TC, dev);
+            }
+            else
+            {
+                rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, dev);
             }
-        }
-
-        if ((rslt == BMM350_OK) && (restore_normal == BMM350_ENABLE))
-        {
-            rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, dev);
         }
     }
 
@@ -901,10 +1260,7 @@ int8_t bmm350_get_compensated_mag_xyz_temp_data(struct bmm350_mag_temp_data *mag
     /* Variable to store the function result */
     int8_t rslt;
 
-    uint8_t indx;
     float out_data[4] = { 0.0f };
-    float dut_offset_coef[3], dut_sensit_coef[3], dut_tco[3], dut_tcs[3];
-    float cr_ax_comp_x, cr_ax_comp_y, cr_ax_comp_z;
 
     if (mag_temp_data != NULL)
     {
@@ -913,84 +1269,130 @@ int8_t bmm350_get_compensated_mag_xyz_temp_data(struct bmm350_mag_temp_data *mag
 
         if (rslt == BMM350_OK)
         {
-            /* Apply compensation to temperature reading */
-            out_data[3] = (1 + dev->mag_comp.dut_sensit_coef.t_sens) * out_data[3] +
-                          dev->mag_comp.dut_offset_coef.t_offs;
+            compensate_data(out_data, mag_temp_data, dev);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API reads mag, temperature and sensortime in one burst and compensates the mag and
+ * temperature data.
+ */
+int8_t bmm350_get_compensated_mag_xyz_temp_sensortime(struct bmm350_mag_temp_data *mag_temp_data,
+                                                      uint32_t *sensortime,
+                                                      struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
 
-            /* Store magnetic compensation structure to an array */
-            dut_offset_coef[0] = dev->mag_comp.dut_offset_coef.offset_x;
-            dut_offset_coef[1] = dev->mag_comp.dut_offset_coef.offset_y;
-            dut_offset_coef[2] = dev->mag_comp.dut_offset_coef.offset_z;
+    uint8_t reg_data[BMM350_MAG_TEMP_SENSORTIME_DATA_LEN] = { 0 };
+    float out_data[4] = { 0.0f };
+    struct bmm350_raw_mag_data raw_data = { 0 };
 
-            dut_sensit_coef[0] = dev->mag_comp.dut_sensit_coef.sens_x;
-            dut_sensit_coef[1] = dev->mag_comp.dut_sensit_coef.sens_y;
-            dut_sensit_coef[2] = dev->mag_comp.dut_sensit_coef.sens_z;
+    if ((mag_temp_data != NULL) && (sensortime != NULL))
+    {
+        /* Sensortime registers directly follow the temperature registers */
+        rslt = bmm350_get_regs(BMM350_REG_MAG_X_XLSB, reg_data, BMM350_MAG_TEMP_SENSORTIME_DATA_LEN, dev);
 
-            dut_tco[0] = dev->mag_comp.dut_tco.tco_x;
-            dut_tco[1] = dev->mag_comp.dut_tco.tco_y;
-            dut_tco[2] = dev->mag_comp.dut_tco.tco_z;
+        if (rslt == BMM350_OK)
+        {
+            parse_raw_mag_temp_data(reg_data, &raw_data, dev);
 
-            dut_tcs[0] = dev->mag_comp.dut_tcs.tcs_x;
-            dut_tcs[1] = dev->mag_comp.dut_tcs.tcs_y;
-            dut_tcs[2] = dev->mag_comp.dut_tcs.tcs_z;
+            *sensortime = (uint32_t)(reg_data[12] + ((uint32_t)reg_data[13] << 8) + ((uint32_t)reg_data[14] << 16));
 
-            /* Compensate raw magnetic data */
-            for (indx = 0; indx < 3; indx++)
+            if (dev->event_log != NULL)
             {
-                out_data[indx] *= 1 + dut_sensit_coef[indx];
-                out_data[indx] += dut_offset_coef[indx];
-                out_data[indx] += dut_tco[indx] * (out_data[3] - dev->mag_comp.dut_t0);
-                out_data[indx] /= 1 + dut_tcs[indx] * (out_data[3] - dev->mag_comp.dut_t0);
+                dev->event_log->sensortime = *sensortime;
             }
 
-            cr_ax_comp_x = (out_data[0] - dev->mag_comp.cross_axis.cross_x_y * out_data[1]) /
-                           (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y);
-            cr_ax_comp_y = (out_data[1] - dev->mag_comp.cross_axis.cross_y_x * out_data[0]) /
-                           (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y);
-            cr_ax_comp_z =
-                (out_data[2] +
-                 (out_data[0] *
-                  (dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_z_y -
-                   dev->mag_comp.cross_axis.cross_z_x) - out_data[1] *
-                  (dev->mag_comp.cross_axis.cross_z_y - dev->mag_comp.cross_axis.cross_x_y *
-                   dev->mag_comp.cross_axis.cross_z_x)) /
-                 (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y));
+            convert_raw_data(&raw_data, 1, out_data);
+            compensate_data(out_data, mag_temp_data, dev);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to compensate raw mag and temperature data, or the sum of several raw samples.
+ */
+int8_t bmm350_compensate_raw_mag_temp_data(const struct bmm350_raw_mag_data *raw_data,
+                                           uint16_t count,
+                                           struct bmm350_mag_temp_data *mag_temp_data,
+                                           const struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    float out_data[4] = { 0.0f };
 
-            out_data[0] = cr_ax_comp_x;
-            out_data[1] = cr_ax_comp_y;
-            out_data[2] = cr_ax_comp_z;
+    /* No bus access: the interface pointers are not needed, e.g. to compensate logged raw data */
+    if ((raw_data != NULL) && (mag_temp_data != NULL) && (dev != NULL))
+    {
+        if (count > 0)
+        {
+            convert_raw_data(raw_data, count, out_data);
+            compensate_data(out_data, mag_temp_data, dev);
+            rslt = BMM350_OK;
+        }
+        else
+        {
+            rslt = BMM350_E_INVALID_INPUT;
         }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to read the interrupt status, mag, temperature and sensortime in one burst.
+ */
+int8_t bmm350_get_status_compensated_mag_xyz_temp_sensortime(uint8_t *drdy_status,
+                                                             struct bmm350_mag_temp_data *mag_temp_data,
+                                                             uint32_t *sensortime,
+                                                             struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    uint8_t reg_data[BMM350_STATUS_MAG_TEMP_SENSORTIME_DATA_LEN] = { 0 };
+    float out_data[4] = { 0.0f };
+    struct bmm350_raw_mag_data raw_data = { 0 };
+
+    if ((drdy_status != NULL) && (mag_temp_data != NULL) && (sensortime != NULL))
+    {
+        /* Data registers directly follow the interrupt status register */
+        rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, reg_data, BMM350_STATUS_MAG_TEMP_SENSORTIME_DATA_LEN, dev);
 
         if (rslt == BMM350_OK)
         {
-            if ((dev->axis_en & BMM350_EN_X_MSK) == BMM350_DISABLE)
-            {
-                mag_temp_data->x = BMM350_DISABLE;
-            }
-            else
-            {
-                mag_temp_data->x = out_data[0];
-            }
+            (*drdy_status) = BMM350_GET_BITS(reg_data[0], BMM350_DRDY_DATA_REG);
 
-            if ((dev->axis_en & BMM350_EN_Y_MSK) == BMM350_DISABLE)
-            {
-                mag_temp_data->y = BMM350_DISABLE;
-            }
-            else
-            {
-                mag_temp_data->y = out_data[1];
-            }
+            parse_raw_mag_temp_data(&reg_data[1], &raw_data, dev);
 
-            if ((dev->axis_en & BMM350_EN_Z_MSK) == BMM350_DISABLE)
-            {
-                mag_temp_data->z = BMM350_DISABLE;
-            }
-            else
+            *sensortime = (uint32_t)(reg_data[13] + ((uint32_t)reg_data[14] << 8) + ((uint32_t)reg_data[15] << 16));
+
+            if (dev->event_log != NULL)
             {
-                mag_temp_data->z = out_data[2];
+                dev->event_log->sensortime = *sensortime;
             }
 
-            mag_temp_data->temperature = out_data[3];
+            convert_raw_data(&raw_data, 1, out_data);
+            compensate_data(out_data, mag_temp_data, dev);
         }
     }
     else
@@ -1019,7 +1421,14 @@ int8_t bmm350_perform_self_test(struct bmm350_self_test *out_data, struct bmm350
         if (rslt == BMM350_OK)
         {
             /* Self-test entry configuration */
-            rslt = self_test_entry_config(dev);
+            if (dev->seq_override.self_test_entry != NULL)
+            {
+                rslt = dev->seq_override.self_test_entry(dev);
+            }
+            else
+            {
+                rslt = self_test_entry_config(dev);
+            }
 
             if (rslt == BMM350_OK)
             {
@@ -1047,6 +1456,10 @@ int8_t bmm350_perform_self_test(struct bmm350_self_test *out_data, struct bmm350
             {
                 rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, dev);
             }
+            else if (last_pwr_mode == BMM350_PMU_CMD_NM_TC)
+            {
+                rslt = bmm350_set_powermode(BMM350_NORMAL_MODE_TC, dev);
+            }
         }
     }
     else
@@ -1069,16 +1482,24 @@ int8_t bmm350_set_i2c_wdt(enum bmm350_i2c_wdt_en i2c_wdt_en_dis,
 
     uint8_t reg_data;
 
-    /* Get I2C WDT configuration */
-    rslt = bmm350_get_regs(BMM350_REG_I2C_WDT_SET, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_I2C_WDT_EN, i2c_wdt_en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_I2C_WDT_SEL, i2c_wdt_sel);
+        /* Get I2C WDT configuration */
+        rslt = bmm350_get_regs(BMM350_REG_I2C_WDT_SET, &reg_data, 1, dev);
 
-        /* Set I2C WDT configuration */
-        rslt = bmm350_set_regs(BMM350_REG_I2C_WDT_SET, &reg_data, 1, dev);
+        if (rslt == BMM350_OK)
+        {
+            reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_I2C_WDT_EN, i2c_wdt_en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_I2C_WDT_SEL, i2c_wdt_sel);
+
+            /* Set I2C WDT configuration */
+            rslt = bmm350_set_regs(BMM350_REG_I2C_WDT_SET, &reg_data, 1, dev);
+        }
+
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -1099,19 +1520,27 @@ int8_t bmm350_set_tmr_selftest_user(enum bmm350_st_igen_en st_igen_en_dis,
 
     uint8_t reg_data;
 
-    /* Get TMR self-test user configuration */
-    rslt = bmm350_get_regs(BMM350_REG_TMR_SELFTEST_USER, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_ST_IGEN_EN, st_igen_en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_ST_N, st_n_en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_ST_P, st_p_en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_IST_EN_X, ist_x_en_dis);
-        reg_data = BMM350_SET_BITS(reg_data, BMM350_IST_EN_Y, ist_y_en_dis);
+        /* Get TMR self-test user configuration */
+        rslt = bmm350_get_regs(BMM350_REG_TMR_SELFTEST_USER, &reg_data, 1, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_ST_IGEN_EN, st_igen_en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_ST_N, st_n_en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_ST_P, st_p_en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_IST_EN_X, ist_x_en_dis);
+            reg_data = BMM350_SET_BITS(reg_data, BMM350_IST_EN_Y, ist_y_en_dis);
+
+            /* Set TMR self-test user configuration */
+            rslt = bmm350_set_regs(BMM350_REG_TMR_SELFTEST_USER, &reg_data, 1, dev);
+        }
 
-        /* Set TMR self-test user configuration */
-        rslt = bmm350_set_regs(BMM350_REG_TMR_SELFTEST_USER, &reg_data, 1, dev);
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -1128,15 +1557,23 @@ int8_t bmm350_set_ctrl_user(enum bmm350_ctrl_user cfg_sens_tim_aon_en_dis, struc
 
     uint8_t reg_data;
 
-    /* Get control user configuration */
-    rslt = bmm350_get_regs(BMM350_REG_CTRL_USER, &reg_data, 1, dev);
+    /* Hold the bus across the read-modify-write */
+    rslt = bmm350_bus_acquire(dev);
 
     if (rslt == BMM350_OK)
     {
-        reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_CFG_SENS_TIM_AON, cfg_sens_tim_aon_en_dis);
+        /* Get control user configuration */
+        rslt = bmm350_get_regs(BMM350_REG_CTRL_USER, &reg_data, 1, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            reg_data = BMM350_SET_BITS_POS_0(reg_data, BMM350_CFG_SENS_TIM_AON, cfg_sens_tim_aon_en_dis);
 
-        /* Set control user configuration */
-        rslt = bmm350_set_regs(BMM350_REG_CTRL_USER, &reg_data, 1, dev);
+            /* Set control user configuration */
+            rslt = bmm350_set_regs(BMM350_REG_CTRL_USER, &reg_data, 1, dev);
+        }
+
+        rslt = release_bus(rslt, dev);
     }
 
     return rslt;
@@ -1170,6 +1607,12 @@ int8_t bmm350_get_pmu_cmd_status_0(struct bmm350_pmu_cmd_status_0 *pmu_cmd_stat_
             pmu_cmd_stat_0->cmd_is_illegal = BMM350_GET_BITS(reg_data, BMM350_CMD_IS_ILLEGAL);
 
             pmu_cmd_stat_0->pmu_cmd_value = BMM350_GET_BITS(reg_data, BMM350_PMU_CMD_VALUE);
+
+            if ((pmu_cmd_stat_0->cmd_is_illegal == BMM350_ENABLE) || (pmu_cmd_stat_0->odr_ovwr == BMM350_ENABLE) ||
+                (pmu_cmd_stat_0->avr_ovwr == BMM350_ENABLE))
+            {
+                log_event(BMM350_EVENT_PMU_STATUS, rslt, pmu_status_arg(pmu_cmd_stat_0), dev);
+            }
         }
     }
     else
@@ -1180,41 +1623,304 @@ int8_t bmm350_get_pmu_cmd_status_0(struct bmm350_pmu_cmd_status_0 *pmu_cmd_stat_
     return rslt;
 }
 
-/****************************************************************************/
-/**\name     INTERNAL APIs                                                  */
-
 /*!
- * @brief This internal API is used to validate the device structure pointer for
- * null conditions.
+ * @brief This API reads all documented user registers in one burst per range and decodes them.
  */
-static int8_t null_ptr_check(const struct bmm350_dev *dev)
+int8_t bmm350_get_reg_snapshot(struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev)
 {
     /* Variable to store the function result */
     int8_t rslt;
 
-    if ((dev == NULL) || (dev->read == NULL) || (dev->write == NULL) || (dev->delay_us == NULL))
+    /* Documented register ranges; the gaps between them are longer than the overhead of a burst */
+    const uint8_t burst_start[BMM350_SNAPSHOT_READ_BURSTS] = {
+        BMM350_REG_CHIP_ID, BMM350_REG_TC_SYNC_TU, BMM350_REG_OTP_CMD_REG, BMM350_REG_TMR_SELFTEST_USER
+    };
+    const uint8_t burst_end[BMM350_SNAPSHOT_READ_BURSTS] = {
+        BMM350_REG_TRSDCR_REV_ID, BMM350_REG_SENSORTIME_MSB, BMM350_REG_OTP_STATUS_REG, BMM350_REG_CTRL_USER
+    };
+
+    uint8_t index;
+
+    /* Check for null pointer in the device structure */
+    rslt = null_ptr_check(dev);
+
+    if ((rslt == BMM350_OK) && (snapshot != NULL))
     {
-        /* Device structure pointer is not valid */
-        rslt = BMM350_E_NULL_PTR;
+        for (index = 0; index < BMM350_SNAPSHOT_REG_LEN; index++)
+        {
+            snapshot->regs[index] = 0;
+        }
+
+        /* Hold the bus so that the snapshot is not interleaved with other bus users */
+        rslt = bmm350_bus_acquire(dev);
+
+        if (rslt == BMM350_OK)
+        {
+            for (index = 0; (index < BMM350_SNAPSHOT_READ_BURSTS) && (rslt == BMM350_OK); index++)
+            {
+                rslt = bmm350_get_regs(burst_start[index],
+                                       &snapshot->regs[burst_start[index]],
+                                       (uint16_t)(burst_end[index] - burst_start[index] + 1),
+                                       dev);
+            }
+
+            rslt = release_bus(rslt, dev);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            decode_reg_snapshot(snapshot);
+        }
     }
-    else
+    else if (rslt == BMM350_OK)
     {
-        /* Device structure is fine */
-        rslt = BMM350_OK;
+        rslt = BMM350_E_NULL_PTR;
     }
 
     return rslt;
 }
 
 /*!
- *  @brief This internal API converts the raw data from the IC data registers to signed integer
+ * @brief This API writes back the writable configuration of a register snapshot.
  */
-static int32_t fix_sign(uint32_t inval, int8_t number_of_bits)
+int8_t bmm350_restore_reg_snapshot(const struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev)
 {
-    int32_t power = 0;
-    int32_t retval;
+    /* Variable to store the function result */
+    int8_t rslt;
 
-    switch (number_of_bits)
+    /* Writable registers, coalesced into consecutive bursts */
+    const uint8_t burst_start[BMM350_SNAPSHOT_WRITE_BURSTS] = {
+        BMM350_REG_PAD_CTRL, BMM350_REG_I2C_WDT_SET, BMM350_REG_INT_CTRL, BMM350_REG_TMR_SELFTEST_USER
+    };
+    const uint8_t burst_end[BMM350_SNAPSHOT_WRITE_BURSTS] = {
+        BMM350_REG_PMU_CMD_AXIS_EN, BMM350_REG_I2C_WDT_SET, BMM350_REG_INT_CTRL_IBI, BMM350_REG_CTRL_USER
+    };
+
+    uint8_t index;
+    uint8_t reg_data;
+    enum bmm350_power_modes powermode = BMM350_SUSPEND_MODE;
+
+    /* Check for null pointer in the device structure */
+    rslt = null_ptr_check(dev);
+
+    if ((rslt == BMM350_OK) && (snapshot != NULL))
+    {
+        rslt = bmm350_bus_acquire(dev);
+
+        if (rslt == BMM350_OK)
+        {
+            for (index = 0; (index < BMM350_SNAPSHOT_WRITE_BURSTS) && (rslt == BMM350_OK); index++)
+            {
+                rslt = bmm350_set_regs(burst_start[index],
+                                       &snapshot->regs[burst_start[index]],
+                                       (uint16_t)(burst_end[index] - burst_start[index] + 1),
+                                       dev);
+            }
+
+            if (rslt == BMM350_OK)
+            {
+                /* Apply ODR and averaging */
+                reg_data = BMM350_PMU_CMD_UPD_OAE;
+                rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &reg_data, 1, dev);
+            }
+
+            /* Release the bus before the delay */
+            rslt = release_bus(rslt, dev);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            dev->axis_en = snapshot->axis_en;
+
+            rslt = bmm350_delay_us(BMM350_UPD_OAE_DELAY, dev);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            if (snapshot->pmu_cmd_stat_0.pwr_mode_is_normal == BMM350_ENABLE)
+            {
+                powermode = (snapshot->pmu_cmd == BMM350_PMU_CMD_NM_TC) ? BMM350_NORMAL_MODE_TC : BMM350_NORMAL_MODE;
+            }
+
+            rslt = bmm350_set_powermode(powermode, dev);
+        }
+    }
+    else if (rslt == BMM350_OK)
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API initializes a diagnostic event log on application storage.
+ */
+int8_t bmm350_event_log_init(struct bmm350_event *entries,
+                             uint16_t capacity,
+                             bmm350_event_time_fptr_t time_us,
+                             struct bmm350_event_log *log)
+{
+    /* Variable to store the function result */
+    int8_t rslt = BMM350_OK;
+
+    if ((entries != NULL) && (log != NULL))
+    {
+        /* The ring index is masked, so the capacity must be a power of two */
+        if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            log->entries = entries;
+            log->capacity = capacity;
+            log->head = 0;
+            log->sensortime = 0;
+            log->time_us = time_us;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API stores an application or add-on event in the event log of the device.
+ */
+int8_t bmm350_log_event(uint8_t type, int8_t code, uint16_t arg, struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt = BMM350_OK;
+
+    if (dev != NULL)
+    {
+        log_event(type, code, arg, dev);
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API copies the events of the log from a sequence number on, oldest first.
+ */
+int8_t bmm350_get_events(uint32_t from_seq,
+                         struct bmm350_event *events,
+                         uint16_t max_events,
+                         uint16_t *n_events,
+                         uint32_t *first_seq,
+                         const struct bmm350_event_log *log)
+{
+    /* Variable to store the function result */
+    int8_t rslt = BMM350_OK;
+
+    uint32_t head, first, count, overwritten;
+    uint32_t index;
+    const volatile struct bmm350_event *entries;
+
+    if ((events != NULL) && (n_events != NULL) && (first_seq != NULL) && (log != NULL) && (log->entries != NULL))
+    {
+        entries = log->entries;
+        head = log->head;
+        BMM350_EVENT_LOG_BARRIER();
+
+        /* Oldest event still in the ring. The slot of event head - capacity is the one the driver
+         * writes next, so that event counts as overwritten */
+        first = (head >= log->capacity) ? (head - log->capacity + 1) : 0;
+
+        if (from_seq > first)
+        {
+            first = (from_seq < head) ? from_seq : head;
+        }
+
+        count = head - first;
+
+        if (count > max_events)
+        {
+            count = max_events;
+        }
+
+        for (index = 0; index < count; index++)
+        {
+            events[index] = entries[(first + index) & (uint32_t)(log->capacity - 1)];
+        }
+
+        /* Drop the events the driver overwrote, or was overwriting, while they were copied */
+        BMM350_EVENT_LOG_BARRIER();
+        head = log->head;
+        overwritten = (head >= log->capacity) ? (head - log->capacity + 1) : 0;
+
+        if (overwritten > first)
+        {
+            overwritten -= first;
+
+            if (overwritten > count)
+            {
+                overwritten = count;
+            }
+
+            for (index = 0; index < (count - overwritten); index++)
+            {
+                events[index] = events[index + overwritten];
+            }
+
+            first += overwritten;
+            count -= overwritten;
+        }
+
+        *n_events = (uint16_t)count;
+        *first_seq = first;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/****************************************************************************/
+/**\name     INTERNAL APIs                                                  */
+
+/*!
+ * @brief This internal API is used to validate the device structure pointer for
+ * null conditions.
+ */
+static int8_t null_ptr_check(const struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    if ((dev == NULL) || (dev->read == NULL) || (dev->write == NULL) || (dev->delay_us == NULL))
+    {
+        /* Device structure pointer is not valid */
+        rslt = BMM350_E_NULL_PTR;
+    }
+    else
+    {
+        /* Device structure is fine */
+        rslt = BMM350_OK;
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API converts the raw data from the IC data registers to signed integer
+ */
+static int32_t fix_sign(uint32_t inval, int8_t number_of_bits)
+{
+    int32_t power = 0;
+    int32_t retval;
+
+    switch (number_of_bits)
     {
         case BMM350_SIGNED_8_BIT:
             power = 128; /* 2^7 */
@@ -1259,7 +1965,8 @@ static int8_t read_otp_word(uint8_t addr, uint16_t *lsb_msb, struct bmm350_dev *
     /* Variable to store the function result */
     int8_t rslt;
 
-    uint8_t otp_cmd, otp_status = 0, otp_err = BMM350_OTP_STATUS_NO_ERROR, lsb = 0, msb = 0;
+    uint8_t otp_cmd, otp_status = 0, otp_err = BMM350_OTP_STATUS_NO_ERROR;
+    uint8_t otp_data[2] = { 0 };
 
     if (lsb_msb != NULL)
     {
@@ -1308,18 +2015,18 @@ static int8_t read_otp_word(uint8_t addr, uint16_t *lsb_msb, struct bmm350_dev *
                         rslt = BMM350_E_OTP_UNDEFINED;
                         break;
                 }
+
+                log_event(BMM350_EVENT_ERROR, rslt, addr, dev);
             }
         }
 
         if (rslt == BMM350_OK)
         {
-            /* Get OTP MSB data */
-            rslt = bmm350_get_regs(BMM350_REG_OTP_DATA_MSB_REG, &msb, 1, dev);
+            /* Get OTP MSB and LSB data in one burst */
+            rslt = bmm350_get_regs(BMM350_REG_OTP_DATA_MSB_REG, otp_data, 2, dev);
             if (rslt == BMM350_OK)
             {
-                /* Get OTP LSB data */
-                rslt = bmm350_get_regs(BMM350_REG_OTP_DATA_LSB_REG, &lsb, 1, dev);
-                *lsb_msb = ((uint16_t)(msb << 8) | lsb) & 0xFFFF;
+                *lsb_msb = ((uint16_t)(otp_data[0] << 8) | otp_data[1]) & 0xFFFF;
             }
         }
     }
@@ -1393,6 +2100,24 @@ static void update_mag_off_sens(struct bmm350_dev *dev)
     dev->mag_comp.cross_axis.cross_z_y = fix_sign(cross_z_y, BMM350_SIGNED_8_BIT) / 800.0f;
 }
 
+/*!
+ * @brief This internal API is used to release the bus while keeping the first error.
+ */
+static int8_t release_bus(int8_t rslt, struct bmm350_dev *dev)
+{
+    /* Variable to store the release result */
+    int8_t release_rslt;
+
+    release_rslt = bmm350_bus_release(dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = release_rslt;
+    }
+
+    return rslt;
+}
+
 /*!
  * @brief This internal API is used to read raw magnetic x,y and z axis along with temperature
  */
@@ -1401,40 +2126,15 @@ static int8_t read_out_raw_data(float *out_data, struct bmm350_dev *dev)
     /* Variable to store the function result */
     int8_t rslt;
 
-    float temp = 0.0;
     struct bmm350_raw_mag_data raw_data = { 0 };
 
-    /* Float variable to convert mag lsb to uT and temp lsb to degC */
-    float lsb_to_ut_degc[4];
-
     if (out_data != NULL)
     {
         rslt = bmm350_read_uncomp_mag_temp_data(&raw_data, dev);
 
         if (rslt == BMM350_OK)
         {
-            /* Convert mag lsb to uT and temp lsb to degC */
-            update_default_coefiecents(lsb_to_ut_degc);
-
-            out_data[0] = (float)raw_data.raw_xdata * lsb_to_ut_degc[0];
-            out_data[1] = (float)raw_data.raw_ydata * lsb_to_ut_degc[1];
-            out_data[2] = (float)raw_data.raw_zdata * lsb_to_ut_degc[2];
-            out_data[3] = (float)raw_data.raw_data_t * lsb_to_ut_degc[3];
-
-            if (out_data[3] > 0.0)
-            {
-                temp = (float)(out_data[3] - (1 * 25.49));
-            }
-            else if (out_data[3] < 0.0)
-            {
-                temp = (float)(out_data[3] - (-1 * 25.49));
-            }
-            else
-            {
-                temp = (float)(out_data[3]);
-            }
-
-            out_data[3] = temp;
+            convert_raw_data(&raw_data, 1, out_data);
         }
     }
     else
@@ -1445,6 +2145,174 @@ static int8_t read_out_raw_data(float *out_data, struct bmm350_dev *dev)
     return rslt;
 }
 
+/*!
+ * @brief This internal API is used to convert the raw mag and temperature register bytes into signed
+ * raw data.
+ */
+static void parse_raw_mag_temp_data(const uint8_t *mag_data,
+                                    struct bmm350_raw_mag_data *raw_data,
+                                    const struct bmm350_dev *dev)
+{
+    uint32_t raw_mag_x, raw_mag_y, raw_mag_z, raw_temp;
+
+    raw_mag_x = mag_data[0] + ((uint32_t)mag_data[1] << 8) + ((uint32_t)mag_data[2] << 16);
+    raw_mag_y = mag_data[3] + ((uint32_t)mag_data[4] << 8) + ((uint32_t)mag_data[5] << 16);
+    raw_mag_z = mag_data[6] + ((uint32_t)mag_data[7] << 8) + ((uint32_t)mag_data[8] << 16);
+    raw_temp = mag_data[9] + ((uint32_t)mag_data[10] << 8) + ((uint32_t)mag_data[11] << 16);
+
+    if ((dev->axis_en & BMM350_EN_X_MSK) == BMM350_DISABLE)
+    {
+        raw_data->raw_xdata = BMM350_DISABLE;
+    }
+    else
+    {
+        raw_data->raw_xdata = fix_sign(raw_mag_x, BMM350_SIGNED_24_BIT);
+    }
+
+    if ((dev->axis_en & BMM350_EN_Y_MSK) == BMM350_DISABLE)
+    {
+        raw_data->raw_ydata = BMM350_DISABLE;
+    }
+    else
+    {
+        raw_data->raw_ydata = fix_sign(raw_mag_y, BMM350_SIGNED_24_BIT);
+    }
+
+    if ((dev->axis_en & BMM350_EN_Z_MSK) == BMM350_DISABLE)
+    {
+        raw_data->raw_zdata = BMM350_DISABLE;
+    }
+    else
+    {
+        raw_data->raw_zdata = fix_sign(raw_mag_z, BMM350_SIGNED_24_BIT);
+    }
+
+    raw_data->raw_data_t = fix_sign(raw_temp, BMM350_SIGNED_24_BIT);
+}
+
+/*!
+ * @brief This internal API is used to convert raw mag data to uT and raw temperature data to degC.
+ */
+static void convert_raw_data(const struct bmm350_raw_mag_data *raw_data, uint16_t count, float *out_data)
+{
+    float temp = 0.0;
+    uint8_t indx;
+
+    /* Float variable to convert mag lsb to uT and temp lsb to degC */
+    float lsb_to_ut_degc[4];
+
+    /* Convert mag lsb to uT and temp lsb to degC */
+    update_default_coefiecents(lsb_to_ut_degc);
+
+    /* Fold the average of summed samples into the scale; exact for a single sample */
+    for (indx = 0; indx < 4; indx++)
+    {
+        lsb_to_ut_degc[indx] /= (float)count;
+    }
+
+    out_data[0] = (float)raw_data->raw_xdata * lsb_to_ut_degc[0];
+    out_data[1] = (float)raw_data->raw_ydata * lsb_to_ut_degc[1];
+    out_data[2] = (float)raw_data->raw_zdata * lsb_to_ut_degc[2];
+    out_data[3] = (float)raw_data->raw_data_t * lsb_to_ut_degc[3];
+
+    if (out_data[3] > 0.0)
+    {
+        temp = (float)(out_data[3] - (1 * 25.49));
+    }
+    else if (out_data[3] < 0.0)
+    {
+        temp = (float)(out_data[3] - (-1 * 25.49));
+    }
+    else
+    {
+        temp = (float)(out_data[3]);
+    }
+
+    out_data[3] = temp;
+}
+
+/*!
+ * @brief This internal API applies the OTP based compensation to converted mag and temperature data
+ * and stores the result for the enabled axes.
+ */
+static void compensate_data(float *out_data, struct bmm350_mag_temp_data *mag_temp_data, const struct bmm350_dev *dev)
+{
+    uint8_t indx;
+    float dut_offset_coef[3], dut_sensit_coef[3], dut_tco[3], dut_tcs[3];
+    float cr_ax_comp_x, cr_ax_comp_y, cr_ax_comp_z;
+
+    /* Apply compensation to temperature reading */
+    out_data[3] = (1 + dev->mag_comp.dut_sensit_coef.t_sens) * out_data[3] + dev->mag_comp.dut_offset_coef.t_offs;
+
+    /* Store magnetic compensation structure to an array */
+    dut_offset_coef[0] = dev->mag_comp.dut_offset_coef.offset_x;
+    dut_offset_coef[1] = dev->mag_comp.dut_offset_coef.offset_y;
+    dut_offset_coef[2] = dev->mag_comp.dut_offset_coef.offset_z;
+
+    dut_sensit_coef[0] = dev->mag_comp.dut_sensit_coef.sens_x;
+    dut_sensit_coef[1] = dev->mag_comp.dut_sensit_coef.sens_y;
+    dut_sensit_coef[2] = dev->mag_comp.dut_sensit_coef.sens_z;
+
+    dut_tco[0] = dev->mag_comp.dut_tco.tco_x;
+    dut_tco[1] = dev->mag_comp.dut_tco.tco_y;
+    dut_tco[2] = dev->mag_comp.dut_tco.tco_z;
+
+    dut_tcs[0] = dev->mag_comp.dut_tcs.tcs_x;
+    dut_tcs[1] = dev->mag_comp.dut_tcs.tcs_y;
+    dut_tcs[2] = dev->mag_comp.dut_tcs.tcs_z;
+
+    /* Compensate raw magnetic data */
+    for (indx = 0; indx < 3; indx++)
+    {
+        out_data[indx] *= 1 + dut_sensit_coef[indx];
+        out_data[indx] += dut_offset_coef[indx];
+        out_data[indx] += dut_tco[indx] * (out_data[3] - dev->mag_comp.dut_t0);
+        out_data[indx] /= 1 + dut_tcs[indx] * (out_data[3] - dev->mag_comp.dut_t0);
+    }
+
+    cr_ax_comp_x = (out_data[0] - dev->mag_comp.cross_axis.cross_x_y * out_data[1]) /
+                   (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y);
+    cr_ax_comp_y = (out_data[1] - dev->mag_comp.cross_axis.cross_y_x * out_data[0]) /
+                   (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y);
+    cr_ax_comp_z =
+        (out_data[2] +
+         (out_data[0] *
+          (dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_z_y -
+           dev->mag_comp.cross_axis.cross_z_x) - out_data[1] *
+          (dev->mag_comp.cross_axis.cross_z_y - dev->mag_comp.cross_axis.cross_x_y *
+           dev->mag_comp.cross_axis.cross_z_x)) /
+         (1 - dev->mag_comp.cross_axis.cross_y_x * dev->mag_comp.cross_axis.cross_x_y));
+
+    if ((dev->axis_en & BMM350_EN_X_MSK) == BMM350_DISABLE)
+    {
+        mag_temp_data->x = BMM350_DISABLE;
+    }
+    else
+    {
+        mag_temp_data->x = cr_ax_comp_x;
+    }
+
+    if ((dev->axis_en & BMM350_EN_Y_MSK) == BMM350_DISABLE)
+    {
+        mag_temp_data->y = BMM350_DISABLE;
+    }
+    else
+    {
+        mag_temp_data->y = cr_ax_comp_y;
+    }
+
+    if ((dev->axis_en & BMM350_EN_Z_MSK) == BMM350_DISABLE)
+    {
+        mag_temp_data->z = BMM350_DISABLE;
+    }
+    else
+    {
+        mag_temp_data->z = cr_ax_comp_z;
+    }
+
+    mag_temp_data->temperature = out_data[3];
+}
+
 /*!
  * @brief This internal API is used to convert lsb to uT and degC.
  */
@@ -1478,21 +2346,36 @@ static void update_default_coefiecents(float *lsb_to_ut_degc)
 static int8_t otp_dump_after_boot(struct bmm350_dev *dev)
 {
     /* Variable to store the function result */
-    int8_t rslt;
+    int8_t rslt = BMM350_OK;
 
     uint16_t otp_word = 0;
     uint8_t indx;
 
-    for (indx = 0; indx < BMM350_OTP_DATA_LENGTH; indx++)
+    if (dev->seq_override.otp_dump != NULL)
     {
-        rslt = read_otp_word(indx, &otp_word, dev);
-        dev->otp_data[indx] = otp_word;
+        rslt = dev->seq_override.otp_dump(dev);
     }
+    else
+    {
+        /* Stop at the first failing word, so that its error reaches the caller */
+        for (indx = 0; (indx < BMM350_OTP_DATA_LENGTH) && (rslt == BMM350_OK); indx++)
+        {
+            rslt = read_otp_word(indx, &otp_word, dev);
 
-    dev->var_id = (dev->otp_data[30] & 0x7f00) >> 9;
+            if (rslt == BMM350_OK)
+            {
+                dev->otp_data[indx] = otp_word;
+            }
+        }
+    }
 
-    /* Update magnetometer offset and sensitivity data. */
-    update_mag_off_sens(dev);
+    if (rslt == BMM350_OK)
+    {
+        dev->var_id = (dev->otp_data[30] & 0x7f00) >> 9;
+
+        /* Update magnetometer offset and sensitivity data. */
+        update_mag_off_sens(dev);
+    }
 
     return rslt;
 }
@@ -1559,7 +2442,7 @@ static int8_t self_test_entry_config(struct bmm350_dev *dev)
 
             if (rslt == BMM350_OK)
             {
-                rslt = bmm350_delay_us(4000, dev);
+                rslt = bmm350_delay_us(BMM350_BR_FAST_DELAY, dev);
             }
         }
     }
@@ -1571,14 +2454,7 @@ static int8_t self_test_entry_config(struct bmm350_dev *dev)
 
     if ((rslt == BMM350_OK) && (pmu_cmd_stat_0.pmu_cmd_value == BMM350_PMU_CMD_STATUS_0_BR_FAST))
     {
-        cmd = BMM350_PMU_CMD_FM_FAST;
-
-        rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &cmd, 1, dev);
-
-        if (rslt == BMM350_OK)
-        {
-            rslt = bmm350_delay_us(16000, dev);
-        }
+        rslt = forced_trigger(BMM350_FORCED_MODE_FAST, 16000, dev);
 
         if (rslt == BMM350_OK)
         {
@@ -1655,16 +2531,11 @@ static int8_t self_test_config(uint8_t st_cmd,
 
     if (rslt == BMM350_OK)
     {
-        rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &pmu_cmd, 1, dev);
+        rslt = forced_trigger((enum bmm350_power_modes)pmu_cmd, 6000, dev);
 
         if (rslt == BMM350_OK)
         {
-            rslt = bmm350_delay_us(6000, dev);
-
-            if (rslt == BMM350_OK)
-            {
-                rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
-            }
+            rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
         }
     }
 
@@ -1713,7 +2584,25 @@ static int8_t self_test_config(uint8_t st_cmd,
 }
 
 /*!
- * @brief This internal API is used to switch from suspend mode to normal mode or forced mode.
+ * @brief This internal API is used to trigger a forced measurement from suspend mode.
+ */
+static int8_t forced_trigger(enum bmm350_power_modes powermode, uint32_t delay_us, struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    rslt = bmm350_trigger_forced(powermode, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_delay_us(delay_us, dev);
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This internal API is used to switch from suspend mode to normal mode (with or without TC) or forced mode.
  */
 static int8_t set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev *dev)
 {
@@ -1736,12 +2625,24 @@ static int8_t set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev
     uint8_t avg = 0;
     uint32_t delay_us = 0;
 
+    /* Variable to store the expected PMU command status */
+    uint8_t pmu_cmd_value;
+
+    struct bmm350_pmu_cmd_status_0 pmu_cmd_stat_0 = { 0 };
+
     rslt = null_ptr_check(dev);
 
     if (rslt == BMM350_OK)
     {
-        /* Set PMU command configuration to desired power mode */
-        rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &reg_data, 1, dev);
+        if ((powermode == BMM350_FORCED_MODE) || (powermode == BMM350_FORCED_MODE_FAST))
+        {
+            rslt = bmm350_trigger_forced(powermode, dev);
+        }
+        else
+        {
+            /* Set PMU command configuration to desired power mode */
+            rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &reg_data, 1, dev);
+        }
 
         if (rslt == BMM350_OK)
         {
@@ -1758,8 +2659,8 @@ static int8_t set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev
 
     if (rslt == BMM350_OK)
     {
-        /* Check if desired power mode is normal mode */
-        if (powermode == BMM350_NORMAL_MODE)
+        /* Check if desired power mode is normal mode, with or without TC */
+        if ((powermode == BMM350_NORMAL_MODE) || (powermode == BMM350_NORMAL_MODE_TC))
         {
             delay_us = BMM350_SUSPEND_TO_NORMAL_DELAY;
         }
@@ -1782,5 +2683,231 @@ static int8_t set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev
         rslt = bmm350_delay_us(delay_us, dev);
     }
 
+    /* Verify that the sensor reports normal mode and the executed command after entering it */
+    if ((rslt == BMM350_OK) && ((powermode == BMM350_NORMAL_MODE) || (powermode == BMM350_NORMAL_MODE_TC)))
+    {
+        pmu_cmd_value = (powermode == BMM350_NORMAL_MODE_TC) ? BMM350_PMU_CMD_STATUS_0_NM_TC :
+                        BMM350_PMU_CMD_STATUS_0_NM;
+
+        rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
+
+        if ((rslt == BMM350_OK) &&
+            ((pmu_cmd_stat_0.pwr_mode_is_normal != BMM350_ENABLE) || (pmu_cmd_stat_0.pmu_cmd_value != pmu_cmd_value)))
+        {
+            rslt = BMM350_E_PMU_CMD_VALUE;
+            log_event(BMM350_EVENT_ERROR, rslt, pmu_status_arg(&pmu_cmd_stat_0), dev);
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This internal API sends the soft-reset command and waits for it to complete,
+ * or runs the soft-reset override if one is set.
+ */
+static int8_t soft_reset_cmd(struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    /* Variable to store soft-reset command */
+    uint8_t soft_reset = BMM350_CMD_SOFTRESET;
+
+    if (dev->seq_override.soft_reset != NULL)
+    {
+        rslt = dev->seq_override.soft_reset(dev);
+    }
+    else
+    {
+        /* Set the command in the command register */
+        rslt = bmm350_set_regs(BMM350_REG_CMD, &soft_reset, 1, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_delay_us(BMM350_SOFT_RESET_DELAY, dev);
+        }
+    }
+
+    log_event(BMM350_EVENT_RESET, rslt, BMM350_CMD_SOFTRESET, dev);
+
+    return rslt;
+}
+
+/*!
+ * @brief This internal API sends a magnetic reset command, waits for it to complete and
+ * verifies it in PMU_CMD_STATUS_0.
+ */
+static int8_t magnetic_reset_cmd(uint8_t pmu_cmd, uint32_t delay_us, uint8_t pmu_cmd_value, struct bmm350_dev *dev)
+{
+    /* Variable to store the function result */
+    int8_t rslt;
+
+    struct bmm350_pmu_cmd_status_0 pmu_cmd_stat_0 = { 0 };
+
+    rslt = bmm350_set_regs(BMM350_REG_PMU_CMD, &pmu_cmd, 1, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_delay_us(delay_us, dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_get_pmu_cmd_status_0(&pmu_cmd_stat_0, dev);
+
+        if ((rslt == BMM350_OK) && (pmu_cmd_stat_0.pmu_cmd_value != pmu_cmd_value))
+        {
+            rslt = BMM350_E_PMU_CMD_VALUE;
+            log_event(BMM350_EVENT_ERROR, rslt, pmu_status_arg(&pmu_cmd_stat_0), dev);
+        }
+    }
+
+    log_event(BMM350_EVENT_RESET, rslt, pmu_cmd, dev);
+
     return rslt;
 }
+
+/*!
+ * @brief This internal API decodes the register values of a snapshot with the register masks.
+ */
+static void decode_reg_snapshot(struct bmm350_reg_snapshot *snapshot)
+{
+    const uint8_t *regs = snapshot->regs;
+    uint32_t raw;
+
+    snapshot->chip_id = regs[BMM350_REG_CHIP_ID];
+    snapshot->rev_id = regs[BMM350_REG_REV_ID];
+
+    snapshot->pmu_cmd_error = BMM350_GET_BITS_POS_0(regs[BMM350_REG_ERR_REG], BMM350_PMU_CMD_ERROR);
+    snapshot->boot_up_error = BMM350_GET_BITS(regs[BMM350_REG_ERR_REG], BMM350_BOOT_UP_ERROR);
+
+    snapshot->pad_drive = BMM350_GET_BITS_POS_0(regs[BMM350_REG_PAD_CTRL], BMM350_DRV);
+
+    snapshot->odr = BMM350_GET_BITS_POS_0(regs[BMM350_REG_PMU_CMD_AGGR_SET], BMM350_ODR);
+    snapshot->avg = BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_AGGR_SET], BMM350_AVG);
+
+    snapshot->axis_en = BMM350_GET_BITS_POS_0(regs[BMM350_REG_PMU_CMD_AXIS_EN], BMM350_EN_XYZ);
+
+    snapshot->pmu_cmd = BMM350_GET_BITS_POS_0(regs[BMM350_REG_PMU_CMD], BMM350_PMU_CMD);
+
+    snapshot->pmu_cmd_stat_0.pmu_cmd_busy =
+        BMM350_GET_BITS_POS_0(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_PMU_CMD_BUSY);
+    snapshot->pmu_cmd_stat_0.odr_ovwr = BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_ODR_OVWR);
+    snapshot->pmu_cmd_stat_0.avr_ovwr = BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_AVG_OVWR);
+    snapshot->pmu_cmd_stat_0.pwr_mode_is_normal =
+        BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_PWR_MODE_IS_NORMAL);
+    snapshot->pmu_cmd_stat_0.cmd_is_illegal =
+        BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_CMD_IS_ILLEGAL);
+    snapshot->pmu_cmd_stat_0.pmu_cmd_value =
+        BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_PMU_CMD_VALUE);
+
+    snapshot->pmu_odr_s = BMM350_GET_BITS_POS_0(regs[BMM350_REG_PMU_CMD_STATUS_1], BMM350_PMU_ODR_S);
+    snapshot->pmu_avg_s = BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_1], BMM350_PMU_AVG_S);
+
+    snapshot->i2c_wdt_en = BMM350_GET_BITS_POS_0(regs[BMM350_REG_I2C_WDT_SET], BMM350_I2C_WDT_EN);
+    snapshot->i2c_wdt_sel = BMM350_GET_BITS(regs[BMM350_REG_I2C_WDT_SET], BMM350_I2C_WDT_SEL);
+
+    snapshot->int_mode = BMM350_GET_BITS_POS_0(regs[BMM350_REG_INT_CTRL], BMM350_INT_MODE);
+    snapshot->int_pol = BMM350_GET_BITS(regs[BMM350_REG_INT_CTRL], BMM350_INT_POL);
+    snapshot->int_od = BMM350_GET_BITS(regs[BMM350_REG_INT_CTRL], BMM350_INT_OD);
+    snapshot->int_output_en = BMM350_GET_BITS(regs[BMM350_REG_INT_CTRL], BMM350_INT_OUTPUT_EN);
+    snapshot->drdy_data_reg_en = BMM350_GET_BITS(regs[BMM350_REG_INT_CTRL], BMM350_DRDY_DATA_REG_EN);
+
+    snapshot->drdy_int_map_to_ibi =
+        BMM350_GET_BITS_POS_0(regs[BMM350_REG_INT_CTRL_IBI], BMM350_DRDY_INT_MAP_TO_IBI);
+    snapshot->clear_drdy_int_status_upon_ibi =
+        BMM350_GET_BITS(regs[BMM350_REG_INT_CTRL_IBI], BMM350_CLEAR_DRDY_INT_STATUS_UPON_IBI);
+
+    snapshot->drdy_status = BMM350_GET_BITS(regs[BMM350_REG_INT_STATUS], BMM350_DRDY_DATA_REG);
+
+    raw = regs[BMM350_REG_MAG_X_XLSB] + ((uint32_t)regs[BMM350_REG_MAG_X_LSB] << 8) +
+          ((uint32_t)regs[BMM350_REG_MAG_X_MSB] << 16);
+    snapshot->raw_data.raw_xdata = fix_sign(raw, BMM350_SIGNED_24_BIT);
+
+    raw = regs[BMM350_REG_MAG_Y_XLSB] + ((uint32_t)regs[BMM350_REG_MAG_Y_LSB] << 8) +
+          ((uint32_t)regs[BMM350_REG_MAG_Y_MSB] << 16);
+    snapshot->raw_data.raw_ydata = fix_sign(raw, BMM350_SIGNED_24_BIT);
+
+    raw = regs[BMM350_REG_MAG_Z_XLSB] + ((uint32_t)regs[BMM350_REG_MAG_Z_LSB] << 8) +
+          ((uint32_t)regs[BMM350_REG_MAG_Z_MSB] << 16);
+    snapshot->raw_data.raw_zdata = fix_sign(raw, BMM350_SIGNED_24_BIT);
+
+    raw = regs[BMM350_REG_TEMP_XLSB] + ((uint32_t)regs[BMM350_REG_TEMP_LSB] << 8) +
+          ((uint32_t)regs[BMM350_REG_TEMP_MSB] << 16);
+    snapshot->raw_data.raw_data_t = fix_sign(raw, BMM350_SIGNED_24_BIT);
+
+    snapshot->sensortime = regs[BMM350_REG_SENSORTIME_XLSB] + ((uint32_t)regs[BMM350_REG_SENSORTIME_LSB] << 8) +
+                           ((uint32_t)regs[BMM350_REG_SENSORTIME_MSB] << 16);
+
+    snapshot->otp_status_error = BMM350_OTP_STATUS_ERROR(regs[BMM350_REG_OTP_STATUS_REG]);
+
+    snapshot->st_igen_en = BMM350_GET_BITS_POS_0(regs[BMM350_REG_TMR_SELFTEST_USER], BMM350_ST_IGEN_EN);
+    snapshot->st_n = BMM350_GET_BITS(regs[BMM350_REG_TMR_SELFTEST_USER], BMM350_ST_N);
+    snapshot->st_p = BMM350_GET_BITS(regs[BMM350_REG_TMR_SELFTEST_USER], BMM350_ST_P);
+    snapshot->ist_en_x = BMM350_GET_BITS(regs[BMM350_REG_TMR_SELFTEST_USER], BMM350_IST_EN_X);
+    snapshot->ist_en_y = BMM350_GET_BITS(regs[BMM350_REG_TMR_SELFTEST_USER], BMM350_IST_EN_Y);
+
+    snapshot->cfg_sens_tim_aon = BMM350_GET_BITS_POS_0(regs[BMM350_REG_CTRL_USER], BMM350_CFG_SENS_TIM_AON);
+}
+
+/*!
+ * @brief This internal API stores an event in the event log of the device, if one is attached.
+ */
+static void log_event(uint8_t type, int8_t code, uint16_t arg, struct bmm350_dev *dev)
+{
+    struct bmm350_event_log *log = dev->event_log;
+    volatile struct bmm350_event *event;
+    uint32_t head;
+
+    if ((log != NULL) && (log->entries != NULL) && (log->capacity != 0))
+    {
+        head = log->head;
+        event = &log->entries[head & (uint32_t)(log->capacity - 1)];
+
+        event->host_time_us = (log->time_us != NULL) ? log->time_us(dev->intf_ptr) : 0;
+        event->sensortime = log->sensortime;
+        event->type = type;
+        event->code = code;
+        event->arg = arg;
+
+        /* Publish the event once it is complete */
+        BMM350_EVENT_LOG_BARRIER();
+        log->head = head + 1;
+    }
+}
+
+/*!
+ * @brief This internal API packs the PMU command status 0 into the argument of a PMU status event.
+ */
+static uint16_t pmu_status_arg(const struct bmm350_pmu_cmd_status_0 *pmu_cmd_stat_0)
+{
+    uint8_t flags = 0;
+
+    if (pmu_cmd_stat_0->pmu_cmd_busy == BMM350_ENABLE)
+    {
+        flags |= BMM350_EVENT_PMU_BUSY;
+    }
+
+    if (pmu_cmd_stat_0->odr_ovwr == BMM350_ENABLE)
+    {
+        flags |= BMM350_EVENT_PMU_ODR_OVWR;
+    }
+
+    if (pmu_cmd_stat_0->avr_ovwr == BMM350_ENABLE)
+    {
+        flags |= BMM350_EVENT_PMU_AVG_OVWR;
+    }
+
+    if (pmu_cmd_stat_0->pwr_mode_is_normal == BMM350_ENABLE)
+    {
+        flags |= BMM350_EVENT_PMU_NORMAL;
+    }
+
+    if (pmu_cmd_stat_0->cmd_is_illegal == BMM350_ENABLE)
+    {
+        flags |= BMM350_EVENT_PMU_ILLEGAL;
+    }
+
+    return (uint16_t)(pmu_cmd_stat_0->pmu_cmd_value | ((uint16_t)flags << 8));
+}
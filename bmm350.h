@@ -80,6 +80,25 @@ extern "C" {
 */
 int8_t bmm350_init(struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiInit
+* \page bmm350_api_bmm350_init_with_magreset bmm350_init_with_magreset
+* \code
+* int8_t bmm350_init_with_magreset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev);
+* \endcode
+* @details This API performs the same initialization as bmm350_init, but
+*  applies the given magnetic reset variant at the end of the sequence
+*  instead of the full bit reset and flux guide reset.
+*
+*  @param[in] reset_type   : Magnetic reset variant, see bmm350_magnetic_reset
+*  @param[in,out] dev      : Structure instance of bmm350_dev
+*
+*  @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_init_with_magreset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev);
+
 /**
  * \ingroup bmm350
  * \defgroup bmm350ApiReset Reset
@@ -150,6 +169,52 @@ int8_t bmm350_set_regs(uint8_t reg_addr, const uint8_t *reg_data, uint16_t len,
 */
 int8_t bmm350_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct bmm350_dev *dev);
 
+/**
+ * \ingroup bmm350
+ * \defgroup bmm350ApiBus Bus arbitration
+ * @brief Hold a shared bus across several transactions
+ */
+
+/*!
+* \ingroup bmm350ApiBus
+* \page bmm350_api_bmm350_bus_acquire bmm350_bus_acquire
+* \code
+* int8_t bmm350_bus_acquire(struct bmm350_dev *dev);
+* \endcode
+* @details This API acquires the bus through dev->bus_lock so that a sequence of
+* transactions is not interleaved with other users of the bus. Calls can be nested;
+* only the outermost call locks the bus. bmm350_get_regs and bmm350_set_regs acquire the
+* bus for each transaction, and the read-modify-write APIs hold it across the sequence.
+* If dev->bus_lock is NULL, only the nesting depth is tracked.
+*
+* Every lock updates dev->bus_stats with the wait time reported by the callback.
+* The bus should not be held across delays.
+*
+* @param[in,out] dev   : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_bus_acquire(struct bmm350_dev *dev);
+
+/*!
+* \ingroup bmm350ApiBus
+* \page bmm350_api_bmm350_bus_release bmm350_bus_release
+* \code
+* int8_t bmm350_bus_release(struct bmm350_dev *dev);
+* \endcode
+* @details This API releases the bus acquired with bmm350_bus_acquire. The bus is unlocked
+* through dev->bus_unlock when the outermost acquire is released.
+*
+* @param[in,out] dev   : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_bus_release(struct bmm350_dev *dev);
+
 /**
  * \ingroup bmm350
  * \defgroup bmm350ApiDelay Delay
@@ -211,14 +276,38 @@ int8_t bmm350_get_interrupt_status(uint8_t *drdy_status, struct bmm350_dev *dev)
                           |  BMM350_NORMAL_MODE
                           |  BMM350_FORCED_MODE
                           |  BMM350_FORCED_MODE_FAST
+                          |  BMM350_NORMAL_MODE_TC
 *@endverbatim
 *
+* @note Entering BMM350_NORMAL_MODE or BMM350_NORMAL_MODE_TC is verified
+* through PMU_CMD_STATUS_0.pwr_mode_is_normal and pmu_cmd_value.
+*
 * @return Result of API execution status
 *  @retval = 0 -> Success
 *  @retval < 0 -> Error
 */
 int8_t bmm350_set_powermode(enum bmm350_power_modes powermode, struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiSetGet
+* \page bmm350_api_bmm350_trigger_forced bmm350_trigger_forced
+* \code
+* int8_t bmm350_trigger_forced(enum bmm350_power_modes powermode, struct bmm350_dev *dev);
+* \endcode
+* @details This API triggers one forced mode conversion from suspend mode without waiting for it.
+* The sample can be read once data ready is signalled; the sensor returns to suspend mode on its own
+* after the conversion. An installed forced_trigger sequence override runs instead of the PMU command write.
+*
+* @param[in] powermode : BMM350_FORCED_MODE or BMM350_FORCED_MODE_FAST
+* @param[in] dev       : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval BMM350_E_INVALID_INPUT -> powermode is not a forced mode
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_trigger_forced(enum bmm350_power_modes powermode, struct bmm350_dev *dev);
+
 /*!
 * \ingroup bmm350ApiSetGet
 * \page bmm350_api_bmm350_set_odr_performance bmm350_set_odr_performance
@@ -269,6 +358,24 @@ int8_t bmm350_set_odr_performance(enum bmm350_data_rates odr,
                                   enum bmm350_performance_parameters avg,
                                   struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiSetGet
+* \page bmm350_api_bmm350_cap_averaging bmm350_cap_averaging
+* \code
+* enum bmm350_performance_parameters bmm350_cap_averaging(enum bmm350_data_rates odr,
+*                                                         enum bmm350_performance_parameters avg);
+* \endcode
+* @details This API returns the averaging that bmm350_set_odr_performance applies at an ODR:
+* at most BMM350_NO_AVERAGING at 400Hz, BMM350_AVERAGING_2 at 200Hz and BMM350_AVERAGING_4 at 100Hz.
+*
+* @param[in]  odr       :  enum bmm350_data_rates
+* @param[in]  avg       :  Requested enum bmm350_performance_parameters
+*
+* @return Averaging used at the ODR
+*/
+enum bmm350_performance_parameters bmm350_cap_averaging(enum bmm350_data_rates odr,
+                                                        enum bmm350_performance_parameters avg);
+
 /*!
 * \ingroup bmm350ApiSetGet
 * \page bmm350_api_bmm350_enable_axes bmm350_enable_axes
@@ -325,6 +432,34 @@ int8_t bmm350_enable_axes(enum bmm350_x_axis_en_dis en_x,
 */
 int8_t bmm350_read_sensortime(uint32_t *seconds, uint32_t *nanoseconds, struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiRead
+* \page bmm350_api_bmm350_extend_sensortime bmm350_extend_sensortime
+* \code
+* int8_t bmm350_extend_sensortime(uint32_t sensortime,
+*                                 uint32_t period_ticks,
+*                                 uint32_t *missed,
+*                                 struct bmm350_timeline *timeline);
+* \endcode
+* @details This API extends the 24-bit sensortime of a sample to a 64-bit timeline. The first sample
+* starts the timeline at its sensortime. Consecutive samples have to be less than one counter period
+* (about 655s) apart. With the sample period, gaps longer than 1.5 periods are counted as missed samples.
+* A zeroed bmm350_timeline is an empty timeline.
+*
+* @param[in] sensortime      : Raw 24-bit sensortime of the sample.
+* @param[in] period_ticks    : Sample period in ticks, BMM350_ODR_PERIOD_BASE_TICKS << odr, 0 to not count gaps.
+* @param[out] missed         : Samples missing before this one, can be NULL.
+* @param[in,out] timeline    : Structure instance of bmm350_timeline; ticks is the extended sensortime.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_extend_sensortime(uint32_t sensortime,
+                                uint32_t period_ticks,
+                                uint32_t *missed,
+                                struct bmm350_timeline *timeline);
+
 /**
  * \ingroup bmm350
  * \defgroup bmm350ApiInterrupt Enable Interrupt
@@ -456,6 +591,39 @@ int8_t bmm350_set_pad_drive(uint8_t drive, struct bmm350_dev *dev);
 */
 int8_t bmm350_magnetic_reset_and_wait(struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiReset
+* \page bmm350_api_bmm350_magnetic_reset bmm350_magnetic_reset
+* \code
+* int8_t bmm350_magnetic_reset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev)
+* \endcode
+* @details  This API performs the selected magnetic reset variant.
+* Like bmm350_magnetic_reset_and_wait, it switches to suspend mode if needed,
+* verifies every step in PMU_CMD_STATUS_0 and restores normal mode afterwards.
+*
+* @param[in] reset_type : Magnetic reset variant
+* @param[in] dev        : Structure instance of bmm350_dev.
+*
+*@verbatim
+       reset_type          |   Sequence                   | Wait time
+ --------------------------|------------------------------|-----------
+  BMM350_FLUXGUIDE_9MS     |  BR + FGR                    |  32ms
+  BMM350_FLUXGUIDE_FAST    |  BR_FAST + FGR_FAST          |   9ms
+  BMM350_BITRESET_9MS      |  BR                          |  14ms
+  BMM350_BITRESET_FAST     |  BR_FAST                     |   4ms
+  BMM350_NOMAGRESET        |  None                        |   0ms
+*@endverbatim
+*
+* @note BMM350_FLUXGUIDE_9MS is the sequence of bmm350_magnetic_reset_and_wait
+* and also honours dev->mraw_override. The wait times exclude the suspend and
+* normal mode transitions needed when the sensor was in normal mode.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_magnetic_reset(enum bmm350_magreset_type reset_type, struct bmm350_dev *dev);
+
 /**
  * \ingroup bmm350
  * \defgroup bmm350ApiMagComp Compensation
@@ -479,6 +647,85 @@ int8_t bmm350_magnetic_reset_and_wait(struct bmm350_dev *dev);
 */
 int8_t bmm350_get_compensated_mag_xyz_temp_data(struct bmm350_mag_temp_data *mag_temp_data, struct bmm350_dev *dev);
 
+/*!
+* \ingroup bmm350ApiMagComp
+* \page bmm350_api_bmm350_get_compensated_mag_xyz_temp_sensortime bmm350_get_compensated_mag_xyz_temp_sensortime
+* \code
+* int8_t bmm350_get_compensated_mag_xyz_temp_sensortime(struct bmm350_mag_temp_data *mag_temp_data,
+*                                                       uint32_t *sensortime,
+*                                                       struct bmm350_dev *dev);
+* \endcode
+* @details This API reads mag, temperature and sensortime in a single burst read and
+* performs compensation for the magnetometer and temperature data. The sensortime is
+* the sensor time of the conversion in raw 24-bit ticks of 39.0625us.
+*
+* @param[out] mag_temp_data    : Structure instance of bmm350_mag_temp_data.
+* @param[out] sensortime       : Sensortime of the conversion in ticks.
+* @param[in] dev               : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_get_compensated_mag_xyz_temp_sensortime(struct bmm350_mag_temp_data *mag_temp_data,
+                                                      uint32_t *sensortime,
+                                                      struct bmm350_dev *dev);
+
+/*!
+* \ingroup bmm350ApiMagComp
+* \page bmm350_api_bmm350_compensate_raw_mag_temp_data bmm350_compensate_raw_mag_temp_data
+* \code
+* int8_t bmm350_compensate_raw_mag_temp_data(const struct bmm350_raw_mag_data *raw_data,
+*                                            uint16_t count,
+*                                            struct bmm350_mag_temp_data *mag_temp_data,
+*                                            const struct bmm350_dev *dev);
+* \endcode
+* @details This API performs compensation for raw data read with bmm350_read_uncomp_mag_temp_data.
+* raw_data can also hold the sum of count raw samples, which are then compensated as their average.
+* This lets raw samples be decimated in integer arithmetic before a single compensation.
+*
+* @param[in] raw_data          : Raw data, or the sum of count raw samples.
+* @param[in] count             : Number of samples summed in raw_data, 1 for a single sample.
+* @param[out] mag_temp_data    : Structure instance of bmm350_mag_temp_data.
+* @param[in] dev               : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_compensate_raw_mag_temp_data(const struct bmm350_raw_mag_data *raw_data,
+                                           uint16_t count,
+                                           struct bmm350_mag_temp_data *mag_temp_data,
+                                           const struct bmm350_dev *dev);
+
+/*!
+* \ingroup bmm350ApiMagComp
+* \page bmm350_api_bmm350_get_status_compensated_mag_xyz_temp_sensortime bmm350_get_status_compensated_mag_xyz_temp_sensortime
+* \code
+* int8_t bmm350_get_status_compensated_mag_xyz_temp_sensortime(uint8_t *drdy_status,
+*                                                              struct bmm350_mag_temp_data *mag_temp_data,
+*                                                              uint32_t *sensortime,
+*                                                              struct bmm350_dev *dev);
+* \endcode
+* @details This API reads the interrupt status, mag, temperature and sensortime in a single burst read
+* and performs compensation for the magnetometer and temperature data. Reading the status clears a
+* latched data ready interrupt, so one transfer both releases the interrupt line and fetches the sample.
+* The data is the last conversion; it is new only if the data ready status is set.
+*
+* @param[out] drdy_status      : Data ready status, BMM350_ENABLE if the data is new.
+* @param[out] mag_temp_data    : Structure instance of bmm350_mag_temp_data.
+* @param[out] sensortime       : Sensortime of the conversion in ticks.
+* @param[in] dev               : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_get_status_compensated_mag_xyz_temp_sensortime(uint8_t *drdy_status,
+                                                             struct bmm350_mag_temp_data *mag_temp_data,
+                                                             uint32_t *sensortime,
+                                                             struct bmm350_dev *dev);
+
 /**
  * \ingroup bmm350
  * \defgroup bmm350ApiSelftest Self-test
@@ -588,6 +835,148 @@ int8_t bmm350_set_ctrl_user(enum bmm350_ctrl_user cfg_sens_tim_aon_en_dis, struc
 */
 int8_t bmm350_get_pmu_cmd_status_0(struct bmm350_pmu_cmd_status_0 *pmu_cmd_stat_0, struct bmm350_dev *dev);
 
+/**
+ * \ingroup bmm350
+ * \defgroup bmm350ApiSnapshot Register snapshot
+ * @brief Save and restore the user registers
+ */
+
+/*!
+* \ingroup bmm350ApiSnapshot
+* \page bmm350_api_bmm350_get_reg_snapshot bmm350_get_reg_snapshot
+* \code
+* int8_t bmm350_get_reg_snapshot(struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev);
+* \endcode
+* @details This API reads all documented user registers (0x00 to 0x0D, 0x21 to 0x3F, 0x50 to 0x55
+* and 0x60 to 0x61) in one burst per range and decodes them. The bus is held across the bursts.
+* Reading INT_STATUS and the data registers has the same effect on the data ready status as
+* a data read.
+*
+* @param[out] snapshot   : Structure instance of bmm350_reg_snapshot.
+* @param[in,out] dev     : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_get_reg_snapshot(struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev);
+
+/*!
+* \ingroup bmm350ApiSnapshot
+* \page bmm350_api_bmm350_restore_reg_snapshot bmm350_restore_reg_snapshot
+* \code
+* int8_t bmm350_restore_reg_snapshot(const struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev);
+* \endcode
+* @details This API writes back the writable configuration of a snapshot: PAD_CTRL to PMU_CMD_AXIS_EN,
+* I2C_WDT_SET, INT_CTRL to INT_CTRL_IBI and TMR_SELFTEST_USER to CTRL_USER, one burst each.
+* ODR and averaging are applied with an update command, then the power mode is restored:
+* normal mode (with or without TC) if the snapshot was taken in normal mode, suspend mode otherwise.
+*
+* @param[in] snapshot    : Structure instance of bmm350_reg_snapshot.
+* @param[in,out] dev     : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_restore_reg_snapshot(const struct bmm350_reg_snapshot *snapshot, struct bmm350_dev *dev);
+
+/**
+ * \ingroup bmm350
+ * \defgroup bmm350ApiEventLog Event log
+ * @brief Record diagnostic events of the driver
+ */
+
+/*!
+* \ingroup bmm350ApiEventLog
+* \page bmm350_api_bmm350_event_log_init bmm350_event_log_init
+* \code
+* int8_t bmm350_event_log_init(struct bmm350_event *entries,
+*                              uint16_t capacity,
+*                              bmm350_event_time_fptr_t time_us,
+*                              struct bmm350_event_log *log);
+* \endcode
+* @details This API initializes a diagnostic event log on application storage. The log is
+* attached by setting dev->event_log; the driver then records bus errors, OTP errors, PMU status
+* anomalies, resets and configuration changes with the host time and the last sensortime read.
+* Recording does no formatting and takes no lock. The same log may be shared by several devices
+* only if they are used from one context.
+*
+* @param[in] entries   : Event storage.
+* @param[in] capacity  : Number of entries, a power of two. capacity - 1 events can be read back.
+* @param[in] time_us   : Host time function pointer, NULL to record 0.
+* @param[out] log      : Structure instance of bmm350_event_log.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_event_log_init(struct bmm350_event *entries,
+                             uint16_t capacity,
+                             bmm350_event_time_fptr_t time_us,
+                             struct bmm350_event_log *log);
+
+/*!
+* \ingroup bmm350ApiEventLog
+* \page bmm350_api_bmm350_log_event bmm350_log_event
+* \code
+* int8_t bmm350_log_event(uint8_t type, int8_t code, uint16_t arg, struct bmm350_dev *dev);
+* \endcode
+* @details This API stores an event of the application or of an add-on module, for example an
+* out of range transition or a retry, in the event log of the device. Nothing is stored if no
+* log is attached.
+*
+* @param[in] type     : Event type, BMM350_EVENT_*.
+* @param[in] code     : Result code.
+* @param[in] arg      : Type specific argument, see struct bmm350_event.
+* @param[in,out] dev  : Structure instance of bmm350_dev.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_log_event(uint8_t type, int8_t code, uint16_t arg, struct bmm350_dev *dev);
+
+/*!
+* \ingroup bmm350ApiEventLog
+* \page bmm350_api_bmm350_get_events bmm350_get_events
+* \code
+* int8_t bmm350_get_events(uint32_t from_seq,
+*                          struct bmm350_event *events,
+*                          uint16_t max_events,
+*                          uint16_t *n_events,
+*                          uint32_t *first_seq,
+*                          const struct bmm350_event_log *log);
+* \endcode
+* @details This API copies the events of the log, oldest first, starting at sequence number from_seq
+* or at the oldest event still in the ring. The sequence number of an event is its position since
+* the log was initialized. A first_seq greater than from_seq means events were overwritten before
+* they were read. The ring holds capacity - 1 readable events: the slot the driver writes next is
+* treated as overwritten. Events the driver overwrites during the copy are dropped, so the copy is
+* consistent when it runs concurrently with the driver on the same core, e.g. from a task while the
+* driver logs from an interrupt. When they run on different cores, BMM350_EVENT_LOG_BARRIER has to be
+* defined as a hardware memory barrier.
+* For an offline dump, write the events to storage as little-endian records of BMM350_EVENT_LEN bytes
+* in the field order of struct bmm350_event.
+*
+* @param[in] from_seq    : Sequence number of the first event wanted, 0 for all.
+* @param[out] events     : Copied events.
+* @param[in] max_events  : Size of events.
+* @param[out] n_events   : Number of events copied.
+* @param[out] first_seq  : Sequence number of events[0]; from_seq for the next call is first_seq + n_events.
+* @param[in] log         : Structure instance of bmm350_event_log.
+*
+* @return Result of API execution status
+*  @retval = 0 -> Success
+*  @retval < 0 -> Error
+*/
+int8_t bmm350_get_events(uint32_t from_seq,
+                         struct bmm350_event *events,
+                         uint16_t max_events,
+                         uint16_t *n_events,
+                         uint32_t *first_seq,
+                         const struct bmm350_event_log *log);
+
 #ifdef __cplusplus
 }
 #endif /* End of CPP guard */
@@ -0,0 +1,234 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_batch.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_batch.h"
+
+/*!
+ * @brief This internal API is used to read one sample into the block and extend its sensortime.
+ */
+static int8_t read_sample(struct bmm350_batch_block *block, struct bmm350_batch *batch, struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    struct bmm350_mag_temp_data data;
+    uint32_t sensortime = 0;
+    uint32_t missed = 0;
+
+    rslt = bmm350_get_compensated_mag_xyz_temp_sensortime(&data, &sensortime, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_extend_sensortime(sensortime, batch->period_ticks, &missed, &batch->timeline);
+        batch->missed_count += missed;
+
+        block->x[block->count] = data.x;
+        block->y[block->count] = data.y;
+        block->z[block->count] = data.z;
+        block->temperature[block->count] = data.temperature;
+        block->sensortime[block->count] = batch->timeline.ticks;
+        block->count++;
+        batch->sample_count++;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This internal API is used to adapt the sleep before the first poll to the polls
+ * needed for the last sample.
+ */
+static void adapt_sleep(uint32_t polls, struct bmm350_batch *batch)
+{
+    if ((polls == 0) && (batch->sleep_us >= batch->poll_us / 2))
+    {
+        /* Data was already waiting: wake up earlier */
+        batch->sleep_us -= batch->poll_us / 2;
+    }
+    else if ((polls > 1) && ((batch->sleep_us + batch->poll_us / 2) <= (batch->period_us - batch->poll_us)))
+    {
+        /* Polled too early: sleep longer */
+        batch->sleep_us += batch->poll_us / 2;
+    }
+}
+
+/*!
+ * @brief This API is used to initialize the batch acquisition.
+ */
+int8_t bmm350_batch_init(enum bmm350_data_rates odr,
+                         bmm350_batch_wait_fptr_t wait_drdy,
+                         bmm350_batch_time_us_fptr_t time_us,
+                         struct bmm350_batch *batch)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (batch != NULL)
+    {
+        if ((odr < BMM350_DATA_RATE_400HZ) || (odr > BMM350_DATA_RATE_1_5625HZ))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            batch->wait_drdy = wait_drdy;
+            batch->time_us = time_us;
+            batch->period_us = BMM350_ODR_PERIOD_BASE_US << odr;
+            batch->period_ticks = BMM350_ODR_PERIOD_BASE_TICKS << odr;
+            batch->poll_us = batch->period_us / 16;
+
+            if (batch->poll_us < BMM350_BATCH_MIN_POLL_US)
+            {
+                batch->poll_us = BMM350_BATCH_MIN_POLL_US;
+            }
+
+            batch->sleep_us = batch->period_us - 2 * batch->poll_us;
+            batch->timeline.started = 0;
+            batch->sample_count = 0;
+            batch->missed_count = 0;
+            batch->empty_polls = 0;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to block until n new samples are read or the timeout expires.
+ */
+int8_t bmm350_batch_read(struct bmm350_batch_block *block,
+                         uint16_t n,
+                         uint32_t timeout_us,
+                         struct bmm350_batch *batch,
+                         struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t elapsed = 0, start = 0, wait, polls = 0;
+    uint8_t drdy;
+    bool sleep = false, slept = false;
+
+    if ((block != NULL) && (block->x != NULL) && (block->y != NULL) && (block->z != NULL) &&
+        (block->temperature != NULL) && (block->sensortime != NULL) && (batch != NULL) && (dev != NULL))
+    {
+        block->count = 0;
+
+        if (n > block->capacity)
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+
+        if (batch->time_us != NULL)
+        {
+            start = batch->time_us();
+        }
+
+        while ((rslt == BMM350_OK) && (block->count < n) && (elapsed < timeout_us))
+        {
+            drdy = BMM350_DISABLE;
+
+            if (batch->wait_drdy != NULL)
+            {
+                wait = timeout_us - elapsed;
+                wait = (wait < (2 * batch->period_us)) ? wait : (2 * batch->period_us);
+
+                if (batch->wait_drdy(wait, dev->intf_ptr))
+                {
+                    drdy = BMM350_ENABLE;
+                    wait = (wait < batch->period_us) ? wait : batch->period_us;
+                }
+
+                elapsed += wait;
+            }
+            else
+            {
+                if (sleep)
+                {
+                    /* Sleep until shortly before the next sample is due */
+                    wait = timeout_us - elapsed;
+                    wait = (wait < batch->sleep_us) ? wait : batch->sleep_us;
+                    rslt = bmm350_delay_us(wait, dev);
+                    elapsed += wait;
+                    sleep = false;
+                    slept = true;
+                    polls = 0;
+                }
+
+                if (rslt == BMM350_OK)
+                {
+                    rslt = bmm350_get_interrupt_status(&drdy, dev);
+                }
+
+                if ((rslt == BMM350_OK) && (drdy == BMM350_DISABLE))
+                {
+                    polls++;
+                    batch->empty_polls++;
+                    rslt = bmm350_delay_us(batch->poll_us, dev);
+                    elapsed += batch->poll_us;
+                }
+            }
+
+            if ((rslt == BMM350_OK) && (drdy == BMM350_ENABLE))
+            {
+                rslt = read_sample(block, batch, dev);
+
+                if (batch->wait_drdy == NULL)
+                {
+                    /* Only a sample polled after a sleep tells the phase; the first one of a call does not */
+                    if (slept)
+                    {
+                        adapt_sleep(polls, batch);
+                    }
+
+                    sleep = true;
+                }
+            }
+
+            if (batch->time_us != NULL)
+            {
+                elapsed = batch->time_us() - start;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
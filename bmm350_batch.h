@@ -0,0 +1,177 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_batch.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_BATCH_H
+#define _BMM350_BATCH_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Shortest polling step in us */
+#define BMM350_BATCH_MIN_POLL_US       UINT32_C(100)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Function pointer to wait for the data ready interrupt
+ *
+ * @param[in] timeout_us     : Longest wait in us
+ * @param[in] intf_ptr       : Interface pointer of the device
+ *
+ * @return true if data ready was signalled, false on timeout
+ */
+typedef bool (*bmm350_batch_wait_fptr_t)(uint32_t timeout_us, void *intf_ptr);
+
+/*!
+ * @brief Function pointer to read a host time in microseconds, used for the timeout
+ */
+typedef uint32_t (*bmm350_batch_time_us_fptr_t)(void);
+
+/*!
+ * @brief Structure to define a block of samples in structure of arrays layout.
+ * The arrays are provided by the application.
+ */
+struct bmm350_batch_block
+{
+    /*! Compensated x, y, z in uT and temperature in degC */
+    float *x;
+    float *y;
+    float *z;
+    float *temperature;
+
+    /*! Sensortime of each sample in ticks, extended beyond the 24-bit counter */
+    uint64_t *sensortime;
+
+    /*! Capacity of the arrays */
+    uint16_t capacity;
+
+    /*! Number of samples in the block */
+    uint16_t count;
+};
+
+/*!
+ * @brief Structure to define the state of the batch acquisition
+ */
+struct bmm350_batch
+{
+    /*! Data ready wait, NULL for phase-locked polling of INT_STATUS */
+    bmm350_batch_wait_fptr_t wait_drdy;
+
+    /*! Host time, NULL to count the timeout with the waits */
+    bmm350_batch_time_us_fptr_t time_us;
+
+    /*! Sample period in us and in sensortime ticks */
+    uint32_t period_us;
+    uint32_t period_ticks;
+
+    /*! Polling step and sleep from a sample to the first poll in us */
+    uint32_t poll_us;
+    uint32_t sleep_us;
+
+    /*! Sensortime extended beyond the 24-bit counter */
+    struct bmm350_timeline timeline;
+
+    /*! Samples read, samples missed according to the sensortime, and polls without data */
+    uint32_t sample_count;
+    uint32_t missed_count;
+    uint32_t empty_polls;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the batch acquisition for the configured ODR. The sensor has to be
+ * in normal mode with the data ready interrupt enabled.
+ *
+ * @param[in] odr            : Output data rate configured in the sensor
+ * @param[in] wait_drdy      : Data ready wait, NULL for phase-locked polling
+ * @param[in] time_us        : Host time, NULL to count the timeout with the waits
+ * @param[out] batch         : Structure that stores the state of the batch acquisition
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> ODR out of range
+ */
+int8_t bmm350_batch_init(enum bmm350_data_rates odr,
+                         bmm350_batch_wait_fptr_t wait_drdy,
+                         bmm350_batch_time_us_fptr_t time_us,
+                         struct bmm350_batch *batch);
+
+/*!
+ * @brief Function to block until n new samples are read or the timeout expires.
+ *
+ * @details Each sample is read with its sensortime in one burst. Without a data ready wait,
+ * INT_STATUS is polled: after a sample, the function sleeps until shortly before the next one
+ * is due and then polls every poll_us. The sleep adapts so that data ready falls between the
+ * first and the second poll, which keeps the bus traffic to about three reads per sample
+ * (an empty poll, the poll that sees data ready and the data burst).
+ *
+ * Gaps in the sensortime longer than 1.5 sample periods are counted in missed_count.
+ * Without time_us, the timeout is counted as the sum of the waits, bus time excluded.
+ *
+ * @param[out] block         : Samples; block->count is below n if the timeout expired
+ * @param[in] n              : Number of samples, at most block->capacity
+ * @param[in] timeout_us     : Timeout in us
+ * @param[in,out] batch      : Structure that stores the state of the batch acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success, also on timeout
+ *  @retval BMM350_E_INVALID_INPUT -> n larger than the capacity of the block
+ */
+int8_t bmm350_batch_read(struct bmm350_batch_block *block,
+                         uint16_t n,
+                         uint32_t timeout_us,
+                         struct bmm350_batch *batch,
+                         struct bmm350_dev *dev);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_BATCH_H */
@@ -0,0 +1,144 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_decimate.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_decimate.h"
+
+/*!
+ * @brief This internal API is used to clear the sum of the current window.
+ */
+static void clear_window(struct bmm350_decimate *dec)
+{
+    dec->count = 0;
+    dec->sum.raw_xdata = 0;
+    dec->sum.raw_ydata = 0;
+    dec->sum.raw_zdata = 0;
+    dec->sum.raw_data_t = 0;
+}
+
+/*!
+ * @brief This API is used to initialize the raw domain decimator.
+ */
+int8_t bmm350_decimate_init(uint16_t factor, struct bmm350_decimate *dec)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (dec != NULL)
+    {
+        if ((factor == 0) || (factor > BMM350_DECIMATE_MAX_FACTOR))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            dec->factor = factor;
+            dec->raw_count = 0;
+            dec->out_count = 0;
+            clear_window(dec);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to add a raw sample and compensate the window once it is complete.
+ */
+int8_t bmm350_decimate_push(const struct bmm350_raw_mag_data *raw_data,
+                            struct bmm350_mag_temp_data *mag_temp_data,
+                            bool *ready,
+                            struct bmm350_decimate *dec,
+                            const struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((raw_data != NULL) && (ready != NULL) && (dec != NULL))
+    {
+        *ready = false;
+
+        dec->sum.raw_xdata += raw_data->raw_xdata;
+        dec->sum.raw_ydata += raw_data->raw_ydata;
+        dec->sum.raw_zdata += raw_data->raw_zdata;
+        dec->sum.raw_data_t += raw_data->raw_data_t;
+        dec->count++;
+        dec->raw_count++;
+
+        if (dec->count >= dec->factor)
+        {
+            rslt = bmm350_compensate_raw_mag_temp_data(&dec->sum, dec->count, mag_temp_data, dev);
+
+            if (rslt == BMM350_OK)
+            {
+                dec->out_count++;
+                *ready = true;
+            }
+
+            clear_window(dec);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to read a raw sample and add it to the decimator.
+ */
+int8_t bmm350_decimate_read(struct bmm350_mag_temp_data *mag_temp_data,
+                            bool *ready,
+                            struct bmm350_decimate *dec,
+                            struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    struct bmm350_raw_mag_data raw_data = { 0 };
+
+    rslt = bmm350_read_uncomp_mag_temp_data(&raw_data, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_decimate_push(&raw_data, mag_temp_data, ready, dec, dev);
+    }
+
+    return rslt;
+}
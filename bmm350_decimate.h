@@ -0,0 +1,151 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_decimate.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_DECIMATE_H
+#define _BMM350_DECIMATE_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Largest decimation factor: the sum of 128 signed 24-bit samples fits in int32_t */
+#define BMM350_DECIMATE_MAX_FACTOR  UINT16_C(128)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the state of the raw domain decimator
+ */
+struct bmm350_decimate
+{
+    /*! Decimation factor */
+    uint16_t factor;
+
+    /*! Samples accumulated in the current window */
+    uint16_t count;
+
+    /*! Sum of the raw samples of the current window */
+    struct bmm350_raw_mag_data sum;
+
+    /*! Raw samples accumulated, and decimated samples compensated */
+    uint32_t raw_count;
+    uint32_t out_count;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the raw domain decimator.
+ *
+ * @param[in] factor         : Decimation factor, 1 to BMM350_DECIMATE_MAX_FACTOR
+ * @param[out] dec           : Structure that stores the state of the decimator
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Factor out of range
+ */
+int8_t bmm350_decimate_init(uint16_t factor, struct bmm350_decimate *dec);
+
+/*!
+ * @brief Function to add a raw sample and compensate the window once it is complete.
+ *
+ * @details The decimator is a boxcar (first order CIC) over factor samples. The raw samples are summed in
+ * integer arithmetic and only the average of a window goes through the float compensation, so the
+ * compensation cost drops by the decimation factor.
+ *
+ * Compensation is linear in the field at constant temperature and the compensated temperature is linear in
+ * the raw temperature, so at constant temperature the result equals compensate-then-decimate up to float
+ * rounding. With TCS and TCO the temperature coefficients of sensitivity and offset of an axis, B the field
+ * and dB, dT the peak to peak field and temperature over a window, the difference is bounded by
+ *
+ *@verbatim
+ * |e| <= |TCS| * (dB * dT + (|TCO| + |TCS| * |B|) * dT^2) / 4
+ *@endverbatim
+ *
+ * plus float rounding of a few ppm of the field, before the cross axis correction, which mixes the axes but
+ * keeps averages. Windows of tens of milliseconds see temperature steps of a few mK at most, which puts e far
+ * below the sensor noise. The bound assumes the raw temperature keeps its sign within a window, where the
+ * conversion to degC is discontinuous.
+ *
+ * @param[in] raw_data       : Raw sample, e.g. from bmm350_read_uncomp_mag_temp_data
+ * @param[out] mag_temp_data : Decimated and compensated sample, valid when ready is set
+ * @param[out] ready         : Flag set when a window was completed
+ * @param[in,out] dec        : Structure that stores the state of the decimator
+ * @param[in] dev            : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_decimate_push(const struct bmm350_raw_mag_data *raw_data,
+                            struct bmm350_mag_temp_data *mag_temp_data,
+                            bool *ready,
+                            struct bmm350_decimate *dec,
+                            const struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to read a raw sample and add it to the decimator, see bmm350_decimate_push.
+ *
+ * @param[out] mag_temp_data : Decimated and compensated sample, valid when ready is set
+ * @param[out] ready         : Flag set when a window was completed
+ * @param[in,out] dec        : Structure that stores the state of the decimator
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_decimate_read(struct bmm350_mag_temp_data *mag_temp_data,
+                            bool *ready,
+                            struct bmm350_decimate *dec,
+                            struct bmm350_dev *dev);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_DECIMATE_H */
@@ -160,10 +160,52 @@
 #define BMM350_BR_DELAY                             UINT16_C(14000)
 #define BMM350_FGR_DELAY                            UINT16_C(18000)
 
+#define BMM350_BR_FAST_DELAY                        UINT16_C(4000)
+#define BMM350_FGR_FAST_DELAY                       UINT16_C(5000)
+
 /************************ Length macros ************************/
 #define BMM350_OTP_DATA_LENGTH                      UINT8_C(32)
 #define BMM350_READ_BUFFER_LENGTH                   UINT8_C(127)
 #define BMM350_MAG_TEMP_DATA_LEN                    UINT8_C(12)
+#define BMM350_MAG_TEMP_SENSORTIME_DATA_LEN         UINT8_C(15)
+#define BMM350_STATUS_MAG_TEMP_SENSORTIME_DATA_LEN  UINT8_C(16)
+
+/*! Register snapshot covers the addresses 0x00 to 0x61 */
+#define BMM350_SNAPSHOT_REG_LEN                     UINT8_C(0x62)
+
+/*! Bursts of the snapshot read and of the restore write */
+#define BMM350_SNAPSHOT_READ_BURSTS                 UINT8_C(4)
+#define BMM350_SNAPSHOT_WRITE_BURSTS                UINT8_C(4)
+
+/************************ Event log macros **********************/
+/*! Event types */
+#define BMM350_EVENT_ERROR                          UINT8_C(1)
+#define BMM350_EVENT_PMU_STATUS                     UINT8_C(2)
+#define BMM350_EVENT_RESET                          UINT8_C(3)
+#define BMM350_EVENT_OOR                            UINT8_C(4)
+#define BMM350_EVENT_RETRY                          UINT8_C(5)
+#define BMM350_EVENT_CONFIG                         UINT8_C(6)
+
+/*! Flags in the upper byte of the argument of a PMU status event */
+#define BMM350_EVENT_PMU_BUSY                       UINT8_C(0x01)
+#define BMM350_EVENT_PMU_ODR_OVWR                   UINT8_C(0x02)
+#define BMM350_EVENT_PMU_AVG_OVWR                   UINT8_C(0x04)
+#define BMM350_EVENT_PMU_NORMAL                     UINT8_C(0x08)
+#define BMM350_EVENT_PMU_ILLEGAL                    UINT8_C(0x10)
+
+/*! Size of an event in a little-endian dump of the log */
+#define BMM350_EVENT_LEN                            UINT8_C(12)
+
+/*! Memory barrier between the accesses to the event log entries and to head. The default only
+ * orders them in the compiler, which is enough when the reader and the driver run on one core.
+ * Define it as a hardware barrier (e.g. __DMB()) when they run on different cores. */
+#ifndef BMM350_EVENT_LOG_BARRIER
+#if defined(__GNUC__)
+#define BMM350_EVENT_LOG_BARRIER()                  __asm__ __volatile__ ("" ::: "memory")
+#else
+#define BMM350_EVENT_LOG_BARRIER()
+#endif
+#endif
 
 /************************ Averaging macros **********************/
 #define BMM350_AVG_NO_AVG                           UINT8_C(0x0)
@@ -182,6 +224,20 @@
 #define BMM350_ODR_3_125HZ                          UINT8_C(0x9)
 #define BMM350_ODR_1_5625HZ                         UINT8_C(0xA)
 
+/*! Rate of the ODR setting 0 in Hz: ODR = 1600Hz / 2^odr */
+#define BMM350_ODR_BASE_HZ                          (1600.0f)
+
+/*! Nominal RMS noise without averaging in uT. Averaging over N samples divides the variance by N. */
+#define BMM350_NOISE_XY_NO_AVG_UT                   (0.54f)
+#define BMM350_NOISE_Z_NO_AVG_UT                    (0.74f)
+
+/*! Sample period of the ODR setting 0: period = 625us * 2^odr = 16 sensortime ticks * 2^odr */
+#define BMM350_ODR_PERIOD_BASE_US                   UINT32_C(625)
+#define BMM350_ODR_PERIOD_BASE_TICKS                UINT32_C(16)
+
+/*! Width of the sensortime counter */
+#define BMM350_SENSORTIME_MASK                      UINT32_C(0xFFFFFF)
+
 /********************* Power modes *************************/
 #define BMM350_PMU_CMD_SUS                          UINT8_C(0x00)
 #define BMM350_PMU_CMD_NM                           UINT8_C(0x01)
@@ -757,6 +813,7 @@
 #define BMM350_PMU_CMD_STATUS_0_FGR_FAST            UINT8_C(0x06)
 #define BMM350_PMU_CMD_STATUS_0_BR                  UINT8_C(0x07)
 #define BMM350_PMU_CMD_STATUS_0_BR_FAST             UINT8_C(0x07)
+#define BMM350_PMU_CMD_STATUS_0_NM_TC               UINT8_C(0x01)
 
 /****************************** Enumerators ***************************/
 enum bmm350_interrupt_enable_disable {
@@ -768,7 +825,8 @@ enum bmm350_power_modes {
     BMM350_SUSPEND_MODE = BMM350_PMU_CMD_SUS,
     BMM350_NORMAL_MODE = BMM350_PMU_CMD_NM,
     BMM350_FORCED_MODE = BMM350_PMU_CMD_FM,
-    BMM350_FORCED_MODE_FAST = BMM350_PMU_CMD_FM_FAST
+    BMM350_FORCED_MODE_FAST = BMM350_PMU_CMD_FM_FAST,
+    BMM350_NORMAL_MODE_TC = BMM350_PMU_CMD_NM_TC
 };
 
 enum bmm350_data_rates {
@@ -941,6 +999,34 @@ typedef BMM350_INTF_RET_TYPE (*bmm350_write_fptr_t)(uint8_t reg_addr, const uint
  */
 typedef void (*bmm350_delay_us_fptr_t)(uint32_t period, void *intf_ptr);
 
+/*!
+ * @brief Bus lock function pointer which should be mapped to the
+ * platform specific bus arbitration, e.g. a mutex shared by all users of the bus.
+ * The lock is held for every bus transaction and across read-modify-write sequences.
+ *
+ * @param[out] wait_us      : Time spent waiting for the bus in microseconds, 0 if the bus was free.
+ * @param[in, out] intf_ptr : Void pointer that can enable the linking of descriptors
+ *                            for interface related call backs
+ *
+ * retval = 0 -> Success
+ * retval < 0 -> Failure
+ *
+ */
+typedef BMM350_INTF_RET_TYPE (*bmm350_bus_lock_fptr_t)(uint32_t *wait_us, void *intf_ptr);
+
+/*!
+ * @brief Bus unlock function pointer which should be mapped to the
+ * platform specific bus arbitration
+ *
+ * @param[in, out] intf_ptr : Void pointer that can enable the linking of descriptors
+ *                            for interface related call backs
+ *
+ * retval = 0 -> Success
+ * retval < 0 -> Failure
+ *
+ */
+typedef BMM350_INTF_RET_TYPE (*bmm350_bus_unlock_fptr_t)(void *intf_ptr);
+
 /* Pre-declaration */
 struct bmm350_dev;
 
@@ -954,6 +1040,37 @@ struct bmm350_dev;
  */
 typedef int8_t (*bmm350_mraw_override_t)(struct bmm350_dev *dev);
 
+/*!
+ * @brief Function pointer for a sequence override (soft-reset, OTP dump, self-test entry)
+ *
+ * @param[in,out]  dev          : Structure instance of bmm350_dev.
+ * @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+typedef int8_t (*bmm350_seq_override_t)(struct bmm350_dev *dev);
+
+/*!
+ * @brief Function pointer for a power mode sequence override (power transition, forced trigger)
+ *
+ * @param[in]      powermode    : Target power mode.
+ * @param[in,out]  dev          : Structure instance of bmm350_dev.
+ * @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+typedef int8_t (*bmm350_powermode_override_t)(enum bmm350_power_modes powermode, struct bmm350_dev *dev);
+
+/*!
+ * @brief Host time function pointer of the event log
+ *
+ * @param[in, out] intf_ptr : Void pointer that can enable the linking of descriptors
+ *                            for interface related call backs
+ *
+ * @return Free running host time in microseconds
+ */
+typedef uint32_t (*bmm350_event_time_fptr_t)(void *intf_ptr);
+
 /*************************  STRUCTURE DEFINITIONS *************************/
 
 /*!
@@ -1083,6 +1200,101 @@ struct bmm350_mag_compensate
     struct bmm350_cross_axis cross_axis;
 };
 
+/*!
+ * @brief bmm350 bus arbitration statistics structure
+ */
+struct bmm350_bus_stats
+{
+    /*! Number of times the bus was locked */
+    uint32_t lock_count;
+
+    /*! Number of locks that had to wait for another bus user */
+    uint32_t contended_count;
+
+    /*! Total time spent waiting for the bus in us */
+    uint32_t wait_time_us;
+
+    /*! Longest wait for the bus in us */
+    uint32_t max_wait_us;
+};
+
+/*!
+ * @brief bmm350 diagnostic event
+ *
+ * The argument depends on the type:
+ * - ERROR: register or OTP address of the failed access, chip id for BMM350_E_DEV_NOT_FOUND,
+ *   PMU status as for PMU_STATUS events for BMM350_E_PMU_CMD_VALUE
+ * - PMU_STATUS: PMU_CMD_VALUE in the lower byte, BMM350_EVENT_PMU_* flags in the upper byte
+ * - RESET: BMM350_CMD_SOFTRESET or the PMU command of the magnetic reset
+ * - OOR: 1 when the sensor went out of range, 0 when it came back in range
+ * - RETRY: attempt number in the lower byte, set by the caller
+ * - CONFIG: register address in the lower byte, value written in the upper byte
+ */
+struct bmm350_event
+{
+    /*! Host time in us, 0 if the log has no time callback */
+    uint32_t host_time_us;
+
+    /*! Last sensortime read by the driver, 24 bits */
+    uint32_t sensortime;
+
+    /*! Event type, BMM350_EVENT_* */
+    uint8_t type;
+
+    /*! Result code, BMM350_OK or BMM350_E_* */
+    int8_t code;
+
+    /*! Type specific argument */
+    uint16_t arg;
+};
+
+/*!
+ * @brief bmm350 diagnostic event log
+ *
+ * Fixed-size ring on application storage. The driver is the only writer: an event is stored
+ * and then published by incrementing head, without locks and without formatting.
+ * The oldest events are overwritten when the ring is full.
+ */
+struct bmm350_event_log
+{
+    /*! Event storage */
+    struct bmm350_event *entries;
+
+    /*! Number of entries, a power of two */
+    uint16_t capacity;
+
+    /*! Number of events written since init */
+    volatile uint32_t head;
+
+    /*! Last sensortime read by the driver */
+    uint32_t sensortime;
+
+    /*! Host time function pointer, optional */
+    bmm350_event_time_fptr_t time_us;
+};
+
+/*!
+ * @brief bmm350 sequence override table. A NULL entry runs the built-in sequence,
+ * so a zeroed table keeps the default behaviour.
+ */
+struct bmm350_seq_overrides
+{
+    /*! Soft-reset command and wait, used by bmm350_init and bmm350_soft_reset */
+    bmm350_seq_override_t soft_reset;
+
+    /*! Read of the OTP words into dev->otp_data; variant and compensation are derived afterwards */
+    bmm350_seq_override_t otp_dump;
+
+    /*! Transition from suspend to suspend, normal or normal TC mode, including wait and check */
+    bmm350_powermode_override_t power_transition;
+
+    /*! Trigger of a forced or forced fast measurement from suspend, without waiting for the conversion */
+    bmm350_powermode_override_t forced_trigger;
+
+    /*! Self-test entry configuration */
+    bmm350_seq_override_t self_test_entry;
+};
+
 /*!
  * @brief bmm350 device structure
  */
@@ -1125,6 +1337,24 @@ struct bmm350_dev
 
     /*! Magnetic reset and wait override */
     bmm350_mraw_override_t mraw_override;
+
+    /*! Sequence overrides */
+    struct bmm350_seq_overrides seq_override;
+
+    /*! Bus lock function pointer, optional */
+    bmm350_bus_lock_fptr_t bus_lock;
+
+    /*! Bus unlock function pointer, optional */
+    bmm350_bus_unlock_fptr_t bus_unlock;
+
+    /*! Nesting depth of the bus lock */
+    uint8_t bus_lock_depth;
+
+    /*! Bus arbitration statistics */
+    struct bmm350_bus_stats bus_stats;
+
+    /*! Diagnostic event log, optional */
+    struct bmm350_event_log *event_log;
 };
 
 /*!
@@ -1163,4 +1393,108 @@ struct bmm350_pmu_cmd_status_0
     uint8_t pmu_cmd_value;
 };
 
+/*!
+ * @brief bmm350 register snapshot structure
+ */
+struct bmm350_reg_snapshot
+{
+    /*! Register values indexed by register address, undocumented addresses are 0 */
+    uint8_t regs[BMM350_SNAPSHOT_REG_LEN];
+
+    /*! Chip id and revision id */
+    uint8_t chip_id;
+    uint8_t rev_id;
+
+    /*! Error register: PMU command error and boot up error */
+    uint8_t pmu_cmd_error;
+    uint8_t boot_up_error;
+
+    /*! Pad drive strength */
+    uint8_t pad_drive;
+
+    /*! ODR and averaging set in PMU_CMD_AGGR_SET */
+    uint8_t odr;
+    uint8_t avg;
+
+    /*! Enabled axes */
+    uint8_t axis_en;
+
+    /*! Last PMU command written */
+    uint8_t pmu_cmd;
+
+    /*! PMU command status 0 */
+    struct bmm350_pmu_cmd_status_0 pmu_cmd_stat_0;
+
+    /*! ODR and averaging in use, from PMU_CMD_STATUS_1 */
+    uint8_t pmu_odr_s;
+    uint8_t pmu_avg_s;
+
+    /*! I2C watchdog enable and timeout select */
+    uint8_t i2c_wdt_en;
+    uint8_t i2c_wdt_sel;
+
+    /*! Interrupt control: mode, polarity, open drain, output enable and data ready enable */
+    uint8_t int_mode;
+    uint8_t int_pol;
+    uint8_t int_od;
+    uint8_t int_output_en;
+    uint8_t drdy_data_reg_en;
+
+    /*! IBI control: data ready mapped to IBI and clear status upon IBI */
+    uint8_t drdy_int_map_to_ibi;
+    uint8_t clear_drdy_int_status_upon_ibi;
+
+    /*! Data ready status */
+    uint8_t drdy_status;
+
+    /*! Raw mag and temperature data */
+    struct bmm350_raw_mag_data raw_data;
+
+    /*! Sensortime */
+    uint32_t sensortime;
+
+    /*! OTP status error */
+    uint8_t otp_status_error;
+
+    /*! Self-test user: current generator, negative and positive polarity, x and y enable */
+    uint8_t st_igen_en;
+    uint8_t st_n;
+    uint8_t st_p;
+    uint8_t ist_en_x;
+    uint8_t ist_en_y;
+
+    /*! Sensortime always on */
+    uint8_t cfg_sens_tim_aon;
+};
+
+/*!
+ * @brief bmm350 sensortime extended beyond the 24-bit counter
+ */
+struct bmm350_timeline
+{
+    /*! Extended sensortime of the last sample in ticks */
+    uint64_t ticks;
+
+    /*! Raw 24-bit sensortime of the last sample */
+    uint32_t last_sensortime;
+
+    /*! Number of sensortime counter wrap-arounds observed */
+    uint32_t wrap_count;
+
+    /*! Set once the timeline has been started by a first sample */
+    uint8_t started;
+};
+
+/*!
+ * @brief bmm350 mag and temperature data stamped with the sensor timeline
+ */
+struct bmm350_timed_mag_temp_data
+{
+    /*! Compensated mag and temperature data */
+    struct bmm350_mag_temp_data data;
+
+    /*! Sensortime of the conversion in ticks, extended beyond the 24-bit counter */
+    uint64_t sensortime;
+};
+
 #endif /* _BMM350_DEFS_H */
@@ -0,0 +1,461 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_dipole.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_dipole.h"
+
+/*!
+ * @brief This internal API is used to copy a solution into a parameter vector.
+ */
+static void state_to_params(const struct bmm350_dipole_state *state, float *params)
+{
+    uint8_t indx;
+
+    for (indx = 0; indx < 3; indx++)
+    {
+        params[indx] = state->pos[indx];
+        params[indx + 3] = state->moment[indx];
+        params[indx + 6] = state->background[indx];
+    }
+}
+
+/*!
+ * @brief This internal API is used to copy a parameter vector into a solution.
+ */
+static void params_to_state(const float *params, struct bmm350_dipole_state *state)
+{
+    uint8_t indx;
+
+    for (indx = 0; indx < 3; indx++)
+    {
+        state->pos[indx] = params[indx];
+        state->moment[indx] = params[indx + 3];
+        state->background[indx] = params[indx + 6];
+    }
+}
+
+/*!
+ * @brief This internal API is used to evaluate the cost of a parameter vector and, if jtj is not
+ * NULL, the normal equations J^T J and J^T r. Returns false if the dipole is at a sensor.
+ */
+static bool evaluate(const float *params,
+                     const float *meas,
+                     float *cost,
+                     float (*jtj)[BMM350_DIPOLE_PARAMS_BACKGROUND],
+                     float *jtr,
+                     const struct bmm350_dipole *dipole)
+{
+    uint8_t sensor, row, col, par;
+    float d[3], dist2, inv_r3, inv_r5, md, model, resid;
+    float jac[3][BMM350_DIPOLE_PARAMS_BACKGROUND];
+    bool valid = true;
+
+    *cost = 0.0f;
+
+    if (jtj != NULL)
+    {
+        for (row = 0; row < dipole->n_params; row++)
+        {
+            jtr[row] = 0.0f;
+
+            for (col = 0; col < dipole->n_params; col++)
+            {
+                jtj[row][col] = 0.0f;
+            }
+        }
+    }
+
+    for (sensor = 0; (sensor < dipole->n_sensors) && valid; sensor++)
+    {
+        for (row = 0; row < 3; row++)
+        {
+            d[row] = dipole->sensor_pos[sensor][row] - params[row];
+        }
+
+        dist2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+        if (dist2 < (BMM350_DIPOLE_MIN_DISTANCE * BMM350_DIPOLE_MIN_DISTANCE))
+        {
+            valid = false;
+        }
+        else
+        {
+            inv_r3 = BMM350_DIPOLE_MU0_4PI / (dist2 * sqrtf(dist2));
+            inv_r5 = inv_r3 / dist2;
+            md = params[3] * d[0] + params[4] * d[1] + params[5] * d[2];
+
+            for (row = 0; row < 3; row++)
+            {
+                /* B = k * (3 (m.d) d / r^5 - m / r^3) + background */
+                model = 3.0f * md * d[row] * inv_r5 - params[row + 3] * inv_r3;
+
+                if (dipole->n_params == BMM350_DIPOLE_PARAMS_BACKGROUND)
+                {
+                    model += params[row + 6];
+                }
+
+                resid = model - meas[sensor * 3 + row];
+                *cost += resid * resid;
+
+                if (jtj != NULL)
+                {
+                    for (col = 0; col < 3; col++)
+                    {
+                        /* dB/dd is symmetric, dB/dp = -dB/dd */
+                        jac[row][col] = -(3.0f * inv_r5 *
+                                          (params[col + 3] * d[row] + params[row + 3] * d[col] +
+                                           ((row == col) ? md : 0.0f)) -
+                                          15.0f * md * d[row] * d[col] * inv_r5 / dist2);
+
+                        /* dB/dm */
+                        jac[row][col + 3] = 3.0f * d[row] * d[col] * inv_r5 - ((row == col) ? inv_r3 : 0.0f);
+
+                        /* dB/dbackground */
+                        jac[row][col + 6] = (row == col) ? 1.0f : 0.0f;
+                    }
+
+                    for (par = 0; par < dipole->n_params; par++)
+                    {
+                        jtr[par] += jac[row][par] * resid;
+
+                        for (col = 0; col <= par; col++)
+                        {
+                            jtj[par][col] += jac[row][par] * jac[row][col];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief This internal API is used to solve the damped normal equations with a Cholesky
+ * decomposition. Only the lower triangle of jtj is used. Returns false if not positive definite.
+ */
+static bool solve_step(float (*jtj)[BMM350_DIPOLE_PARAMS_BACKGROUND],
+                       const float *jtr,
+                       float lambda,
+                       uint8_t n_params,
+                       float *step)
+{
+    float chol[BMM350_DIPOLE_PARAMS_BACKGROUND][BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float sum;
+    uint8_t row, col, indx;
+    bool valid = true;
+
+    for (row = 0; (row < n_params) && valid; row++)
+    {
+        for (col = 0; col <= row; col++)
+        {
+            sum = jtj[row][col];
+
+            if (row == col)
+            {
+                /* Marquardt scaling of the diagonal */
+                sum += lambda * jtj[row][row] + 1e-12f;
+            }
+
+            for (indx = 0; indx < col; indx++)
+            {
+                sum -= chol[row][indx] * chol[col][indx];
+            }
+
+            if (row == col)
+            {
+                if (sum <= 0.0f)
+                {
+                    valid = false;
+                }
+                else
+                {
+                    chol[row][row] = sqrtf(sum);
+                }
+            }
+            else
+            {
+                chol[row][col] = sum / chol[col][col];
+            }
+        }
+    }
+
+    if (valid)
+    {
+        /* Forward substitution L y = -J^T r */
+        for (row = 0; row < n_params; row++)
+        {
+            sum = -jtr[row];
+
+            for (indx = 0; indx < row; indx++)
+            {
+                sum -= chol[row][indx] * step[indx];
+            }
+
+            step[row] = sum / chol[row][row];
+        }
+
+        /* Back substitution L^T x = y */
+        for (row = n_params; row > 0; row--)
+        {
+            sum = step[row - 1];
+
+            for (indx = row; indx < n_params; indx++)
+            {
+                sum -= chol[indx][row - 1] * step[indx];
+            }
+
+            step[row - 1] = sum / chol[row - 1][row - 1];
+        }
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief This internal API is used to fit one frame starting from the current guess.
+ */
+static void solve_frame(const float *meas, struct bmm350_dipole_state *solution, struct bmm350_dipole *dipole)
+{
+    float params[BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float trial[BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float step[BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float jtj[BMM350_DIPOLE_PARAMS_BACKGROUND][BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float jtr[BMM350_DIPOLE_PARAMS_BACKGROUND];
+    float cost, trial_cost, start_cost;
+    float lambda = dipole->lambda_init;
+    uint8_t iter, indx;
+    bool valid, converged = false, linearized = true;
+
+    state_to_params(&dipole->guess, params);
+    valid = evaluate(params, meas, &cost, jtj, jtr, dipole);
+    start_cost = cost;
+
+    for (iter = 0; (iter < dipole->max_iter) && valid && !converged; iter++)
+    {
+        if (!linearized)
+        {
+            (void)evaluate(params, meas, &cost, jtj, jtr, dipole);
+            linearized = true;
+        }
+
+        if (solve_step(jtj, jtr, lambda, dipole->n_params, step))
+        {
+            for (indx = 0; indx < BMM350_DIPOLE_PARAMS_BACKGROUND; indx++)
+            {
+                trial[indx] = params[indx] + ((indx < dipole->n_params) ? step[indx] : 0.0f);
+            }
+
+            if (evaluate(trial, meas, &trial_cost, NULL, NULL, dipole) && (trial_cost < cost))
+            {
+                converged = ((cost - trial_cost) <= (dipole->tol * cost));
+
+                for (indx = 0; indx < BMM350_DIPOLE_PARAMS_BACKGROUND; indx++)
+                {
+                    params[indx] = trial[indx];
+                }
+
+                cost = trial_cost;
+                lambda *= 0.1f;
+                linearized = false;
+            }
+            else
+            {
+                /* Rejected: keep the linearization, increase the damping */
+                lambda *= 10.0f;
+            }
+        }
+        else
+        {
+            lambda *= 10.0f;
+        }
+    }
+
+    if (!valid)
+    {
+        /* Start point at a sensor: report the previous solution unchanged */
+        *solution = dipole->guess;
+        solution->cost = INFINITY;
+        solution->converged = false;
+    }
+    else
+    {
+        params_to_state(params, solution);
+        solution->cost = cost;
+        solution->converged = converged;
+
+        /* Warm start the next frame unless the fit got worse than its start */
+        if (cost <= start_cost)
+        {
+            dipole->guess = *solution;
+        }
+    }
+
+    solution->iterations = iter;
+    dipole->frame_count++;
+    dipole->iteration_count += iter;
+
+    if (solution->converged)
+    {
+        dipole->converged_count++;
+    }
+}
+
+/*!
+ * @brief This API is used to initialize the dipole solver.
+ */
+int8_t bmm350_dipole_init(const float (*positions)[3],
+                          uint8_t n_sensors,
+                          bool fit_background,
+                          struct bmm350_dipole *dipole)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t sensor, indx;
+    uint8_t n_params = fit_background ? BMM350_DIPOLE_PARAMS_BACKGROUND : BMM350_DIPOLE_PARAMS;
+
+    if ((positions != NULL) && (dipole != NULL))
+    {
+        if ((n_sensors > BMM350_DIPOLE_MAX_SENSORS) || ((n_sensors * 3) < n_params))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            for (sensor = 0; sensor < n_sensors; sensor++)
+            {
+                for (indx = 0; indx < 3; indx++)
+                {
+                    dipole->sensor_pos[sensor][indx] = positions[sensor][indx];
+                }
+            }
+
+            dipole->n_sensors = n_sensors;
+            dipole->n_params = n_params;
+            dipole->max_iter = BMM350_DIPOLE_DEFAULT_MAX_ITER;
+            dipole->tol = BMM350_DIPOLE_DEFAULT_TOL;
+            dipole->lambda_init = BMM350_DIPOLE_DEFAULT_LAMBDA;
+            dipole->frame_count = 0;
+            dipole->converged_count = 0;
+            dipole->iteration_count = 0;
+
+            for (indx = 0; indx < 3; indx++)
+            {
+                dipole->guess.pos[indx] = 0.0f;
+                dipole->guess.moment[indx] = 0.0f;
+                dipole->guess.background[indx] = 0.0f;
+            }
+
+            /* Default start: below the array centroid, moment along z */
+            for (sensor = 0; sensor < n_sensors; sensor++)
+            {
+                for (indx = 0; indx < 3; indx++)
+                {
+                    dipole->guess.pos[indx] += positions[sensor][indx] / (float)n_sensors;
+                }
+            }
+
+            dipole->guess.pos[2] -= 0.1f;
+            dipole->guess.moment[2] = 0.1f;
+            dipole->guess.cost = 0.0f;
+            dipole->guess.iterations = 0;
+            dipole->guess.converged = false;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to set the start point of the next frame.
+ */
+int8_t bmm350_dipole_set_guess(const struct bmm350_dipole_state *guess, struct bmm350_dipole *dipole)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((guess != NULL) && (dipole != NULL))
+    {
+        dipole->guess = *guess;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to fit the dipole model to a batch of frames.
+ */
+int8_t bmm350_dipole_solve_batch(const float *field,
+                                 uint16_t n_frames,
+                                 struct bmm350_dipole_state *solution,
+                                 struct bmm350_dipole *dipole)
+{
+    int8_t rslt = BMM350_OK;
+    float meas[BMM350_DIPOLE_MAX_SENSORS * 3];
+    uint16_t frame;
+    uint8_t sensor, axis;
+
+    if ((field != NULL) && (solution != NULL) && (dipole != NULL))
+    {
+        for (frame = 0; frame < n_frames; frame++)
+        {
+            /* Gather the frame into sensor-major order */
+            for (axis = 0; axis < 3; axis++)
+            {
+                for (sensor = 0; sensor < dipole->n_sensors; sensor++)
+                {
+                    meas[sensor * 3 + axis] = field[(axis * dipole->n_sensors + sensor) * n_frames + frame];
+                }
+            }
+
+            solve_frame(meas, &solution[frame], dipole);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,196 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_dipole.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_DIPOLE_H
+#define _BMM350_DIPOLE_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Maximum number of sensors in the array */
+#define BMM350_DIPOLE_MAX_SENSORS         UINT8_C(16)
+
+/*! Number of fitted parameters: position and moment, plus background field if enabled */
+#define BMM350_DIPOLE_PARAMS              UINT8_C(6)
+#define BMM350_DIPOLE_PARAMS_BACKGROUND   UINT8_C(9)
+
+/*! mu0 / (4 * pi) in uT * m^3 / (A * m^2) */
+#define BMM350_DIPOLE_MU0_4PI             (0.1f)
+
+/*! Default iteration budget per frame */
+#define BMM350_DIPOLE_DEFAULT_MAX_ITER    UINT8_C(10)
+
+/*! Default relative cost decrease below which a frame is converged */
+#define BMM350_DIPOLE_DEFAULT_TOL         (1e-4f)
+
+/*! Default initial damping */
+#define BMM350_DIPOLE_DEFAULT_LAMBDA      (1e-3f)
+
+/*! Minimum distance between the dipole and a sensor in m */
+#define BMM350_DIPOLE_MIN_DISTANCE        (1e-3f)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define a dipole solution
+ */
+struct bmm350_dipole_state
+{
+    /*! Dipole position in m, in the frame of the sensor positions */
+    float pos[3];
+
+    /*! Dipole moment in A * m^2 */
+    float moment[3];
+
+    /*! Uniform background field in uT, zero if not fitted */
+    float background[3];
+
+    /*! Sum of squared residuals in uT^2 */
+    float cost;
+
+    /*! Iterations used */
+    uint8_t iterations;
+
+    /*! Flag set if the relative cost decrease fell below the tolerance within the budget */
+    bool converged;
+};
+
+/*!
+ * @brief Structure to define the state of the dipole solver
+ */
+struct bmm350_dipole
+{
+    /*! Number of sensors */
+    uint8_t n_sensors;
+
+    /*! Sensor positions in m */
+    float sensor_pos[BMM350_DIPOLE_MAX_SENSORS][3];
+
+    /*! Number of fitted parameters */
+    uint8_t n_params;
+
+    /*! Iteration budget per frame */
+    uint8_t max_iter;
+
+    /*! Convergence tolerance on the relative cost decrease */
+    float tol;
+
+    /*! Initial damping of each frame */
+    float lambda_init;
+
+    /*! Solution of the last frame, used as start of the next frame */
+    struct bmm350_dipole_state guess;
+
+    /*! Statistics: frames solved, frames converged and iterations used */
+    uint32_t frame_count;
+    uint32_t converged_count;
+    uint32_t iteration_count;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the dipole solver for sensors at known positions.
+ *
+ * @param[in] positions      : Sensor positions in m, n_sensors entries
+ * @param[in] n_sensors      : Number of sensors, up to BMM350_DIPOLE_MAX_SENSORS
+ * @param[in] fit_background : Fit a uniform background field in addition to the dipole
+ * @param[out] dipole        : Structure that stores the state of the solver
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Fewer measurements than parameters or too many sensors
+ */
+int8_t bmm350_dipole_init(const float (*positions)[3],
+                          uint8_t n_sensors,
+                          bool fit_background,
+                          struct bmm350_dipole *dipole);
+
+/*!
+ * @brief Function to set the start point of the next frame, e.g. when a target enters the array.
+ *
+ * @param[in] guess          : Start position, moment and background
+ * @param[in,out] dipole     : Structure that stores the state of the solver
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_dipole_set_guess(const struct bmm350_dipole_state *guess, struct bmm350_dipole *dipole);
+
+/*!
+ * @brief Function to fit the dipole model to a batch of synchronized frames with Levenberg-Marquardt.
+ *
+ * @details The field buffer uses the layout of the gradient stage:
+ * field[(axis * n_sensors + sensor) * n_frames + frame] in uT.
+ *
+ * Each frame starts from the solution of the previous frame and runs at most max_iter
+ * iterations, each one Jacobian evaluation, one solve of the normal equations and one trial
+ * evaluation, so the cost per frame is bounded. A frame whose fit gets worse than its start
+ * keeps the previous solution as start for the next frame.
+ *
+ * @param[in] field          : Field of all sensors for n_frames frames
+ * @param[in] n_frames       : Number of frames
+ * @param[out] solution      : Solution of each frame, n_frames entries
+ * @param[in,out] dipole     : Structure that stores the state of the solver
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_dipole_solve_batch(const float *field,
+                                 uint16_t n_frames,
+                                 struct bmm350_dipole_state *solution,
+                                 struct bmm350_dipole *dipole);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_DIPOLE_H */
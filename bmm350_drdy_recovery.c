@@ -0,0 +1,219 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_drdy_recovery.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_drdy_recovery.h"
+
+/*!
+ * @brief This internal API is used to read status and sample in one burst and extend the sensortime.
+ *
+ * @param[out] timed_data    : Sample stamped with the extended sensortime
+ * @param[out] drdy          : Data ready status; the sample is only taken if set
+ * @param[in,out] rec        : Structure that stores the state of the acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ * @return Result of API execution status
+ */
+static int8_t read_sample(struct bmm350_timed_mag_temp_data *timed_data,
+                          uint8_t *drdy,
+                          struct bmm350_drdy_recovery *rec,
+                          struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    uint32_t sensortime = 0;
+    uint32_t missed = 0;
+
+    rslt = bmm350_get_status_compensated_mag_xyz_temp_sensortime(drdy, &timed_data->data, &sensortime, dev);
+
+    if ((rslt == BMM350_OK) && (*drdy == BMM350_ENABLE))
+    {
+        rslt = bmm350_extend_sensortime(sensortime, rec->period_ticks, &missed, &rec->timeline);
+        rec->stats.missed_samples += missed;
+        timed_data->sensortime = rec->timeline.ticks;
+        rec->stats.sample_count++;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to initialize the interrupt driven acquisition.
+ */
+int8_t bmm350_drdy_recovery_init(enum bmm350_data_rates odr,
+                                 enum bmm350_intr_latch latching,
+                                 uint32_t now_us,
+                                 struct bmm350_drdy_recovery *rec)
+{
+    int8_t rslt = BMM350_OK;
+    struct bmm350_drdy_recovery_stats stats = { 0 };
+    uint32_t margin;
+
+    if (rec != NULL)
+    {
+        if ((odr < BMM350_DATA_RATE_400HZ) || (odr > BMM350_DATA_RATE_1_5625HZ))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            rec->latching = latching;
+            rec->period_us = BMM350_ODR_PERIOD_BASE_US << odr;
+            rec->period_ticks = BMM350_ODR_PERIOD_BASE_TICKS << odr;
+
+            margin = rec->period_us / BMM350_DRDY_TIMEOUT_DIV;
+            if (margin < BMM350_DRDY_MIN_MARGIN_US)
+            {
+                margin = BMM350_DRDY_MIN_MARGIN_US;
+            }
+
+            rec->timeout_us = rec->period_us + margin;
+            rec->isr_edges = 0;
+            rec->handled_edges = 0;
+            rec->last_us = now_us;
+            rec->timeline.started = 0;
+            rec->stats = stats;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to count a data ready edge from the interrupt handler.
+ */
+void bmm350_drdy_recovery_isr(struct bmm350_drdy_recovery *rec)
+{
+    if (rec != NULL)
+    {
+        rec->isr_edges++;
+    }
+}
+
+/*!
+ * @brief This API is used to read a sample after a data ready edge or an edge timeout.
+ */
+int8_t bmm350_drdy_recovery_poll(uint32_t now_us,
+                                 struct bmm350_timed_mag_temp_data *timed_data,
+                                 bool *ready,
+                                 struct bmm350_drdy_recovery *rec,
+                                 struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t edges;
+    uint8_t drdy = BMM350_DISABLE;
+
+    if ((timed_data != NULL) && (ready != NULL) && (rec != NULL))
+    {
+        *ready = false;
+
+        /* Single writer in the handler: a snapshot is enough */
+        edges = rec->isr_edges;
+
+        if (edges != rec->handled_edges)
+        {
+            rec->stats.edge_count += edges - rec->handled_edges;
+            rec->handled_edges = edges;
+
+            rslt = read_sample(timed_data, &drdy, rec, dev);
+
+            if ((rslt == BMM350_OK) && (drdy == BMM350_DISABLE))
+            {
+                /* The sample of this edge was taken on a timeout before the handler ran */
+                rec->stats.late_edges++;
+            }
+        }
+        else if ((now_us - rec->last_us) >= rec->timeout_us)
+        {
+            rslt = read_sample(timed_data, &drdy, rec, dev);
+
+            if (rslt == BMM350_OK)
+            {
+                if (drdy == BMM350_DISABLE)
+                {
+                    rec->stats.empty_timeouts++;
+                }
+                else if (rec->latching == BMM350_LATCHED)
+                {
+                    rec->stats.stuck_lines++;
+                }
+                else
+                {
+                    rec->stats.missed_edges++;
+                }
+
+                /* Re-arm also without data so that an idle sensor is probed once per timeout */
+                rec->last_us = now_us;
+            }
+        }
+
+        if ((rslt == BMM350_OK) && (drdy == BMM350_ENABLE))
+        {
+            rec->last_us = now_us;
+            *ready = true;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the time until the edge timeout expires.
+ */
+uint32_t bmm350_drdy_recovery_idle_us(uint32_t now_us, const struct bmm350_drdy_recovery *rec)
+{
+    uint32_t idle_us = 0;
+    uint32_t elapsed_us;
+
+    if (rec != NULL)
+    {
+        elapsed_us = now_us - rec->last_us;
+        if (elapsed_us < rec->timeout_us)
+        {
+            idle_us = rec->timeout_us - elapsed_us;
+        }
+    }
+
+    return idle_us;
+}
@@ -0,0 +1,183 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_drdy_recovery.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_DRDY_RECOVERY_H
+#define _BMM350_DRDY_RECOVERY_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Edge timeout beyond the sample period: period / BMM350_DRDY_TIMEOUT_DIV, at least BMM350_DRDY_MIN_MARGIN_US */
+#define BMM350_DRDY_TIMEOUT_DIV        UINT32_C(4)
+#define BMM350_DRDY_MIN_MARGIN_US      UINT32_C(200)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the missed data ready statistics
+ */
+struct bmm350_drdy_recovery_stats
+{
+    /*! Samples read, and edges seen by the interrupt handler */
+    uint32_t sample_count;
+    uint32_t edge_count;
+
+    /*! Pulsed mode: samples recovered after an edge timeout, i.e. edges lost by the host */
+    uint32_t missed_edges;
+
+    /*! Latched mode: samples recovered from a line left asserted */
+    uint32_t stuck_lines;
+
+    /*! Edges whose sample had already been recovered */
+    uint32_t late_edges;
+
+    /*! Edge timeouts without new data, e.g. while the sensor is not converting */
+    uint32_t empty_timeouts;
+
+    /*! Samples missing from the sensortime, the gaps the recoveries left behind */
+    uint32_t missed_samples;
+};
+
+/*!
+ * @brief Structure to define the state of the interrupt driven acquisition
+ */
+struct bmm350_drdy_recovery
+{
+    /*! Interrupt mode configured in the sensor */
+    enum bmm350_intr_latch latching;
+
+    /*! Sample period and edge timeout in us, sample period in sensortime ticks */
+    uint32_t period_us;
+    uint32_t timeout_us;
+    uint32_t period_ticks;
+
+    /*! Edges counted by bmm350_drdy_recovery_isr, and edges handled by the poll */
+    volatile uint32_t isr_edges;
+    uint32_t handled_edges;
+
+    /*! Host time of the last sample or timeout in us */
+    uint32_t last_us;
+
+    /*! Sensortime extended beyond the 24-bit counter */
+    struct bmm350_timeline timeline;
+
+    /*! Missed data ready statistics */
+    struct bmm350_drdy_recovery_stats stats;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the interrupt driven acquisition for the configured ODR and interrupt mode.
+ * The sensor has to be in normal mode with the data ready interrupt enabled and mapped to the pin.
+ *
+ * @param[in] odr            : Output data rate configured in the sensor
+ * @param[in] latching       : Interrupt mode configured in the sensor
+ * @param[in] now_us         : Host time in us
+ * @param[out] rec           : Structure that stores the state of the acquisition
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> ODR out of range
+ */
+int8_t bmm350_drdy_recovery_init(enum bmm350_data_rates odr,
+                                 enum bmm350_intr_latch latching,
+                                 uint32_t now_us,
+                                 struct bmm350_drdy_recovery *rec);
+
+/*!
+ * @brief Function to be called from the data ready interrupt handler. It only counts the edge and does
+ * not access the bus.
+ *
+ * @param[in,out] rec        : Structure that stores the state of the acquisition
+ */
+void bmm350_drdy_recovery_isr(struct bmm350_drdy_recovery *rec);
+
+/*!
+ * @brief Function to read a sample after a data ready edge, or after the edge timeout expired.
+ *
+ * @details Every read is a single burst of interrupt status, data and sensortime, which also clears a
+ * latched interrupt. When no edge arrives within the sample period plus the margin, the status is read:
+ * - with data ready set, the sample is recovered. In pulsed mode the host lost the edge; in latched mode
+ *   the line was left asserted and no further edge could come. Reading the status releases it;
+ * - without data ready, the timeout is counted as empty and re-armed for another period.
+ * The acquisition never stalls for longer than one timeout, and the samples lost meanwhile show up as a
+ * gap in the extended sensortime, counted in missed_samples.
+ *
+ * @param[in] now_us         : Host time in us
+ * @param[out] timed_data    : Sample stamped with the extended sensortime, valid when ready is set
+ * @param[out] ready         : Flag set when a new sample was read
+ * @param[in,out] rec        : Structure that stores the state of the acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_drdy_recovery_poll(uint32_t now_us,
+                                 struct bmm350_timed_mag_temp_data *timed_data,
+                                 bool *ready,
+                                 struct bmm350_drdy_recovery *rec,
+                                 struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get the time until the edge timeout expires, so that the host can sleep until an
+ * edge or the timeout.
+ *
+ * @param[in] now_us         : Host time in us
+ * @param[in] rec            : Structure that stores the state of the acquisition
+ *
+ *  @return Time until the edge timeout in us
+ */
+uint32_t bmm350_drdy_recovery_idle_us(uint32_t now_us, const struct bmm350_drdy_recovery *rec);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_DRDY_RECOVERY_H */
@@ -0,0 +1,408 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_duty_cycle.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_duty_cycle.h"
+
+/*! Noise reduction 1/sqrt(2^avg) of the averaging settings */
+static const float noise_scale[4] = { 1.0f, 0.7071068f, 0.5f, 0.3535534f };
+
+/*! Suspend to forced mode conversion times per averaging setting, in us */
+static const uint32_t forced_delay[4] = {
+    BMM350_SUS_TO_FORCEDMODE_NO_AVG_DELAY, BMM350_SUS_TO_FORCEDMODE_AVG_2_DELAY,
+    BMM350_SUS_TO_FORCEDMODE_AVG_4_DELAY, BMM350_SUS_TO_FORCEDMODE_AVG_8_DELAY
+};
+
+static const uint32_t forced_fast_delay[4] = {
+    BMM350_SUS_TO_FORCEDMODE_FAST_NO_AVG_DELAY, BMM350_SUS_TO_FORCEDMODE_FAST_AVG_2_DELAY,
+    BMM350_SUS_TO_FORCEDMODE_FAST_AVG_4_DELAY, BMM350_SUS_TO_FORCEDMODE_FAST_AVG_8_DELAY
+};
+
+/*!
+ * @brief This internal API is used to check whether a forced scheme fits the sample period and needs less
+ * active time than the best scheme so far, and to take it if so.
+ *
+ * @param[in] mode          : Forced mode to check
+ * @param[in] conversion_us : Conversion time of the forced mode at the plan averaging
+ * @param[in] candidate     : Plan with rate, period, averaging and noise set
+ * @param[in,out] best      : Best plan so far, replaced if the forced mode is cheaper
+ * @param[in,out] found     : Flag set when a scheme has been taken
+ */
+static void consider_forced(enum bmm350_power_modes mode,
+                            uint32_t conversion_us,
+                            struct bmm350_dc_plan candidate,
+                            struct bmm350_dc_plan *best,
+                            bool *found)
+{
+    candidate.mode = mode;
+    candidate.conversion_us = conversion_us;
+    candidate.active_fraction = ((float)conversion_us * candidate.rate_hz) / 1000000.0f;
+
+    if ((candidate.period_us >= (conversion_us + BMM350_DC_PLAN_MARGIN_US)) &&
+        ((!*found) || (candidate.active_fraction < best->active_fraction)))
+    {
+        *best = candidate;
+        *found = true;
+    }
+}
+
+/*!
+ * @brief This API is used to start duty cycled acquisition.
+ */
+int8_t bmm350_duty_cycle_init(enum bmm350_power_modes forced_mode,
+                              struct bmm350_duty_cycle *dc,
+                              struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    if (dc != NULL)
+    {
+        if ((forced_mode == BMM350_FORCED_MODE) || (forced_mode == BMM350_FORCED_MODE_FAST))
+        {
+            /* Keep sensortime running while the sensor is suspended between conversions */
+            rslt = bmm350_set_ctrl_user(BMM350_CFG_SENS_TIM_AON_EN, dev);
+
+            if (rslt == BMM350_OK)
+            {
+                rslt = bmm350_set_powermode(BMM350_SUSPEND_MODE, dev);
+            }
+
+            if (rslt == BMM350_OK)
+            {
+                dc->forced_mode = forced_mode;
+                dc->timeline.started = 0;
+            }
+        }
+        else
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to trigger one forced mode conversion.
+ */
+int8_t bmm350_duty_cycle_trigger(const struct bmm350_duty_cycle *dc, struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    if (dc != NULL)
+    {
+        rslt = bmm350_trigger_forced(dc->forced_mode, dev);
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to read the last conversion stamped with the sensor timeline.
+ */
+int8_t bmm350_duty_cycle_read(struct bmm350_timed_mag_temp_data *timed_data,
+                              struct bmm350_duty_cycle *dc,
+                              struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    uint32_t sensortime = 0;
+
+    if ((timed_data != NULL) && (dc != NULL))
+    {
+        rslt = bmm350_get_compensated_mag_xyz_temp_sensortime(&timed_data->data, &sensortime, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_extend_sensortime(sensortime, 0, NULL, &dc->timeline);
+            timed_data->sensortime = dc->timeline.ticks;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to convert an extended sensortime to nanoseconds.
+ */
+uint64_t bmm350_duty_cycle_ticks_to_ns(uint64_t sensortime)
+{
+    return (sensortime * BMM350_SENSORTIME_TICK_NS_NUM) / BMM350_SENSORTIME_TICK_NS_DEN;
+}
+
+/*!
+ * @brief This API is used to choose the scheme with the least sensor active time for an output rate and a noise
+ * target.
+ */
+int8_t bmm350_dc_plan(float rate_hz, float noise_ut, bool allow_fast, struct bmm350_dc_plan *plan)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t avg = BMM350_AVG_NO_AVG;
+    uint8_t odr = BMM350_ODR_1_5625HZ;
+    float odr_hz;
+    struct bmm350_dc_plan candidate = { 0 };
+    bool found = false;
+
+    if (plan != NULL)
+    {
+        if ((rate_hz > 0.0f) && (noise_ut > 0.0f))
+        {
+            /* Lowest averaging meeting the target on the noisier z axis */
+            while ((avg < BMM350_AVG_8) && ((BMM350_NOISE_Z_NO_AVG_UT * noise_scale[avg]) > noise_ut))
+            {
+                avg++;
+            }
+
+            if ((BMM350_NOISE_Z_NO_AVG_UT * noise_scale[avg]) > noise_ut)
+            {
+                rslt = BMM350_E_INVALID_INPUT;
+            }
+        }
+        else
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            /* Nearest ODR at or above the rate, starting from the slowest one */
+            odr_hz = BMM350_ODR_BASE_HZ / (float)(1u << odr);
+            while ((odr > BMM350_ODR_400HZ) && (odr_hz < rate_hz))
+            {
+                odr--;
+                odr_hz = BMM350_ODR_BASE_HZ / (float)(1u << odr);
+            }
+
+            candidate.odr = (enum bmm350_data_rates)odr;
+            candidate.avg = (enum bmm350_performance_parameters)avg;
+            candidate.noise_ut = BMM350_NOISE_Z_NO_AVG_UT * noise_scale[avg];
+
+            if ((odr_hz >= rate_hz) && (candidate.avg == bmm350_cap_averaging(candidate.odr, candidate.avg)))
+            {
+                /* Normal mode never suspends */
+                *plan = candidate;
+                plan->mode = BMM350_NORMAL_MODE;
+                plan->rate_hz = odr_hz;
+                plan->period_us = (uint32_t)(1000000.0f / odr_hz);
+                plan->active_fraction = 1.0f;
+                found = true;
+            }
+
+            /* A forced scheme runs at the requested rate exactly; the slowest ODR leaves the averaging uncapped */
+            candidate.odr = BMM350_DATA_RATE_1_5625HZ;
+            candidate.rate_hz = rate_hz;
+            candidate.period_us = (uint32_t)(1000000.0f / rate_hz);
+
+            if (allow_fast)
+            {
+                consider_forced(BMM350_FORCED_MODE_FAST, forced_fast_delay[avg], candidate, plan, &found);
+            }
+
+            consider_forced(BMM350_FORCED_MODE, forced_delay[avg], candidate, plan, &found);
+
+            if (!found)
+            {
+                rslt = BMM350_E_INVALID_INPUT;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to start the execution of a plan.
+ */
+int8_t bmm350_dc_plan_start(const struct bmm350_dc_plan *plan,
+                            uint32_t now_us,
+                            struct bmm350_duty_cycle *dc,
+                            struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    if ((plan != NULL) && (dc != NULL))
+    {
+        rslt = bmm350_set_odr_performance(plan->odr, plan->avg, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            if (plan->mode == BMM350_NORMAL_MODE)
+            {
+                /* The poll reads a sample when INT_STATUS signals data ready */
+                rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, dev);
+
+                if (rslt == BMM350_OK)
+                {
+                    rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, dev);
+                }
+
+                if (rslt == BMM350_OK)
+                {
+                    dc->forced_mode = BMM350_NORMAL_MODE;
+                    dc->timeline.started = 0;
+                }
+            }
+            else
+            {
+                rslt = bmm350_duty_cycle_init(plan->mode, dc, dev);
+            }
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            dc->plan = *plan;
+            dc->next_trigger_us = now_us;
+            dc->trigger_us = now_us;
+            dc->pending = false;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to run the plan and collect samples.
+ */
+int8_t bmm350_dc_plan_poll(uint32_t now_us,
+                           struct bmm350_timed_mag_temp_data *timed_data,
+                           bool *ready,
+                           struct bmm350_duty_cycle *dc,
+                           struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t int_status = 0;
+
+    if ((timed_data != NULL) && (ready != NULL) && (dc != NULL))
+    {
+        *ready = false;
+
+        if (dc->plan.mode == BMM350_NORMAL_MODE)
+        {
+            rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, &int_status, 1, dev);
+
+            if ((rslt == BMM350_OK) && ((int_status & BMM350_DRDY_DATA_REG_MSK) != 0))
+            {
+                rslt = bmm350_duty_cycle_read(timed_data, dc, dev);
+                *ready = (rslt == BMM350_OK);
+            }
+        }
+        else
+        {
+            /* Collect the running conversion first so that one poll can read and trigger */
+            if (dc->pending && ((now_us - dc->trigger_us) >= dc->plan.conversion_us))
+            {
+                dc->pending = false;
+                rslt = bmm350_duty_cycle_read(timed_data, dc, dev);
+                *ready = (rslt == BMM350_OK);
+            }
+
+            if ((rslt == BMM350_OK) && (!dc->pending) && ((int32_t)(now_us - dc->next_trigger_us) >= 0))
+            {
+                rslt = bmm350_duty_cycle_trigger(dc, dev);
+
+                if (rslt == BMM350_OK)
+                {
+                    dc->pending = true;
+                    dc->trigger_us = now_us;
+                    dc->next_trigger_us += dc->plan.period_us;
+
+                    /* Drop the missed slots after a stall instead of triggering back to back */
+                    if ((int32_t)(now_us - dc->next_trigger_us) >= 0)
+                    {
+                        dc->next_trigger_us = now_us + dc->plan.period_us;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the time until the plan has work to do.
+ */
+uint32_t bmm350_dc_plan_idle_us(uint32_t now_us, const struct bmm350_duty_cycle *dc)
+{
+    uint32_t idle_us = 0;
+    uint32_t elapsed_us;
+
+    if (dc != NULL)
+    {
+        if (dc->plan.mode == BMM350_NORMAL_MODE)
+        {
+            idle_us = dc->plan.period_us;
+        }
+        else if (dc->pending)
+        {
+            elapsed_us = now_us - dc->trigger_us;
+            if (elapsed_us < dc->plan.conversion_us)
+            {
+                idle_us = dc->plan.conversion_us - elapsed_us;
+            }
+        }
+        else if ((int32_t)(dc->next_trigger_us - now_us) > 0)
+        {
+            idle_us = dc->next_trigger_us - now_us;
+        }
+    }
+
+    return idle_us;
+}
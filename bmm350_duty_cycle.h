@@ -0,0 +1,251 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_duty_cycle.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_DUTY_CYCLE_H
+#define _BMM350_DUTY_CYCLE_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Macro to define the duration of one sensortime tick. 1 LSB is 39.0625us = 390625 / 10 ns */
+#define BMM350_SENSORTIME_TICK_NS_NUM  UINT64_C(390625)
+#define BMM350_SENSORTIME_TICK_NS_DEN  UINT64_C(10)
+
+/*! Macro to define the time a forced conversion period needs beyond the conversion, for trigger and read, in us */
+#define BMM350_DC_PLAN_MARGIN_US       UINT32_C(1000)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define an acquisition plan for an output rate and a noise target
+ */
+struct bmm350_dc_plan
+{
+    /*! Scheme: BMM350_NORMAL_MODE, or BMM350_FORCED_MODE / BMM350_FORCED_MODE_FAST with suspend in between */
+    enum bmm350_power_modes mode;
+
+    /*! ODR: the nearest one at or above the requested rate in normal mode, the slowest one otherwise */
+    enum bmm350_data_rates odr;
+
+    /*! Averaging that meets the noise target */
+    enum bmm350_performance_parameters avg;
+
+    /*! Output rate in Hz and sample period in us */
+    float rate_hz;
+    uint32_t period_us;
+
+    /*! Conversion time of a forced sample in us, 0 in normal mode */
+    uint32_t conversion_us;
+
+    /*! Fraction of the time the sensor is out of suspend, 1 in normal mode */
+    float active_fraction;
+
+    /*! Expected noise of the worst axis in uT rms */
+    float noise_ut;
+};
+
+/*!
+ * @brief Structure to define the state of the duty cycled acquisition
+ */
+struct bmm350_duty_cycle
+{
+    /*! Forced mode used to trigger a conversion (BMM350_FORCED_MODE or BMM350_FORCED_MODE_FAST) */
+    enum bmm350_power_modes forced_mode;
+
+    /*! Sensortime extended beyond the 24-bit counter */
+    struct bmm350_timeline timeline;
+
+    /*! Plan executed by bmm350_dc_plan_poll */
+    struct bmm350_dc_plan plan;
+
+    /*! Host time of the next trigger and of the pending conversion in us */
+    uint32_t next_trigger_us;
+    uint32_t trigger_us;
+
+    /*! Flag to track if a forced conversion is running */
+    bool pending;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to start duty cycled acquisition. The sensortime is kept running
+ * during suspend (BMM350_CFG_SENS_TIM_AON_EN), the sensor is put to suspend mode and
+ * the timeline is reset.
+ *
+ * @param[in] forced_mode    : BMM350_FORCED_MODE or BMM350_FORCED_MODE_FAST
+ * @param[out] dc            : Structure that stores the state of the duty cycled acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_duty_cycle_init(enum bmm350_power_modes forced_mode,
+                              struct bmm350_duty_cycle *dc,
+                              struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to trigger one forced mode conversion with bmm350_trigger_forced, without
+ * waiting; the sample is read with bmm350_duty_cycle_read once data ready is signalled.
+ * The sensor returns to suspend mode on its own after the conversion.
+ *
+ * @param[in] dc             : Structure that stores the state of the duty cycled acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_duty_cycle_trigger(const struct bmm350_duty_cycle *dc, struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to read the sample of the last conversion and stamp it with the sensor
+ * timeline. Data and sensortime are fetched in a single burst read and no host clock is read,
+ * so this function can be called from the data ready interrupt handler.
+ *
+ * @note The 24-bit sensortime wraps every 655.36s. Consecutive samples have to be read
+ * less than one wrap period apart for the wrap extension to stay continuous.
+ *
+ * @param[out] timed_data    : Sample stamped with the extended sensortime
+ * @param[in,out] dc         : Structure that stores the state of the duty cycled acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_duty_cycle_read(struct bmm350_timed_mag_temp_data *timed_data,
+                              struct bmm350_duty_cycle *dc,
+                              struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to convert an extended sensortime to nanoseconds
+ *
+ * @param[in] sensortime     : Extended sensortime in ticks
+ *
+ *  @return Sensortime in nanoseconds
+ */
+uint64_t bmm350_duty_cycle_ticks_to_ns(uint64_t sensortime);
+
+/*!
+ * @brief Function to choose the scheme with the least sensor active time for an output rate and a noise target.
+ *
+ * @details The averaging is the lowest that meets the noise target on all axes. Normal mode runs at the nearest
+ * ODR at or above the rate, if that ODR allows the averaging, and counts as active all the time. A forced scheme
+ * triggers one conversion per period and suspends in between; it is active for the conversion time of the
+ * suspend to forced mode delay tables and needs BMM350_DC_PLAN_MARGIN_US on top of it per period.
+ * Forced mode fast is only considered when allowed.
+ *
+ * @param[in] rate_hz        : Output rate in Hz
+ * @param[in] noise_ut       : Noise target in uT rms
+ * @param[in] allow_fast     : Consider forced mode fast
+ * @param[out] plan          : Chosen plan
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error: BMM350_E_INVALID_INPUT if no scheme meets the rate and the noise target
+ */
+int8_t bmm350_dc_plan(float rate_hz, float noise_ut, bool allow_fast, struct bmm350_dc_plan *plan);
+
+/*!
+ * @brief Function to start the execution of a plan: configures averaging and ODR, then starts normal mode with
+ * the data ready interrupt enabled, or prepares duty cycled acquisition. The first forced conversion is triggered
+ * by the next poll.
+ *
+ * @param[in] plan           : Plan to execute
+ * @param[in] now_us         : Host time in us
+ * @param[out] dc            : Structure that stores the state of the duty cycled acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_dc_plan_start(const struct bmm350_dc_plan *plan,
+                            uint32_t now_us,
+                            struct bmm350_duty_cycle *dc,
+                            struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to run the plan and collect samples, the same way for all schemes. In normal mode it reads
+ * a sample when data ready is set; in a forced scheme it reads the conversion once it is complete and triggers
+ * the next one on schedule. The sensor returns to suspend on its own after each conversion.
+ *
+ * @param[in] now_us         : Host time in us
+ * @param[out] timed_data    : Sample stamped with the extended sensortime, valid when ready is set
+ * @param[out] ready         : Flag set when a sample was read
+ * @param[in,out] dc         : Structure that stores the state of the duty cycled acquisition
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_dc_plan_poll(uint32_t now_us,
+                           struct bmm350_timed_mag_temp_data *timed_data,
+                           bool *ready,
+                           struct bmm350_duty_cycle *dc,
+                           struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get the time until bmm350_dc_plan_poll has work to do, so that the host can sleep.
+ * In normal mode this is the sample period.
+ *
+ * @param[in] now_us         : Host time in us
+ * @param[in] dc             : Structure that stores the state of the duty cycled acquisition
+ *
+ *  @return Time until the next poll in us
+ */
+uint32_t bmm350_dc_plan_idle_us(uint32_t now_us, const struct bmm350_duty_cycle *dc);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_DUTY_CYCLE_H */
@@ -0,0 +1,508 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_encoding.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_encoding.h"
+
+/*!
+ * @brief This internal API is used to convert a float to IEEE 754 half precision,
+ * rounding to nearest even. Values beyond the half range saturate to infinity.
+ */
+static uint16_t float_to_half(float value)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } conv;
+    uint32_t sign, mant, half;
+    int32_t exp;
+
+    conv.f = value;
+    sign = (conv.u >> 16) & 0x8000u;
+    exp = (int32_t)((conv.u >> 23) & 0xffu) - 127 + 15;
+    mant = conv.u & 0x7fffffu;
+
+    if (((conv.u >> 23) & 0xffu) == 0xffu)
+    {
+        /* Infinity or NaN */
+        half = sign | 0x7c00u | ((mant != 0) ? 0x200u : 0u);
+    }
+    else if (exp >= 31)
+    {
+        half = sign | 0x7c00u;
+    }
+    else if (exp <= 0)
+    {
+        if (exp < -10)
+        {
+            half = sign;
+        }
+        else
+        {
+            /* Subnormal: shift in the implicit bit */
+            mant |= 0x800000u;
+            half = mant >> (14 - exp);
+
+            if (((mant >> (13 - exp)) & 1u) && ((mant & ((1u << (13 - exp)) - 1u)) || (half & 1u)))
+            {
+                half++;
+            }
+
+            half |= sign;
+        }
+    }
+    else
+    {
+        half = ((uint32_t)exp << 10) | (mant >> 13);
+
+        /* Round to nearest even; a carry into the exponent is correct */
+        if ((mant & 0x1000u) && ((mant & 0x2fffu) != 0))
+        {
+            half++;
+        }
+
+        half |= sign;
+    }
+
+    return (uint16_t)half;
+}
+
+/*!
+ * @brief This internal API is used to convert IEEE 754 half precision to a float.
+ */
+static float half_to_float(uint16_t half)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } conv;
+    uint32_t sign = ((uint32_t)half & 0x8000u) << 16;
+    uint32_t exp = (half >> 10) & 0x1fu;
+    uint32_t mant = half & 0x3ffu;
+
+    if (exp == 0x1fu)
+    {
+        conv.u = sign | 0x7f800000u | (mant << 13);
+    }
+    else if (exp == 0)
+    {
+        /* Zero or subnormal */
+        conv.f = ldexpf((float)mant, -24);
+        conv.u |= sign;
+    }
+    else
+    {
+        conv.u = sign | ((exp + 127u - 15u) << 23) | (mant << 13);
+    }
+
+    return conv.f;
+}
+
+/*!
+ * @brief This internal API is used to quantize a value to int16 steps with clipping.
+ */
+static int16_t quantize(float value, float inv_step, uint32_t *clip_count)
+{
+    float scaled = value * inv_step;
+    int16_t quant;
+
+    if (scaled >= 32767.0f)
+    {
+        quant = INT16_MAX;
+        (*clip_count)++;
+    }
+    else if (scaled <= -32767.0f)
+    {
+        quant = -INT16_MAX;
+        (*clip_count)++;
+    }
+    else
+    {
+        quant = (int16_t)floorf(scaled + 0.5f);
+    }
+
+    return quant;
+}
+
+/*!
+ * @brief This internal API is used to write an int16 little endian.
+ */
+static void put_int16(uint8_t *buf, int16_t value)
+{
+    buf[0] = (uint8_t)((uint16_t)value & 0xff);
+    buf[1] = (uint8_t)((uint16_t)value >> 8);
+}
+
+/*!
+ * @brief This internal API is used to read an int16 little endian.
+ */
+static int16_t get_int16(const uint8_t *buf)
+{
+    return (int16_t)((uint16_t)buf[0] | ((uint16_t)buf[1] << 8));
+}
+
+/*!
+ * @brief This internal API is used to get the encoded length of the next len samples.
+ */
+static uint32_t encoded_length(uint16_t len, const struct bmm350_enc *enc)
+{
+    uint32_t length = (uint32_t)len * BMM350_ENC_SAMPLE_LEN;
+    uint32_t keyframes;
+
+    if (enc->config.format == BMM350_ENC_DELTA8)
+    {
+        /* Keyframes fall on phase 0 */
+        keyframes = ((uint32_t)len + ((enc->phase == 0) ? (enc->config.keyframe_interval - 1u) : (enc->phase - 1u))) /
+                    enc->config.keyframe_interval;
+        length = keyframes * BMM350_ENC_SAMPLE_LEN + ((uint32_t)len - keyframes) * BMM350_ENC_DELTA_LEN;
+    }
+
+    return length;
+}
+
+/*!
+ * @brief This API is used to initialize an encoder or a decoder.
+ */
+int8_t bmm350_enc_init(const struct bmm350_enc_config *config, struct bmm350_enc *enc)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx;
+
+    if (enc != NULL)
+    {
+        if (config != NULL)
+        {
+            enc->config = *config;
+        }
+        else
+        {
+            enc->config.format = BMM350_ENC_INT16;
+            enc->config.step_nt = BMM350_ENC_DEFAULT_STEP_NT;
+            enc->config.keyframe_interval = BMM350_ENC_DEFAULT_KEYFRAME;
+        }
+
+        if ((enc->config.format > BMM350_ENC_DELTA8) || (enc->config.step_nt == 0) ||
+            (enc->config.keyframe_interval == 0))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            enc->step_ut = (float)enc->config.step_nt / 1000.0f;
+            enc->range_ut = 32767.0f * enc->step_ut;
+            enc->phase = 0;
+            enc->clip_count = 0;
+
+            for (indx = 0; indx < 4; indx++)
+            {
+                enc->last[indx] = 0;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to restart the delta format at a keyframe.
+ */
+int8_t bmm350_enc_resync(struct bmm350_enc *enc)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (enc != NULL)
+    {
+        enc->phase = 0;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to encode compensated samples.
+ */
+int8_t bmm350_enc_encode(const struct bmm350_mag_temp_data *data,
+                         uint16_t len,
+                         uint8_t *buf,
+                         uint16_t buf_len,
+                         uint16_t *out_len,
+                         struct bmm350_enc *enc)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t indx, pos = 0;
+    uint8_t chan;
+    int16_t quant[4];
+    int32_t delta;
+    float value[4];
+    float inv_step, range;
+
+    if ((data != NULL) && (buf != NULL) && (out_len != NULL) && (enc != NULL))
+    {
+        *out_len = 0;
+
+        if (encoded_length(len, enc) > buf_len)
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            inv_step = 1.0f / enc->step_ut;
+            range = enc->range_ut;
+
+            for (indx = 0; indx < len; indx++)
+            {
+                value[0] = data[indx].x;
+                value[1] = data[indx].y;
+                value[2] = data[indx].z;
+                value[3] = data[indx].temperature;
+
+                if (enc->config.format == BMM350_ENC_FLOAT16)
+                {
+                    for (chan = 0; chan < 4; chan++)
+                    {
+                        if ((chan < 3) && (fabsf(value[chan]) > range))
+                        {
+                            value[chan] = (value[chan] > 0.0f) ? range : -range;
+                            enc->clip_count++;
+                        }
+
+                        put_int16(&buf[pos + chan * 2], (int16_t)float_to_half(value[chan]));
+                    }
+
+                    pos += BMM350_ENC_SAMPLE_LEN;
+                }
+                else
+                {
+                    for (chan = 0; chan < 3; chan++)
+                    {
+                        quant[chan] = quantize(value[chan], inv_step, &enc->clip_count);
+                    }
+
+                    quant[3] = quantize(value[3], 1.0f / BMM350_ENC_TEMP_STEP, &enc->clip_count);
+
+                    if ((enc->config.format == BMM350_ENC_INT16) || (enc->phase == 0))
+                    {
+                        for (chan = 0; chan < 4; chan++)
+                        {
+                            put_int16(&buf[pos + chan * 2], quant[chan]);
+                            enc->last[chan] = quant[chan];
+                        }
+
+                        pos += BMM350_ENC_SAMPLE_LEN;
+                    }
+                    else
+                    {
+                        for (chan = 0; chan < 4; chan++)
+                        {
+                            /* Difference to the decoder reconstruction, saturated */
+                            delta = (int32_t)quant[chan] - enc->last[chan];
+
+                            if ((delta > INT8_MAX) || (delta < -INT8_MAX))
+                            {
+                                delta = (delta > 0) ? INT8_MAX : -INT8_MAX;
+                                enc->clip_count++;
+                            }
+
+                            buf[pos + chan] = (uint8_t)(int8_t)delta;
+                            enc->last[chan] = (int16_t)(enc->last[chan] + delta);
+                        }
+
+                        pos += BMM350_ENC_DELTA_LEN;
+                    }
+
+                    if (enc->config.format == BMM350_ENC_DELTA8)
+                    {
+                        enc->phase = (uint8_t)((enc->phase + 1u) % enc->config.keyframe_interval);
+                    }
+                }
+            }
+
+            *out_len = pos;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to decode samples encoded with bmm350_enc_encode.
+ */
+int8_t bmm350_enc_decode(const uint8_t *buf,
+                         uint16_t buf_len,
+                         struct bmm350_mag_temp_data *data,
+                         uint16_t max_len,
+                         uint16_t *n_samples,
+                         struct bmm350_enc *enc)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t pos = 0, count = 0;
+    uint8_t chan, sample_len;
+    float value[4];
+
+    if ((buf != NULL) && (data != NULL) && (n_samples != NULL) && (enc != NULL))
+    {
+        while ((pos < buf_len) && (rslt == BMM350_OK))
+        {
+            sample_len = BMM350_ENC_SAMPLE_LEN;
+
+            if ((enc->config.format == BMM350_ENC_DELTA8) && (enc->phase != 0))
+            {
+                sample_len = BMM350_ENC_DELTA_LEN;
+            }
+
+            if (((buf_len - pos) < sample_len) || (count >= max_len))
+            {
+                rslt = BMM350_E_INVALID_INPUT;
+            }
+            else
+            {
+                for (chan = 0; chan < 4; chan++)
+                {
+                    if (enc->config.format == BMM350_ENC_FLOAT16)
+                    {
+                        value[chan] = half_to_float((uint16_t)get_int16(&buf[pos + chan * 2]));
+                    }
+                    else
+                    {
+                        if (sample_len == BMM350_ENC_SAMPLE_LEN)
+                        {
+                            enc->last[chan] = get_int16(&buf[pos + chan * 2]);
+                        }
+                        else
+                        {
+                            enc->last[chan] = (int16_t)(enc->last[chan] + (int8_t)buf[pos + chan]);
+                        }
+
+                        value[chan] = (float)enc->last[chan] * ((chan < 3) ? enc->step_ut : BMM350_ENC_TEMP_STEP);
+                    }
+                }
+
+                data[count].x = value[0];
+                data[count].y = value[1];
+                data[count].z = value[2];
+                data[count].temperature = value[3];
+
+                if (enc->config.format == BMM350_ENC_DELTA8)
+                {
+                    enc->phase = (uint8_t)((enc->phase + 1u) % enc->config.keyframe_interval);
+                }
+
+                pos += sample_len;
+                count++;
+            }
+        }
+
+        *n_samples = count;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the quantization error of the encoding against the sensor noise.
+ */
+int8_t bmm350_enc_error_bound(enum bmm350_data_rates odr,
+                              enum bmm350_performance_parameters avg,
+                              const struct bmm350_enc *enc,
+                              struct bmm350_enc_error *err)
+{
+    int8_t rslt = BMM350_OK;
+    float odr_hz;
+    int exp;
+
+    if ((enc != NULL) && (err != NULL))
+    {
+        if ((odr < BMM350_DATA_RATE_400HZ) || (odr > BMM350_DATA_RATE_1_5625HZ) || (avg > BMM350_AVERAGING_8))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            odr_hz = BMM350_ODR_BASE_HZ / (float)(UINT16_C(1) << odr);
+
+            if (enc->config.format == BMM350_ENC_FLOAT16)
+            {
+                /* Half of the float16 ulp at the top of the range: 11 significant bits */
+                (void)frexpf(enc->range_ut, &exp);
+                err->max_error_ut = ldexpf(1.0f, exp - 12);
+            }
+            else
+            {
+                err->max_error_ut = enc->step_ut / 2.0f;
+            }
+
+            /* Uniform error over +/-max_error */
+            err->rms_error_ut = err->max_error_ut / sqrtf(3.0f);
+
+            /* Averaging 2^avg samples divides the noise variance by 2^avg */
+            err->noise_xy_ut = BMM350_NOISE_XY_NO_AVG_UT / sqrtf((float)(UINT8_C(1) << avg));
+            err->noise_z_ut = BMM350_NOISE_Z_NO_AVG_UT / sqrtf((float)(UINT8_C(1) << avg));
+            err->error_to_noise = err->rms_error_ut / err->noise_xy_ut;
+
+            err->max_slew_ut_s = 0.0f;
+
+            if (enc->config.format == BMM350_ENC_DELTA8)
+            {
+                err->max_slew_ut_s = (float)INT8_MAX * enc->step_ut * odr_hz;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,235 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_encoding.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_ENCODING_H
+#define _BMM350_ENCODING_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Encoding formats */
+#define BMM350_ENC_FLOAT16            UINT8_C(0)
+#define BMM350_ENC_INT16              UINT8_C(1)
+#define BMM350_ENC_DELTA8             UINT8_C(2)
+
+/*! Encoded length of a float16 or int16 sample or keyframe, and of a delta sample */
+#define BMM350_ENC_SAMPLE_LEN         UINT8_C(8)
+#define BMM350_ENC_DELTA_LEN          UINT8_C(4)
+
+/*! Temperature step of the int16 and delta formats in degC */
+#define BMM350_ENC_TEMP_STEP          (0.01f)
+
+/*! Default field step in nT, range +/-327.67uT */
+#define BMM350_ENC_DEFAULT_STEP_NT    UINT16_C(10)
+
+/*! Default keyframe interval of the delta format in samples */
+#define BMM350_ENC_DEFAULT_KEYFRAME   UINT8_C(16)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the encoding settings
+ */
+struct bmm350_enc_config
+{
+    /*! Format: BMM350_ENC_FLOAT16, BMM350_ENC_INT16 or BMM350_ENC_DELTA8 */
+    uint8_t format;
+
+    /*! Field step in nT of the int16 and delta formats. The range of all formats is +/-32767 steps. */
+    uint16_t step_nt;
+
+    /*! Keyframe interval of the delta format in samples, 1 for keyframes only */
+    uint8_t keyframe_interval;
+};
+
+/*!
+ * @brief Structure to define the state of an encoder or a decoder
+ */
+struct bmm350_enc
+{
+    /*! Settings */
+    struct bmm350_enc_config config;
+
+    /*! Field step and range in uT */
+    float step_ut;
+    float range_ut;
+
+    /*! Position in the keyframe interval of the next sample */
+    uint8_t phase;
+
+    /*! Last reconstructed sample of the delta format: x, y, z, temperature in steps */
+    int16_t last[4];
+
+    /*! Number of clipped values: field out of range or delta saturated */
+    uint32_t clip_count;
+};
+
+/*!
+ * @brief Structure to define the quantization error against the sensor noise
+ */
+struct bmm350_enc_error
+{
+    /*! Worst-case field quantization error in uT, for values up to the range */
+    float max_error_ut;
+
+    /*! RMS quantization error in uT of a uniform error over +/-max_error_ut */
+    float rms_error_ut;
+
+    /*! RMS sensor noise of x/y and z for the averaging setting in uT */
+    float noise_xy_ut;
+    float noise_z_ut;
+
+    /*! RMS quantization error over RMS x/y sensor noise */
+    float error_to_noise;
+
+    /*! Delta format: largest field slew tracked without lag in uT/s, 0 for other formats */
+    float max_slew_ut_s;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize an encoder or a decoder. Both sides must use the same settings.
+ *
+ * @param[in] config         : Encoding settings, NULL for int16 with BMM350_ENC_DEFAULT_STEP_NT
+ * @param[out] enc           : Structure that stores the state of the encoder or decoder
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Unknown format, zero step or zero keyframe interval
+ */
+int8_t bmm350_enc_init(const struct bmm350_enc_config *config, struct bmm350_enc *enc);
+
+/*!
+ * @brief Function to restart the delta format at a keyframe, on both sides after a lost packet.
+ *
+ * @param[in,out] enc        : Structure that stores the state of the encoder or decoder
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_enc_resync(struct bmm350_enc *enc);
+
+/*!
+ * @brief Function to encode compensated samples.
+ *
+ * @details All values are little endian, x, y, z then temperature:
+ *
+ *@verbatim
+ * BMM350_ENC_FLOAT16 : 4 x IEEE 754 half, field in uT, temperature in degC
+ * BMM350_ENC_INT16   : 4 x int16, field in step_nt, temperature in BMM350_ENC_TEMP_STEP
+ * BMM350_ENC_DELTA8  : int16 keyframe every keyframe_interval samples, 4 x int8 difference to
+ *                      the previous sample otherwise
+ *@endverbatim
+ *
+ * The field is clipped to the range. The delta encoder follows the decoder reconstruction,
+ * so a saturated difference delays the output instead of accumulating an error.
+ *
+ * @param[in] data           : Compensated samples
+ * @param[in] len            : Number of samples
+ * @param[out] buf           : Encoded data
+ * @param[in] buf_len        : Size of buf
+ * @param[out] out_len       : Number of bytes written
+ * @param[in,out] enc        : Structure that stores the state of the encoder
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_INPUT -> buf too small, nothing is encoded
+ */
+int8_t bmm350_enc_encode(const struct bmm350_mag_temp_data *data,
+                         uint16_t len,
+                         uint8_t *buf,
+                         uint16_t buf_len,
+                         uint16_t *out_len,
+                         struct bmm350_enc *enc);
+
+/*!
+ * @brief Function to decode samples encoded with bmm350_enc_encode.
+ *
+ * @param[in] buf            : Encoded data
+ * @param[in] buf_len        : Number of bytes
+ * @param[out] data          : Decoded samples
+ * @param[in] max_len        : Capacity of data
+ * @param[out] n_samples     : Number of decoded samples
+ * @param[in,out] enc        : Structure that stores the state of the decoder
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_INPUT -> Truncated sample or data too small, decoding stops there
+ */
+int8_t bmm350_enc_decode(const uint8_t *buf,
+                         uint16_t buf_len,
+                         struct bmm350_mag_temp_data *data,
+                         uint16_t max_len,
+                         uint16_t *n_samples,
+                         struct bmm350_enc *enc);
+
+/*!
+ * @brief Function to get the quantization error of the encoding against the sensor noise.
+ *
+ * @param[in] odr            : Output data rate, used for the delta slew limit
+ * @param[in] avg            : Averaging setting, used for the sensor noise
+ * @param[in] enc            : Structure that stores the state of the encoder
+ * @param[out] err           : Quantization error and sensor noise
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> ODR or averaging out of range
+ */
+int8_t bmm350_enc_error_bound(enum bmm350_data_rates odr,
+                              enum bmm350_performance_parameters avg,
+                              const struct bmm350_enc *enc,
+                              struct bmm350_enc_error *err);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_ENCODING_H */
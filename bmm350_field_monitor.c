@@ -0,0 +1,258 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_field_monitor.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_field_monitor.h"
+
+/*!
+ * @brief This internal API is used to calculate the dip angle in degree. Returns false if the
+ * field or the accelerometer vector is zero.
+ */
+static bool dip_angle(const struct bmm350_mag_temp_data *data, const float *accel, float mag, float *dip)
+{
+    float acc_norm = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    float sine;
+    bool valid = false;
+
+    if ((acc_norm > 0.0f) && (mag > 0.0f))
+    {
+        /* Accelerometer points up at rest, dip is positive for a field pointing down */
+        sine = -(data->x * accel[0] + data->y * accel[1] + data->z * accel[2]) / (acc_norm * mag);
+        sine = (sine > 1.0f) ? 1.0f : ((sine < -1.0f) ? -1.0f : sine);
+        *dip = asinf(sine) * BMM350_FIELD_RAD_TO_DEG;
+        valid = true;
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief This internal API is used to check one sample and update the reference.
+ */
+static uint8_t check_sample(const struct bmm350_mag_temp_data *data,
+                            const float *accel,
+                            struct bmm350_field_monitor_block *block,
+                            struct bmm350_field_monitor *mon)
+{
+    uint8_t flags = 0;
+    float mag = sqrtf(data->x * data->x + data->y * data->y + data->z * data->z);
+    float dev, dip = 0.0f, dip_dev;
+    bool dip_valid = false;
+
+    if (accel != NULL)
+    {
+        dip_valid = dip_angle(data, accel, mag, &dip);
+    }
+
+    if (mon->learned < mon->config.learn_samples)
+    {
+        /* Learning: running mean of magnitude and dip */
+        mon->learned++;
+        mon->ref_magnitude += (mag - mon->ref_magnitude) / (float)mon->learned;
+
+        if (dip_valid)
+        {
+            mon->dip_learned++;
+            mon->ref_dip += (dip - mon->ref_dip) / (float)mon->dip_learned;
+        }
+
+        flags = BMM350_FIELD_FLAG_LEARNING;
+    }
+    else
+    {
+        dev = mag - mon->ref_magnitude;
+
+        block->mean_dev += dev;
+        block->rms_dev += dev * dev;
+
+        if (fabsf(dev) > block->max_dev)
+        {
+            block->max_dev = fabsf(dev);
+        }
+
+        if (fabsf(dev) > mon->config.magnitude_tol)
+        {
+            flags |= BMM350_FIELD_FLAG_MAGNITUDE;
+        }
+
+        /* Dip reference comes from learning or from the settings */
+        dip_valid = dip_valid && ((mon->dip_learned > 0) || (mon->config.learn_samples == 0));
+
+        if (dip_valid)
+        {
+            dip_dev = fabsf(dip - mon->ref_dip);
+
+            if (dip_dev > block->max_dip_dev)
+            {
+                block->max_dip_dev = dip_dev;
+            }
+
+            if (dip_dev > mon->config.dip_tol)
+            {
+                flags |= BMM350_FIELD_FLAG_DIP;
+            }
+        }
+
+        if (flags == 0)
+        {
+            /* Follow slow changes of the environment with clean samples only */
+            mon->ref_magnitude += mon->config.alpha * dev;
+
+            if (dip_valid)
+            {
+                mon->ref_dip += mon->config.alpha * (dip - mon->ref_dip);
+            }
+        }
+        else
+        {
+            block->flagged++;
+            mon->flagged_count++;
+        }
+    }
+
+    mon->sample_count++;
+
+    return flags;
+}
+
+/*!
+ * @brief This API is used to initialize the earth field monitor.
+ */
+int8_t bmm350_field_monitor_init(const struct bmm350_field_monitor_config *config, struct bmm350_field_monitor *mon)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (mon != NULL)
+    {
+        if (config != NULL)
+        {
+            mon->config = *config;
+        }
+        else
+        {
+            mon->config.ref_magnitude = 0.0f;
+            mon->config.ref_dip = 0.0f;
+            mon->config.magnitude_tol = BMM350_FIELD_DEFAULT_MAG_TOL;
+            mon->config.dip_tol = BMM350_FIELD_DEFAULT_DIP_TOL;
+            mon->config.learn_samples = BMM350_FIELD_DEFAULT_LEARN;
+            mon->config.alpha = BMM350_FIELD_DEFAULT_ALPHA;
+        }
+
+        if ((mon->config.ref_magnitude < 0.0f) || (mon->config.magnitude_tol < 0.0f) ||
+            (mon->config.dip_tol < 0.0f) || (mon->config.alpha < 0.0f) || (mon->config.alpha > 1.0f) ||
+            ((mon->config.ref_magnitude == 0.0f) && (mon->config.learn_samples == 0)))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            /* A given reference replaces learning */
+            if (mon->config.ref_magnitude > 0.0f)
+            {
+                mon->config.learn_samples = 0;
+            }
+
+            mon->ref_magnitude = mon->config.ref_magnitude;
+            mon->ref_dip = mon->config.ref_dip;
+            mon->learned = 0;
+            mon->dip_learned = 0;
+            mon->sample_count = 0;
+            mon->flagged_count = 0;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to check a block of compensated samples against the expected earth field.
+ */
+int8_t bmm350_field_monitor_check(const struct bmm350_mag_temp_data *data,
+                                  const float (*accel)[3],
+                                  uint16_t len,
+                                  uint8_t *flags,
+                                  struct bmm350_field_monitor_block *block,
+                                  struct bmm350_field_monitor *mon)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t indx;
+    uint16_t checked = 0;
+    uint8_t sample_flags;
+
+    if ((data != NULL) && (block != NULL) && (mon != NULL))
+    {
+        block->flags = 0;
+        block->flagged = 0;
+        block->mean_dev = 0.0f;
+        block->rms_dev = 0.0f;
+        block->max_dev = 0.0f;
+        block->max_dip_dev = 0.0f;
+
+        for (indx = 0; indx < len; indx++)
+        {
+            sample_flags = check_sample(&data[indx], (accel != NULL) ? accel[indx] : NULL, block, mon);
+
+            if (!(sample_flags & BMM350_FIELD_FLAG_LEARNING))
+            {
+                checked++;
+            }
+
+            if (flags != NULL)
+            {
+                flags[indx] = sample_flags;
+            }
+
+            block->flags |= sample_flags;
+        }
+
+        if (checked > 0)
+        {
+            block->mean_dev /= (float)checked;
+            block->rms_dev = sqrtf(block->rms_dev / (float)checked);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
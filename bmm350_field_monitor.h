@@ -0,0 +1,189 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_field_monitor.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_FIELD_MONITOR_H
+#define _BMM350_FIELD_MONITOR_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Sample flags */
+#define BMM350_FIELD_FLAG_MAGNITUDE          UINT8_C(0x01)
+#define BMM350_FIELD_FLAG_DIP                UINT8_C(0x02)
+#define BMM350_FIELD_FLAG_LEARNING           UINT8_C(0x04)
+
+/*! Default magnitude tolerance in uT */
+#define BMM350_FIELD_DEFAULT_MAG_TOL         (5.0f)
+
+/*! Default dip angle tolerance in degree */
+#define BMM350_FIELD_DEFAULT_DIP_TOL         (5.0f)
+
+/*! Default number of samples learned when no reference magnitude is given */
+#define BMM350_FIELD_DEFAULT_LEARN           UINT16_C(100)
+
+/*! Default weight of the reference update with clean samples */
+#define BMM350_FIELD_DEFAULT_ALPHA           (0.001f)
+
+/*! Conversion from radian to degree */
+#define BMM350_FIELD_RAD_TO_DEG              (57.2957795f)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the monitor settings
+ */
+struct bmm350_field_monitor_config
+{
+    /*! Expected geomagnetic magnitude in uT, 0 to learn it from the first samples */
+    float ref_magnitude;
+
+    /*! Expected dip angle in degree, used if ref_magnitude is set and accelerometer data is supplied */
+    float ref_dip;
+
+    /*! Magnitude tolerance in uT */
+    float magnitude_tol;
+
+    /*! Dip angle tolerance in degree */
+    float dip_tol;
+
+    /*! Number of samples learned when ref_magnitude is 0 */
+    uint16_t learn_samples;
+
+    /*! Weight of the reference update with clean samples, 0 to freeze the reference */
+    float alpha;
+};
+
+/*!
+ * @brief Structure to define the statistics of a sample block
+ */
+struct bmm350_field_monitor_block
+{
+    /*! OR of all sample flags */
+    uint8_t flags;
+
+    /*! Number of samples with BMM350_FIELD_FLAG_MAGNITUDE or BMM350_FIELD_FLAG_DIP */
+    uint16_t flagged;
+
+    /*! Mean, rms and maximum absolute deviation of |B| from the reference in uT */
+    float mean_dev;
+    float rms_dev;
+    float max_dev;
+
+    /*! Maximum absolute deviation of the dip angle from the reference in degree */
+    float max_dip_dev;
+};
+
+/*!
+ * @brief Structure to define the state of the monitor
+ */
+struct bmm350_field_monitor
+{
+    /*! Settings */
+    struct bmm350_field_monitor_config config;
+
+    /*! Reference magnitude in uT and dip angle in degree */
+    float ref_magnitude;
+    float ref_dip;
+
+    /*! Samples accumulated into the magnitude and dip reference while learning */
+    uint16_t learned;
+    uint16_t dip_learned;
+
+    /*! Total samples and flagged samples since init */
+    uint32_t sample_count;
+    uint32_t flagged_count;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the earth field monitor.
+ *
+ * @param[in] config         : Monitor settings, NULL for defaults (learned reference)
+ * @param[out] mon           : Structure that stores the state of the monitor
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Negative reference or tolerance, or no learning with no reference
+ */
+int8_t bmm350_field_monitor_init(const struct bmm350_field_monitor_config *config, struct bmm350_field_monitor *mon);
+
+/*!
+ * @brief Function to check a block of compensated samples against the expected earth field.
+ *
+ * @details A sample is flagged when |B| departs from the reference magnitude by more than
+ * magnitude_tol, or, if accelerometer data is supplied, when the dip angle departs from the
+ * reference dip by more than dip_tol. The dip angle is positive when the field points downwards.
+ * Clean samples keep updating the reference with weight alpha. While the reference is learned,
+ * samples are flagged BMM350_FIELD_FLAG_LEARNING only.
+ *
+ * @param[in] data           : Compensated samples
+ * @param[in] accel          : Accelerometer samples in the frame of the magnetometer (pointing up at rest,
+ *                             any unit), NULL if not available
+ * @param[in] len            : Number of samples
+ * @param[out] flags         : Flags of each sample, NULL if not needed
+ * @param[out] block         : Statistics of the block
+ * @param[in,out] mon        : Structure that stores the state of the monitor
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_field_monitor_check(const struct bmm350_mag_temp_data *data,
+                                  const float (*accel)[3],
+                                  uint16_t len,
+                                  uint8_t *flags,
+                                  struct bmm350_field_monitor_block *block,
+                                  struct bmm350_field_monitor *mon);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_FIELD_MONITOR_H */
@@ -0,0 +1,417 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_fusion.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_fusion.h"
+
+/*!
+ * @brief This internal API is used to normalize a vector in place. Returns false for a zero vector.
+ */
+static bool normalize(float *vec, uint8_t len)
+{
+    uint8_t indx;
+    float norm = 0.0f;
+
+    for (indx = 0; indx < len; indx++)
+    {
+        norm += vec[indx] * vec[indx];
+    }
+
+    norm = sqrtf(norm);
+
+    if (norm > 0.0f)
+    {
+        for (indx = 0; indx < len; indx++)
+        {
+            vec[indx] /= norm;
+        }
+    }
+
+    return (norm > 0.0f);
+}
+
+/*!
+ * @brief This internal API is used to apply the hard and soft iron calibration.
+ */
+static void apply_calib(const float *mag, const struct bmm350_fusion_calib *calib, float *mag_cal)
+{
+    uint8_t row;
+    float centered[3];
+
+    centered[0] = mag[0] - calib->hard_iron[0];
+    centered[1] = mag[1] - calib->hard_iron[1];
+    centered[2] = mag[2] - calib->hard_iron[2];
+
+    for (row = 0; row < 3; row++)
+    {
+        mag_cal[row] = calib->soft_iron[row][0] * centered[0] + calib->soft_iron[row][1] * centered[1] +
+                       calib->soft_iron[row][2] * centered[2];
+    }
+}
+
+/*!
+ * @brief This internal API is used to run one gradient descent orientation update.
+ * mag is NULL for an update with gyroscope and accelerometer only.
+ */
+static void update_orientation(const float *gyr, const float *acc, const float *mag, float dt, struct bmm350_fusion *fusion)
+{
+    uint8_t row, col, rows = 0;
+    float q[4], q_dot[4], step[4] = { 0.0f };
+    float a[3], m[3], h[3];
+    float f[6], jac[6][4];
+    float bx, bz;
+
+    q[0] = fusion->q.w;
+    q[1] = fusion->q.x;
+    q[2] = fusion->q.y;
+    q[3] = fusion->q.z;
+
+    /* Rate of change of the quaternion from the gyroscope */
+    q_dot[0] = 0.5f * (-q[1] * gyr[0] - q[2] * gyr[1] - q[3] * gyr[2]);
+    q_dot[1] = 0.5f * (q[0] * gyr[0] + q[2] * gyr[2] - q[3] * gyr[1]);
+    q_dot[2] = 0.5f * (q[0] * gyr[1] - q[1] * gyr[2] + q[3] * gyr[0]);
+    q_dot[3] = 0.5f * (q[0] * gyr[2] + q[1] * gyr[1] - q[2] * gyr[0]);
+
+    a[0] = acc[0];
+    a[1] = acc[1];
+    a[2] = acc[2];
+
+    if (normalize(a, 3))
+    {
+        /* Gravity objective: predicted gravity in sensor frame minus measurement */
+        f[0] = 2.0f * (q[1] * q[3] - q[0] * q[2]) - a[0];
+        f[1] = 2.0f * (q[0] * q[1] + q[2] * q[3]) - a[1];
+        f[2] = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]) - a[2];
+
+        jac[0][0] = -2.0f * q[2];
+        jac[0][1] = 2.0f * q[3];
+        jac[0][2] = -2.0f * q[0];
+        jac[0][3] = 2.0f * q[1];
+        jac[1][0] = 2.0f * q[1];
+        jac[1][1] = 2.0f * q[0];
+        jac[1][2] = 2.0f * q[3];
+        jac[1][3] = 2.0f * q[2];
+        jac[2][0] = 0.0f;
+        jac[2][1] = -4.0f * q[1];
+        jac[2][2] = -4.0f * q[2];
+        jac[2][3] = 0.0f;
+        rows = 3;
+
+        if (mag != NULL)
+        {
+            m[0] = mag[0];
+            m[1] = mag[1];
+            m[2] = mag[2];
+        }
+
+        if ((mag != NULL) && normalize(m, 3))
+        {
+            /* Earth field direction: measurement rotated to earth frame, heading removed */
+            h[0] = (1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3])) * m[0] + 2.0f * (q[1] * q[2] - q[0] * q[3]) * m[1] +
+                   2.0f * (q[1] * q[3] + q[0] * q[2]) * m[2];
+            h[1] = 2.0f * (q[1] * q[2] + q[0] * q[3]) * m[0] + (1.0f - 2.0f * (q[1] * q[1] + q[3] * q[3])) * m[1] +
+                   2.0f * (q[2] * q[3] - q[0] * q[1]) * m[2];
+            h[2] = 2.0f * (q[1] * q[3] - q[0] * q[2]) * m[0] + 2.0f * (q[2] * q[3] + q[0] * q[1]) * m[1] +
+                   (1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) * m[2];
+            bx = sqrtf(h[0] * h[0] + h[1] * h[1]);
+            bz = h[2];
+
+            /* Magnetic objective: predicted earth field in sensor frame minus measurement */
+            f[3] = bx * (1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3])) + 2.0f * bz * (q[1] * q[3] - q[0] * q[2]) - m[0];
+            f[4] = 2.0f * bx * (q[1] * q[2] - q[0] * q[3]) + 2.0f * bz * (q[0] * q[1] + q[2] * q[3]) - m[1];
+            f[5] = 2.0f * bx * (q[0] * q[2] + q[1] * q[3]) + bz * (1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) - m[2];
+
+            jac[3][0] = -2.0f * bz * q[2];
+            jac[3][1] = 2.0f * bz * q[3];
+            jac[3][2] = -4.0f * bx * q[2] - 2.0f * bz * q[0];
+            jac[3][3] = -4.0f * bx * q[3] + 2.0f * bz * q[1];
+            jac[4][0] = -2.0f * bx * q[3] + 2.0f * bz * q[1];
+            jac[4][1] = 2.0f * bx * q[2] + 2.0f * bz * q[0];
+            jac[4][2] = 2.0f * bx * q[1] + 2.0f * bz * q[3];
+            jac[4][3] = -2.0f * bx * q[0] + 2.0f * bz * q[2];
+            jac[5][0] = 2.0f * bx * q[2];
+            jac[5][1] = 2.0f * bx * q[3] - 4.0f * bz * q[1];
+            jac[5][2] = 2.0f * bx * q[0] - 4.0f * bz * q[2];
+            jac[5][3] = 2.0f * bx * q[1];
+            rows = 6;
+        }
+
+        /* Gradient of the objective function: J^T * f */
+        for (col = 0; col < 4; col++)
+        {
+            for (row = 0; row < rows; row++)
+            {
+                step[col] += jac[row][col] * f[row];
+            }
+        }
+
+        if (normalize(step, 4))
+        {
+            for (col = 0; col < 4; col++)
+            {
+                q_dot[col] -= fusion->beta * step[col];
+            }
+        }
+    }
+
+    for (col = 0; col < 4; col++)
+    {
+        q[col] += q_dot[col] * dt;
+    }
+
+    (void)normalize(q, 4);
+
+    fusion->q.w = q[0];
+    fusion->q.x = q[1];
+    fusion->q.y = q[2];
+    fusion->q.z = q[3];
+}
+
+/*!
+ * @brief This internal API is used to get the magnetometer sample at an IMU timestamp.
+ * Returns false if no magnetometer sample is usable.
+ */
+static bool mag_at(uint64_t timestamp_ns,
+                   const struct bmm350_fusion_mag_sample *next,
+                   float *mag_out,
+                   struct bmm350_fusion *fusion)
+{
+    bool valid = false;
+    uint8_t axis;
+    float ratio;
+
+    if (fusion->mag_valid)
+    {
+        if ((next != NULL) && (next->timestamp_ns > fusion->last_mag.timestamp_ns))
+        {
+            /* Linear interpolation between the bracketing samples */
+            ratio = (float)(timestamp_ns - fusion->last_mag.timestamp_ns) /
+                    (float)(next->timestamp_ns - fusion->last_mag.timestamp_ns);
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                mag_out[axis] = fusion->last_mag.mag[axis] + ratio * (next->mag[axis] - fusion->last_mag.mag[axis]);
+            }
+
+            fusion->stats.mag_interpolated++;
+            valid = true;
+        }
+        else if ((timestamp_ns <= fusion->last_mag.timestamp_ns) ||
+                 ((timestamp_ns - fusion->last_mag.timestamp_ns) <= fusion->mag_hold_ns))
+        {
+            for (axis = 0; axis < 3; axis++)
+            {
+                mag_out[axis] = fusion->last_mag.mag[axis];
+            }
+
+            fusion->stats.mag_held++;
+            valid = true;
+        }
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief This internal API is used to get a sample of the magnetometer stream of a batch: the
+ * samples pending from the previous batch followed by the samples of this batch.
+ */
+static const struct bmm350_fusion_mag_sample *mag_sample(uint16_t index,
+                                                         const struct bmm350_fusion_mag_sample *mag,
+                                                         const struct bmm350_fusion *fusion)
+{
+    const struct bmm350_fusion_mag_sample *sample;
+
+    if (index < fusion->n_pending_mag)
+    {
+        sample = &fusion->pending_mag[index];
+    }
+    else
+    {
+        sample = &mag[index - fusion->n_pending_mag];
+    }
+
+    return sample;
+}
+
+/*!
+ * @brief This API is used to initialize the fusion adapter.
+ */
+int8_t bmm350_fusion_init(struct bmm350_fusion *fusion)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t row, col;
+    struct bmm350_fusion_stats stats = { 0 };
+
+    if (fusion != NULL)
+    {
+        fusion->q.w = 1.0f;
+        fusion->q.x = 0.0f;
+        fusion->q.y = 0.0f;
+        fusion->q.z = 0.0f;
+        fusion->beta = BMM350_FUSION_DEFAULT_BETA;
+        fusion->mag_hold_ns = BMM350_FUSION_DEFAULT_MAG_HOLD_NS;
+
+        for (row = 0; row < 3; row++)
+        {
+            fusion->calib.hard_iron[row] = 0.0f;
+
+            for (col = 0; col < 3; col++)
+            {
+                fusion->calib.soft_iron[row][col] = (row == col) ? 1.0f : 0.0f;
+            }
+        }
+
+        fusion->time_us = NULL;
+        fusion->last_imu_ns = 0;
+        fusion->n_pending_mag = 0;
+        fusion->mag_valid = false;
+        fusion->imu_valid = false;
+        fusion->stats = stats;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to run the orientation update for a batch of IMU samples.
+ */
+int8_t bmm350_fusion_update_batch(const struct bmm350_fusion_imu_sample *imu,
+                                  uint16_t imu_len,
+                                  const struct bmm350_fusion_mag_sample *mag,
+                                  uint16_t mag_len,
+                                  struct bmm350_fusion_quat *quat,
+                                  struct bmm350_fusion *fusion)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t imu_idx, mag_idx = 0, mag_total;
+    uint8_t kept = 0;
+    uint32_t start_us = 0, cost_us;
+    float mag_raw[3], mag_cal[3], dt;
+    const struct bmm350_fusion_mag_sample *next;
+    bool have_mag;
+
+    if ((imu != NULL) && (fusion != NULL) && ((mag != NULL) || (mag_len == 0)))
+    {
+        mag_total = (uint16_t)(fusion->n_pending_mag + mag_len);
+
+        for (imu_idx = 0; imu_idx < imu_len; imu_idx++)
+        {
+            if (fusion->time_us != NULL)
+            {
+                start_us = fusion->time_us();
+            }
+
+            /* Advance to the last magnetometer sample at or before the IMU timestamp */
+            while ((mag_idx < mag_total) &&
+                   (mag_sample(mag_idx, mag, fusion)->timestamp_ns <= imu[imu_idx].timestamp_ns))
+            {
+                fusion->last_mag = *mag_sample(mag_idx, mag, fusion);
+                fusion->mag_valid = true;
+                mag_idx++;
+            }
+
+            next = (mag_idx < mag_total) ? mag_sample(mag_idx, mag, fusion) : NULL;
+            have_mag = mag_at(imu[imu_idx].timestamp_ns, next, mag_raw, fusion);
+
+            if (have_mag)
+            {
+                apply_calib(mag_raw, &fusion->calib, mag_cal);
+            }
+            else
+            {
+                fusion->stats.imu_only++;
+            }
+
+            dt = 0.0f;
+
+            if (fusion->imu_valid && (imu[imu_idx].timestamp_ns > fusion->last_imu_ns))
+            {
+                dt = (float)(imu[imu_idx].timestamp_ns - fusion->last_imu_ns) * 1e-9f;
+            }
+
+            update_orientation(imu[imu_idx].gyr, imu[imu_idx].acc, have_mag ? mag_cal : NULL, dt, fusion);
+
+            fusion->last_imu_ns = imu[imu_idx].timestamp_ns;
+            fusion->imu_valid = true;
+            fusion->stats.updates++;
+
+            if (quat != NULL)
+            {
+                quat[imu_idx] = fusion->q;
+            }
+
+            if (fusion->time_us != NULL)
+            {
+                cost_us = fusion->time_us() - start_us;
+                fusion->stats.cost_total_us += cost_us;
+
+                if (cost_us > fusion->stats.cost_max_us)
+                {
+                    fusion->stats.cost_max_us = cost_us;
+                }
+            }
+        }
+
+        /* Keep the magnetometer samples newer than the last IMU sample for the next batch. The pending
+         * samples only move towards the front, so they can be compacted in place */
+        for (; mag_idx < mag_total; mag_idx++)
+        {
+            if (kept < BMM350_FUSION_MAX_PENDING_MAG)
+            {
+                fusion->pending_mag[kept] = *mag_sample(mag_idx, mag, fusion);
+                kept++;
+            }
+            else
+            {
+                fusion->stats.mag_dropped++;
+            }
+        }
+
+        fusion->n_pending_mag = kept;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,232 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_fusion.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_FUSION_H
+#define _BMM350_FUSION_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Default filter gain of the gradient descent step */
+#define BMM350_FUSION_DEFAULT_BETA         (0.1f)
+
+/*! Default time a magnetometer sample is held when no newer sample is available, in ns */
+#define BMM350_FUSION_DEFAULT_MAG_HOLD_NS  UINT64_C(50000000)
+
+/*! Magnetometer samples newer than the last IMU sample that are kept for the next batch */
+#define BMM350_FUSION_MAX_PENDING_MAG      UINT8_C(4)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Function pointer to read a host time in microseconds, used to measure the update cost
+ */
+typedef uint32_t (*bmm350_fusion_time_us_fptr_t)(void);
+
+/*!
+ * @brief Structure to define an IMU sample
+ */
+struct bmm350_fusion_imu_sample
+{
+    /*! Timestamp in ns, on the same time base as the magnetometer samples */
+    uint64_t timestamp_ns;
+
+    /*! Angular rate in rad/s */
+    float gyr[3];
+
+    /*! Acceleration in any unit */
+    float acc[3];
+};
+
+/*!
+ * @brief Structure to define a magnetometer sample
+ */
+struct bmm350_fusion_mag_sample
+{
+    /*! Timestamp in ns, e.g. from bmm350_duty_cycle_ticks_to_ns */
+    uint64_t timestamp_ns;
+
+    /*! Compensated mag data in uT */
+    float mag[3];
+};
+
+/*!
+ * @brief Structure to define the hard and soft iron calibration applied to the magnetometer
+ * samples: mag_cal = soft_iron * (mag - hard_iron)
+ */
+struct bmm350_fusion_calib
+{
+    /*! Hard iron offset in uT */
+    float hard_iron[3];
+
+    /*! Soft iron matrix, row major */
+    float soft_iron[3][3];
+};
+
+/*!
+ * @brief Structure to define an orientation quaternion
+ */
+struct bmm350_fusion_quat
+{
+    float w;
+    float x;
+    float y;
+    float z;
+};
+
+/*!
+ * @brief Structure to define the fusion statistics
+ */
+struct bmm350_fusion_stats
+{
+    /*! Number of filter updates */
+    uint32_t updates;
+
+    /*! Updates with a magnetometer sample interpolated to the IMU timestamp */
+    uint32_t mag_interpolated;
+
+    /*! Updates with the last magnetometer sample held */
+    uint32_t mag_held;
+
+    /*! Updates without magnetometer, gyroscope and accelerometer only */
+    uint32_t imu_only;
+
+    /*! Total and maximum cost of one update in us, only measured if time_us is set */
+    uint32_t cost_total_us;
+    uint32_t cost_max_us;
+
+    /*! Magnetometer samples dropped because more than BMM350_FUSION_MAX_PENDING_MAG were pending */
+    uint32_t mag_dropped;
+};
+
+/*!
+ * @brief Structure to define the state of the fusion adapter
+ */
+struct bmm350_fusion
+{
+    /*! Orientation estimate */
+    struct bmm350_fusion_quat q;
+
+    /*! Filter gain */
+    float beta;
+
+    /*! Maximum age of a held magnetometer sample in ns */
+    uint64_t mag_hold_ns;
+
+    /*! Magnetometer calibration */
+    struct bmm350_fusion_calib calib;
+
+    /*! Optional host time to measure the update cost, NULL to disable */
+    bmm350_fusion_time_us_fptr_t time_us;
+
+    /*! Last magnetometer sample at or before the last IMU sample, kept across batches for interpolation */
+    struct bmm350_fusion_mag_sample last_mag;
+
+    /*! Magnetometer samples newer than the last IMU sample, used ahead of the next batch */
+    struct bmm350_fusion_mag_sample pending_mag[BMM350_FUSION_MAX_PENDING_MAG];
+    uint8_t n_pending_mag;
+
+    /*! Timestamp of the last IMU sample in ns */
+    uint64_t last_imu_ns;
+
+    /*! Flags to track if last_mag and last_imu_ns are valid */
+    bool mag_valid;
+    bool imu_valid;
+
+    /*! Fusion statistics */
+    struct bmm350_fusion_stats stats;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the fusion adapter with identity orientation, identity
+ * calibration and default gain and hold time.
+ *
+ * @param[out] fusion        : Structure that stores the state of the fusion adapter
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_fusion_init(struct bmm350_fusion *fusion);
+
+/*!
+ * @brief Function to run the orientation update for a batch of IMU samples.
+ *
+ * @details For each IMU sample, the magnetometer is linearly interpolated to the IMU timestamp
+ * from the bracketing magnetometer samples, calibrated and normalized, and a Madgwick gradient
+ * descent update is run. If no newer magnetometer sample is available, the last one is held for
+ * up to mag_hold_ns, after that the update uses gyroscope and accelerometer only. Both streams
+ * have to be sorted by time. The magnetometer samples newer than the last IMU sample are kept,
+ * up to BMM350_FUSION_MAX_PENDING_MAG, and used ahead of the magnetometer samples of the next batch.
+ *
+ * @param[in] imu            : IMU samples
+ * @param[in] imu_len        : Number of IMU samples
+ * @param[in] mag            : Magnetometer samples
+ * @param[in] mag_len        : Number of magnetometer samples
+ * @param[out] quat          : Orientation after each IMU sample, imu_len entries, can be NULL
+ * @param[in,out] fusion     : Structure that stores the state of the fusion adapter
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_fusion_update_batch(const struct bmm350_fusion_imu_sample *imu,
+                                  uint16_t imu_len,
+                                  const struct bmm350_fusion_mag_sample *mag,
+                                  uint16_t mag_len,
+                                  struct bmm350_fusion_quat *quat,
+                                  struct bmm350_fusion *fusion);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_FUSION_H */
@@ -0,0 +1,365 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_gradient.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_gradient.h"
+
+/*! Tensor slot (axis * 3 + dir) of each independent component Gxx, Gxy, Gxz, Gyy and Gyz */
+static const uint8_t component_slot[BMM350_GRADIENT_COMPONENTS] = { 0, 1, 2, 4, 5 };
+
+/*!
+ * @brief This internal API is used to invert the normal matrix of the tensor fit by Gauss-Jordan
+ * elimination with partial pivoting. Returns false if a pivot falls below the largest diagonal
+ * element divided by BMM350_GRADIENT_MAX_COND, i.e. the matrix is singular or ill-conditioned
+ * independent of the scale of the sensor positions.
+ */
+static bool invert_normal(float (*mat)[BMM350_GRADIENT_COMPONENTS], float (*inv)[BMM350_GRADIENT_COMPONENTS])
+{
+    uint8_t row, col, pivot, indx;
+    float tmp, factor, min_pivot = 0.0f;
+    bool valid = true;
+
+    for (row = 0; row < BMM350_GRADIENT_COMPONENTS; row++)
+    {
+        for (col = 0; col < BMM350_GRADIENT_COMPONENTS; col++)
+        {
+            inv[row][col] = (row == col) ? 1.0f : 0.0f;
+        }
+
+        if (mat[row][row] > min_pivot)
+        {
+            min_pivot = mat[row][row];
+        }
+    }
+
+    min_pivot /= BMM350_GRADIENT_MAX_COND;
+
+    for (col = 0; (col < BMM350_GRADIENT_COMPONENTS) && valid; col++)
+    {
+        pivot = col;
+
+        for (row = col + 1; row < BMM350_GRADIENT_COMPONENTS; row++)
+        {
+            if (fabsf(mat[row][col]) > fabsf(mat[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+
+        if (!(fabsf(mat[pivot][col]) > min_pivot))
+        {
+            valid = false;
+        }
+        else
+        {
+            for (indx = 0; indx < BMM350_GRADIENT_COMPONENTS; indx++)
+            {
+                tmp = mat[col][indx];
+                mat[col][indx] = mat[pivot][indx];
+                mat[pivot][indx] = tmp;
+                tmp = inv[col][indx];
+                inv[col][indx] = inv[pivot][indx];
+                inv[pivot][indx] = tmp;
+            }
+
+            factor = mat[col][col];
+
+            for (indx = 0; indx < BMM350_GRADIENT_COMPONENTS; indx++)
+            {
+                mat[col][indx] /= factor;
+                inv[col][indx] /= factor;
+            }
+
+            for (row = 0; row < BMM350_GRADIENT_COMPONENTS; row++)
+            {
+                if (row != col)
+                {
+                    factor = mat[row][col];
+
+                    for (indx = 0; indx < BMM350_GRADIENT_COMPONENTS; indx++)
+                    {
+                        mat[row][indx] -= factor * mat[col][indx];
+                        inv[row][indx] -= factor * inv[col][indx];
+                    }
+                }
+            }
+        }
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief This internal API is used to update the baseline and detect an anomaly for one frame.
+ */
+static void check_frame(float frame_norm,
+                        struct bmm350_gradient_event *events,
+                        uint16_t max_events,
+                        uint16_t *n_events,
+                        struct bmm350_gradient *grad)
+{
+    float delta, std, score;
+    bool anomaly = false;
+
+    grad->frame_count++;
+
+    if (grad->frame_count <= grad->learn_frames)
+    {
+        /* Learning: running mean and variance over all frames */
+        delta = frame_norm - grad->base_mean;
+        grad->base_mean += delta / (float)grad->frame_count;
+        grad->base_var += (delta * (frame_norm - grad->base_mean) - grad->base_var) / (float)grad->frame_count;
+    }
+    else
+    {
+        std = sqrtf(grad->base_var);
+        score = (std > 0.0f) ? ((frame_norm - grad->base_mean) / std) : 0.0f;
+        anomaly = (score > grad->threshold_sigma);
+
+        if (anomaly && !grad->in_anomaly && (*n_events < max_events))
+        {
+            events[*n_events].frame = grad->frame_count - 1;
+            events[*n_events].norm = frame_norm;
+            events[*n_events].score = score;
+            (*n_events)++;
+        }
+
+        if (!anomaly)
+        {
+            /* Track slow drift of the baseline with normal frames only */
+            delta = frame_norm - grad->base_mean;
+            grad->base_mean += grad->alpha * delta;
+            grad->base_var += grad->alpha * (delta * delta - grad->base_var);
+        }
+    }
+
+    grad->in_anomaly = anomaly;
+}
+
+/*!
+ * @brief This API is used to initialize the gradient stage.
+ */
+int8_t bmm350_gradient_init(const float (*positions)[3], uint8_t n_sensors, struct bmm350_gradient *grad)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t sensor, axis, row, col;
+    float centroid[3] = { 0.0f };
+    float rel[3];
+    float design[3][BMM350_GRADIENT_MAX_SENSORS][BMM350_GRADIENT_COMPONENTS] = { { { 0.0f } } };
+    float normal[BMM350_GRADIENT_COMPONENTS][BMM350_GRADIENT_COMPONENTS] = { { 0.0f } };
+    float inv[BMM350_GRADIENT_COMPONENTS][BMM350_GRADIENT_COMPONENTS];
+
+    if ((positions != NULL) && (grad != NULL))
+    {
+        if ((n_sensors < BMM350_GRADIENT_MIN_SENSORS) || (n_sensors > BMM350_GRADIENT_MAX_SENSORS))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            for (sensor = 0; sensor < n_sensors; sensor++)
+            {
+                for (col = 0; col < 3; col++)
+                {
+                    centroid[col] += positions[sensor][col] / (float)n_sensors;
+                }
+            }
+
+            /*
+             * Relative to the centroid the offset B0 is the mean field of the array and drops out
+             * of the fit. Each axis of each sensor is one row over [Gxx, Gxy, Gxz, Gyy, Gyz],
+             * with Gzz = -Gxx - Gyy.
+             */
+            for (sensor = 0; sensor < n_sensors; sensor++)
+            {
+                for (col = 0; col < 3; col++)
+                {
+                    rel[col] = positions[sensor][col] - centroid[col];
+                }
+
+                design[0][sensor][0] = rel[0];
+                design[0][sensor][1] = rel[1];
+                design[0][sensor][2] = rel[2];
+                design[1][sensor][1] = rel[0];
+                design[1][sensor][3] = rel[1];
+                design[1][sensor][4] = rel[2];
+                design[2][sensor][0] = -rel[2];
+                design[2][sensor][2] = rel[0];
+                design[2][sensor][3] = -rel[2];
+                design[2][sensor][4] = rel[1];
+
+                for (axis = 0; axis < 3; axis++)
+                {
+                    for (row = 0; row < BMM350_GRADIENT_COMPONENTS; row++)
+                    {
+                        for (col = 0; col < BMM350_GRADIENT_COMPONENTS; col++)
+                        {
+                            normal[row][col] += design[axis][sensor][row] * design[axis][sensor][col];
+                        }
+                    }
+                }
+            }
+
+            if (invert_normal(normal, inv))
+            {
+                /* (A^T A)^-1 A^T maps the field of all sensors to the tensor components */
+                for (row = 0; row < BMM350_GRADIENT_COMPONENTS; row++)
+                {
+                    for (axis = 0; axis < 3; axis++)
+                    {
+                        for (sensor = 0; sensor < n_sensors; sensor++)
+                        {
+                            grad->coeff[row][axis][sensor] = 0.0f;
+
+                            for (col = 0; col < BMM350_GRADIENT_COMPONENTS; col++)
+                            {
+                                grad->coeff[row][axis][sensor] += inv[row][col] * design[axis][sensor][col];
+                            }
+                        }
+                    }
+                }
+
+                grad->n_sensors = n_sensors;
+                grad->learn_frames = BMM350_GRADIENT_DEFAULT_LEARN;
+                grad->threshold_sigma = BMM350_GRADIENT_DEFAULT_SIGMA;
+                grad->alpha = BMM350_GRADIENT_DEFAULT_ALPHA;
+                grad->base_mean = 0.0f;
+                grad->base_var = 0.0f;
+                grad->frame_count = 0;
+                grad->in_anomaly = false;
+            }
+            else
+            {
+                /* Collinear or coincident sensors */
+                rslt = BMM350_E_INVALID_CONFIG;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to compute the gradient tensor of a batch of frames and detect anomalies.
+ */
+int8_t bmm350_gradient_process(const float *field,
+                               uint16_t n_frames,
+                               float *tensor,
+                               float *norm,
+                               struct bmm350_gradient_event *events,
+                               uint16_t max_events,
+                               uint16_t *n_events,
+                               struct bmm350_gradient *grad)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t comp, axis, sensor;
+    uint16_t frame;
+    float weight;
+    float *out;
+    const float *in;
+
+    if ((field != NULL) && (tensor != NULL) && (norm != NULL) && (n_events != NULL) && (grad != NULL) &&
+        ((events != NULL) || (max_events == 0)))
+    {
+        *n_events = 0;
+
+        for (frame = 0; frame < n_frames; frame++)
+        {
+            norm[frame] = 0.0f;
+        }
+
+        for (comp = 0; comp < BMM350_GRADIENT_COMPONENTS; comp++)
+        {
+            out = &tensor[component_slot[comp] * n_frames];
+
+            for (frame = 0; frame < n_frames; frame++)
+            {
+                out[frame] = 0.0f;
+            }
+
+            /* Frame-contiguous inner loops */
+            for (axis = 0; axis < 3; axis++)
+            {
+                for (sensor = 0; sensor < grad->n_sensors; sensor++)
+                {
+                    weight = grad->coeff[comp][axis][sensor];
+                    in = &field[(axis * grad->n_sensors + sensor) * n_frames];
+
+                    for (frame = 0; frame < n_frames; frame++)
+                    {
+                        out[frame] += weight * in[frame];
+                    }
+                }
+            }
+        }
+
+        /* Fill the dependent elements from symmetry and zero trace */
+        for (frame = 0; frame < n_frames; frame++)
+        {
+            tensor[3 * n_frames + frame] = tensor[1 * n_frames + frame];
+            tensor[6 * n_frames + frame] = tensor[2 * n_frames + frame];
+            tensor[7 * n_frames + frame] = tensor[5 * n_frames + frame];
+            tensor[8 * n_frames + frame] = -tensor[frame] - tensor[4 * n_frames + frame];
+        }
+
+        for (comp = 0; comp < 9; comp++)
+        {
+            out = &tensor[comp * n_frames];
+
+            for (frame = 0; frame < n_frames; frame++)
+            {
+                norm[frame] += out[frame] * out[frame];
+            }
+        }
+
+        for (frame = 0; frame < n_frames; frame++)
+        {
+            norm[frame] = sqrtf(norm[frame]);
+            check_frame(norm[frame], events, max_events, n_events, grad);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
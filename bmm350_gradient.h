@@ -0,0 +1,186 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_gradient.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_GRADIENT_H
+#define _BMM350_GRADIENT_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Maximum number of sensors in the array */
+#define BMM350_GRADIENT_MAX_SENSORS       UINT8_C(16)
+
+/*! Minimum number of sensors for a full gradient tensor, which must not be collinear */
+#define BMM350_GRADIENT_MIN_SENSORS       UINT8_C(3)
+
+/*! Number of independent components of the symmetric, traceless gradient tensor */
+#define BMM350_GRADIENT_COMPONENTS        UINT8_C(5)
+
+/*! Largest accepted condition number estimate of the least squares fit */
+#define BMM350_GRADIENT_MAX_COND          (1e6f)
+
+/*! Default number of frames learned before anomaly detection is armed */
+#define BMM350_GRADIENT_DEFAULT_LEARN     UINT32_C(500)
+
+/*! Default anomaly threshold in standard deviations of the baseline */
+#define BMM350_GRADIENT_DEFAULT_SIGMA     (5.0f)
+
+/*! Default weight of the baseline update after learning */
+#define BMM350_GRADIENT_DEFAULT_ALPHA     (0.001f)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define an anomaly event
+ */
+struct bmm350_gradient_event
+{
+    /*! Frame index since init at which the anomaly started */
+    uint32_t frame;
+
+    /*! Gradient norm of the frame in uT/m */
+    float norm;
+
+    /*! Distance from the baseline in standard deviations */
+    float score;
+};
+
+/*!
+ * @brief Structure to define the state of the gradient stage
+ */
+struct bmm350_gradient
+{
+    /*! Number of sensors */
+    uint8_t n_sensors;
+
+    /*! Least squares weight of each axis of each sensor in 1/m for the components Gxx, Gxy, Gxz, Gyy and Gyz */
+    float coeff[BMM350_GRADIENT_COMPONENTS][3][BMM350_GRADIENT_MAX_SENSORS];
+
+    /*! Frames learned before detection is armed */
+    uint32_t learn_frames;
+
+    /*! Anomaly threshold in standard deviations */
+    float threshold_sigma;
+
+    /*! Weight of the baseline update after learning, 0 to freeze the baseline */
+    float alpha;
+
+    /*! Baseline mean and variance of the gradient norm */
+    float base_mean;
+    float base_var;
+
+    /*! Number of frames processed */
+    uint32_t frame_count;
+
+    /*! Flag to track if the previous frame was anomalous */
+    bool in_anomaly;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the gradient stage for sensors at known positions.
+ * The least squares fit B_i = B0 + G * (r_i - r_mean) is solved once here, so a frame costs
+ * 15 * n_sensors multiply-adds. The field is free of sources between the sensors, so G is
+ * symmetric (curl-free) and traceless (divergence-free) and only has 5 independent components;
+ * this lets a planar array of 3 or more sensors resolve the full tensor.
+ *
+ * @param[in] positions      : Sensor positions in m, n_sensors entries
+ * @param[in] n_sensors      : Number of sensors, BMM350_GRADIENT_MIN_SENSORS to BMM350_GRADIENT_MAX_SENSORS
+ * @param[out] grad          : Structure that stores the state of the gradient stage
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Sensor count out of range or positions collinear
+ */
+int8_t bmm350_gradient_init(const float (*positions)[3], uint8_t n_sensors, struct bmm350_gradient *grad);
+
+/*!
+ * @brief Function to compute the gradient tensor of a batch of synchronized frames and detect anomalies.
+ *
+ * @details Buffers are laid out frame-contiguous so the inner loops run over frames:
+ *
+ *@verbatim
+ * field[(axis * n_sensors + sensor) * n_frames + frame]   : calibrated field in uT
+ * tensor[(axis * 3 + dir) * n_frames + frame]            : dB_axis/d_dir in uT/m
+ * norm[frame]                                            : Frobenius norm of the tensor in uT/m
+ *@endverbatim
+ *
+ * During the first learn_frames frames the baseline of the norm is learned. After that, a frame
+ * whose norm is more than threshold_sigma standard deviations above the baseline is anomalous;
+ * an event is reported for the first frame of each anomaly. Normal frames keep updating the
+ * baseline with weight alpha.
+ *
+ * @param[in] field          : Field of all sensors for n_frames frames
+ * @param[in] n_frames       : Number of frames
+ * @param[out] tensor        : Gradient tensor of each frame, 9 * n_frames values
+ * @param[out] norm          : Gradient norm of each frame, n_frames values
+ * @param[out] events        : Anomaly events, can be NULL if max_events is 0
+ * @param[in] max_events     : Capacity of events
+ * @param[out] n_events      : Number of events reported
+ * @param[in,out] grad       : Structure that stores the state of the gradient stage
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_gradient_process(const float *field,
+                               uint16_t n_frames,
+                               float *tensor,
+                               float *norm,
+                               struct bmm350_gradient_event *events,
+                               uint16_t max_events,
+                               uint16_t *n_events,
+                               struct bmm350_gradient *grad);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_GRADIENT_H */
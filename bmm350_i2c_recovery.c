@@ -0,0 +1,234 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_i2c_recovery.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_i2c_recovery.h"
+
+/*!
+ * @brief This internal API is used to check the device after a hang and to restore the reference
+ * configuration if the device lost it.
+ */
+static int8_t resync(struct bmm350_i2c_recovery *rec, struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    uint8_t regs[BMM350_I2C_RECOVERY_CHECK_LEN];
+    uint8_t otp_cmd = BMM350_OTP_CMD_PWR_OFF_OTP;
+    const uint8_t *ref = rec->reference.regs;
+    const uint8_t wdt_msk = BMM350_I2C_WDT_EN_MSK | BMM350_I2C_WDT_SEL_MSK;
+    const uint8_t aggr_msk = BMM350_ODR_MSK | BMM350_AVG_MSK;
+
+    /* One burst from CHIP_ID to I2C_WDT_SET covers the probe and the configuration check */
+    rslt = bmm350_get_regs(BMM350_REG_CHIP_ID, regs, BMM350_I2C_RECOVERY_CHECK_LEN, dev);
+
+    if ((rslt == BMM350_OK) && (regs[BMM350_REG_CHIP_ID] != BMM350_CHIP_ID))
+    {
+        rslt = BMM350_E_DEV_NOT_FOUND;
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        /* The watchdog stays enabled at run time, so a reset of the device always shows here */
+        if (((regs[BMM350_REG_I2C_WDT_SET] & wdt_msk) != (ref[BMM350_REG_I2C_WDT_SET] & wdt_msk)) ||
+            ((regs[BMM350_REG_PMU_CMD_AGGR_SET] & aggr_msk) != (ref[BMM350_REG_PMU_CMD_AGGR_SET] & aggr_msk)) ||
+            ((regs[BMM350_REG_PMU_CMD_AXIS_EN] & BMM350_EN_XYZ_MSK) !=
+             (ref[BMM350_REG_PMU_CMD_AXIS_EN] & BMM350_EN_XYZ_MSK)) ||
+            ((regs[BMM350_REG_PAD_CTRL] & BMM350_DRV_MSK) != (ref[BMM350_REG_PAD_CTRL] & BMM350_DRV_MSK)) ||
+            (BMM350_GET_BITS(regs[BMM350_REG_PMU_CMD_STATUS_0], BMM350_PWR_MODE_IS_NORMAL) !=
+             rec->reference.pmu_cmd_stat_0.pwr_mode_is_normal))
+        {
+            rec->stats.resyncs++;
+
+            /* Same sequence as after boot: OTP off, configuration, then magnetic reset */
+            rslt = bmm350_set_regs(BMM350_REG_OTP_CMD_REG, &otp_cmd, 1, dev);
+
+            if (rslt == BMM350_OK)
+            {
+                rslt = bmm350_restore_reg_snapshot(&rec->reference, dev);
+            }
+
+            if (rslt == BMM350_OK)
+            {
+                rslt = bmm350_magnetic_reset_and_wait(dev);
+            }
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to enable the I2C watchdog and to take the reference configuration.
+ */
+int8_t bmm350_i2c_recovery_init(const struct bmm350_i2c_recovery_config *config,
+                                struct bmm350_i2c_recovery *rec,
+                                struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t gap_us;
+    struct bmm350_i2c_recovery_stats stats = { 0 };
+
+    if ((config != NULL) && (rec != NULL) && (dev != NULL))
+    {
+        if ((config->bus_speed_hz == 0) || (config->max_attempts == 0))
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            /* Longest gap between two clock edges: one byte with acknowledge, or a stall of the host */
+            gap_us = (UINT32_C(9000000) + config->bus_speed_hz - 1) / config->bus_speed_hz;
+
+            if (config->max_host_stall_us > gap_us)
+            {
+                gap_us = config->max_host_stall_us;
+            }
+
+            rec->config = *config;
+            rec->stats = stats;
+
+            if (gap_us <= (BMM350_I2C_WDT_SHORT_US / BMM350_I2C_WDT_MARGIN))
+            {
+                rec->wdt_sel = BMM350_I2C_WDT_SEL_SHORT;
+                rec->wdt_timeout_us = BMM350_I2C_WDT_SHORT_US;
+            }
+            else if (gap_us <= (BMM350_I2C_WDT_LONG_US / BMM350_I2C_WDT_MARGIN))
+            {
+                rec->wdt_sel = BMM350_I2C_WDT_SEL_LONG;
+                rec->wdt_timeout_us = BMM350_I2C_WDT_LONG_US;
+            }
+            else
+            {
+                /* The watchdog would reset healthy transfers */
+                rslt = BMM350_E_INVALID_CONFIG;
+            }
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_set_i2c_wdt(BMM350_I2C_WDT_EN, rec->wdt_sel, dev);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_i2c_recovery_update_reference(rec, dev);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to take the reference configuration again.
+ */
+int8_t bmm350_i2c_recovery_update_reference(struct bmm350_i2c_recovery *rec, struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    if (rec != NULL)
+    {
+        rslt = bmm350_get_reg_snapshot(&rec->reference, dev);
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to handle the result of an API call and to recover a bus hang.
+ */
+int8_t bmm350_i2c_recovery_handle(int8_t rslt, bool *retry, struct bmm350_i2c_recovery *rec, struct bmm350_dev *dev)
+{
+    int8_t rec_rslt = rslt;
+    uint8_t attempt;
+    uint32_t wait_us;
+
+    if ((retry != NULL) && (rec != NULL) && (dev != NULL))
+    {
+        *retry = false;
+
+        if ((rslt == BMM350_E_COM_FAIL) &&
+            ((rec->config.timeout_code == 0) || (dev->intf_rslt == rec->config.timeout_code)))
+        {
+            rec->stats.hangs++;
+
+            for (attempt = 1; (attempt <= rec->config.max_attempts) && !(*retry); attempt++)
+            {
+                /* The sensor releases the bus once its watchdog expired */
+                wait_us = rec->wdt_timeout_us + BMM350_I2C_RECOVERY_GUARD_US;
+                rec_rslt = bmm350_delay_us(wait_us, dev);
+                rec->stats.wait_time_us += wait_us;
+
+                if ((rec_rslt == BMM350_OK) && (rec->config.bus_clear != NULL) &&
+                    (rec->config.bus_clear(dev->intf_ptr) != BMM350_INTF_RET_SUCCESS))
+                {
+                    rec_rslt = BMM350_E_COM_FAIL;
+                }
+
+                if (rec_rslt == BMM350_OK)
+                {
+                    rec_rslt = resync(rec, dev);
+                }
+
+                (void)bmm350_log_event(BMM350_EVENT_RETRY, rec_rslt, attempt, dev);
+
+                *retry = (rec_rslt == BMM350_OK);
+            }
+
+            if (*retry)
+            {
+                rec->stats.recoveries++;
+            }
+            else
+            {
+                rec->stats.failures++;
+            }
+        }
+    }
+    else
+    {
+        rec_rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rec_rslt;
+}
@@ -0,0 +1,199 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_i2c_recovery.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_I2C_RECOVERY_H
+#define _BMM350_I2C_RECOVERY_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Timeouts of the sensor I2C watchdog in us */
+#define BMM350_I2C_WDT_SHORT_US         UINT32_C(1280)
+#define BMM350_I2C_WDT_LONG_US          UINT32_C(40960)
+
+/*! Factor by which the watchdog timeout must exceed the longest gap between two clock edges of a healthy transfer */
+#define BMM350_I2C_WDT_MARGIN           UINT8_C(4)
+
+/*! Time added to the watchdog timeout before the bus is used again, in us */
+#define BMM350_I2C_RECOVERY_GUARD_US    UINT32_C(200)
+
+/*! Registers read to check the device after a recovery: CHIP_ID to I2C_WDT_SET */
+#define BMM350_I2C_RECOVERY_CHECK_LEN   UINT8_C(11)
+
+/*!
+ * @brief Bus clear function pointer which should be mapped to the platform specific
+ * recovery of the host controller, e.g. nine clock pulses and a stop condition,
+ * or a reset of the I2C peripheral
+ *
+ * @param[in, out] intf_ptr : Void pointer that can enable the linking of descriptors
+ *                            for interface related call backs
+ *
+ * retval = 0 -> Success
+ * retval < 0 -> Failure
+ */
+typedef BMM350_INTF_RET_TYPE (*bmm350_bus_clear_fptr_t)(void *intf_ptr);
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the I2C recovery configuration
+ */
+struct bmm350_i2c_recovery_config
+{
+    /*! I2C clock in Hz */
+    uint32_t bus_speed_hz;
+
+    /*! Longest time the host may pause a transfer, e.g. interrupt latency of a byte-wise controller, in us */
+    uint32_t max_host_stall_us;
+
+    /*! Value the read and write callbacks return when the transport timed out.
+     *  0 handles every BMM350_E_COM_FAIL as a possible hang. */
+    BMM350_INTF_RET_TYPE timeout_code;
+
+    /*! Bus clear function pointer, optional */
+    bmm350_bus_clear_fptr_t bus_clear;
+
+    /*! Recovery attempts before the hang is reported */
+    uint8_t max_attempts;
+};
+
+/*!
+ * @brief Structure to define the I2C recovery statistics
+ */
+struct bmm350_i2c_recovery_stats
+{
+    /*! Number of hangs detected */
+    uint32_t hangs;
+
+    /*! Number of hangs recovered */
+    uint32_t recoveries;
+
+    /*! Number of hangs not recovered within max_attempts */
+    uint32_t failures;
+
+    /*! Number of recoveries that found the configuration lost and restored it */
+    uint32_t resyncs;
+
+    /*! Total time waited for the watchdog in us */
+    uint32_t wait_time_us;
+};
+
+/*!
+ * @brief Structure to define the state of the I2C recovery
+ */
+struct bmm350_i2c_recovery
+{
+    /*! Recovery configuration */
+    struct bmm350_i2c_recovery_config config;
+
+    /*! Recovery statistics */
+    struct bmm350_i2c_recovery_stats stats;
+
+    /*! Watchdog period selected and its timeout in us */
+    enum bmm350_i2c_wdt_sel wdt_sel;
+    uint32_t wdt_timeout_us;
+
+    /*! Configuration the device is resynchronized to */
+    struct bmm350_reg_snapshot reference;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to enable the I2C watchdog of the sensor and to take the reference configuration.
+ *
+ * @details The short timeout (1.28ms) is selected when it exceeds the longest gap between two clock edges
+ * (one byte with acknowledge at bus_speed_hz, or max_host_stall_us) by BMM350_I2C_WDT_MARGIN, the long
+ * timeout (40.96ms) otherwise. A hang then costs about the watchdog timeout instead of a host reboot.
+ * Call this API after the sensor is configured.
+ *
+ * @param[in] config         : Recovery configuration
+ * @param[out] rec           : Structure that stores the state of the recovery
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_i2c_recovery_init(const struct bmm350_i2c_recovery_config *config,
+                                struct bmm350_i2c_recovery *rec,
+                                struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to take the reference configuration again. Call it after the sensor was reconfigured.
+ *
+ * @param[in,out] rec        : Structure that stores the state of the recovery
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_i2c_recovery_update_reference(struct bmm350_i2c_recovery *rec, struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to handle the result of an API call. A transport timeout is handled as a bus hang:
+ * the watchdog timeout is waited for, the host bus is cleared and the device is probed. If the device
+ * lost its configuration, the reference configuration is restored and a magnetic reset is run.
+ *
+ * @param[in] rslt           : Result of the API call
+ * @param[out] retry         : True when a hang was recovered and the call should be repeated
+ * @param[in,out] rec        : Structure that stores the state of the recovery
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status: rslt if it was not a hang, the result of the recovery otherwise
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_i2c_recovery_handle(int8_t rslt, bool *retry, struct bmm350_i2c_recovery *rec, struct bmm350_dev *dev);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_I2C_RECOVERY_H */
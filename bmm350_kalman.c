@@ -0,0 +1,198 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_kalman.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_kalman.h"
+
+/*!
+ * @brief This internal API is used to start an axis from its first measurement.
+ */
+static void start_axis(float meas, float dt, struct bmm350_kf_axis *axis)
+{
+    axis->field = meas;
+    axis->rate = 0.0f;
+    axis->p00 = axis->noise_var;
+    axis->p01 = 0.0f;
+
+    /* Unknown rate: one noise step per sample */
+    axis->p11 = axis->noise_var / (dt * dt);
+    axis->innov_var = axis->noise_var;
+}
+
+/*!
+ * @brief This internal API is used to run one predict and update step of an axis.
+ */
+static float update_axis(float meas, const struct bmm350_kf *kf, struct bmm350_kf_axis *axis)
+{
+    float dt = kf->dt;
+    float innov, innov_cov, gain0, gain1, p01;
+    float noise_var, excess;
+
+    /* kf->process is the process noise without adaptation and its lower bound with, it may have changed since */
+    if ((kf->alpha <= 0.0f) || (axis->process < kf->process))
+    {
+        axis->process = kf->process;
+    }
+
+    /* Predict with the constant rate model and white rate noise */
+    axis->field += axis->rate * dt;
+    axis->p00 += dt * (2.0f * axis->p01 + dt * axis->p11) + axis->process * dt * dt * dt / 3.0f;
+    axis->p01 += dt * axis->p11 + axis->process * dt * dt / 2.0f;
+    axis->p11 += axis->process * dt;
+
+    innov = meas - axis->field;
+
+    if (kf->alpha > 0.0f)
+    {
+        /* Adapt measurement noise: innovation variance minus predicted state variance, bounded so that a
+         * model lagging the field is not taken for sensor noise */
+        axis->innov_var += kf->alpha * (innov * innov - axis->innov_var);
+        noise_var = axis->innov_var - axis->p00;
+        noise_var = (noise_var > axis->noise_var_min) ? noise_var : axis->noise_var_min;
+        axis->noise_var = (noise_var < axis->noise_var_max) ? noise_var : axis->noise_var_max;
+
+        /* Adapt process noise: scale it by the innovation variance left unexplained */
+        excess = axis->innov_var / (axis->p00 + axis->noise_var);
+        axis->process *= 1.0f + kf->alpha * (excess - 1.0f);
+
+        if (axis->process < kf->process)
+        {
+            axis->process = kf->process;
+        }
+        else if (axis->process > (kf->process * BMM350_KF_MAX_PROCESS_GAIN))
+        {
+            axis->process = kf->process * BMM350_KF_MAX_PROCESS_GAIN;
+        }
+    }
+
+    innov_cov = axis->p00 + axis->noise_var;
+    gain0 = axis->p00 / innov_cov;
+    gain1 = axis->p01 / innov_cov;
+
+    axis->field += gain0 * innov;
+    axis->rate += gain1 * innov;
+
+    p01 = axis->p01;
+    axis->p11 -= gain1 * p01;
+    axis->p01 = (1.0f - gain0) * p01;
+    axis->p00 = (1.0f - gain0) * axis->p00;
+
+    return axis->field;
+}
+
+/*!
+ * @brief This API is used to initialize the filter for an ODR and averaging configuration.
+ */
+int8_t bmm350_kf_init(enum bmm350_data_rates odr, enum bmm350_performance_parameters avg, struct bmm350_kf *kf)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx;
+    float noise[3] = { BMM350_NOISE_XY_NO_AVG_UT, BMM350_NOISE_XY_NO_AVG_UT, BMM350_NOISE_Z_NO_AVG_UT };
+
+    if (kf != NULL)
+    {
+        if ((odr < BMM350_DATA_RATE_400HZ) || (odr > BMM350_DATA_RATE_1_5625HZ) || (avg > BMM350_AVERAGING_8))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            kf->dt = (float)(UINT16_C(1) << odr) / BMM350_ODR_BASE_HZ;
+            kf->process = BMM350_KF_DEFAULT_PROCESS;
+            kf->alpha = BMM350_KF_DEFAULT_ALPHA;
+            kf->started = false;
+
+            for (indx = 0; indx < 3; indx++)
+            {
+                /* Averaging 2^avg samples divides the noise variance by 2^avg */
+                kf->axis[indx].noise_var = (noise[indx] * noise[indx]) / (float)(UINT8_C(1) << avg);
+                kf->axis[indx].noise_var_min = kf->axis[indx].noise_var * BMM350_KF_MIN_NOISE_FRACTION;
+                kf->axis[indx].noise_var_max = kf->axis[indx].noise_var * BMM350_KF_MAX_NOISE_FACTOR;
+                kf->axis[indx].process = kf->process;
+                start_axis(0.0f, kf->dt, &kf->axis[indx]);
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to filter a block of samples.
+ */
+int8_t bmm350_kf_process_block(const struct bmm350_mag_temp_data *in,
+                               struct bmm350_mag_temp_data *out,
+                               uint16_t len,
+                               struct bmm350_kf *kf)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t indx = 0;
+    float temperature;
+
+    if ((in != NULL) && (out != NULL) && (kf != NULL))
+    {
+        if (!kf->started && (len > 0))
+        {
+            start_axis(in[0].x, kf->dt, &kf->axis[0]);
+            start_axis(in[0].y, kf->dt, &kf->axis[1]);
+            start_axis(in[0].z, kf->dt, &kf->axis[2]);
+            kf->started = true;
+
+            out[0] = in[0];
+            indx = 1;
+        }
+
+        for (; indx < len; indx++)
+        {
+            temperature = in[indx].temperature;
+            out[indx].x = update_axis(in[indx].x, kf, &kf->axis[0]);
+            out[indx].y = update_axis(in[indx].y, kf, &kf->axis[1]);
+            out[indx].z = update_axis(in[indx].z, kf, &kf->axis[2]);
+            out[indx].temperature = temperature;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,172 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_kalman.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_KALMAN_H
+#define _BMM350_KALMAN_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Nominal RMS noise without averaging in uT, see bmm350_defs.h */
+#define BMM350_KF_NOISE_XY_NO_AVG     BMM350_NOISE_XY_NO_AVG_UT
+#define BMM350_KF_NOISE_Z_NO_AVG      BMM350_NOISE_Z_NO_AVG_UT
+
+/*! Base rate of the ODR setting: ODR = 1600Hz / 2^odr */
+#define BMM350_KF_ODR_BASE_HZ         BMM350_ODR_BASE_HZ
+
+/*! Default process noise: white field acceleration spectral density in uT^2/s^3. It is the lower bound of
+ * the adaptive process noise, see examples/bmm350_kalman_noise */
+#define BMM350_KF_DEFAULT_PROCESS     (0.5f)
+
+/*! Default weight of the streaming innovation variance estimate */
+#define BMM350_KF_DEFAULT_ALPHA       (0.01f)
+
+/*! Adaptive measurement noise is not allowed below this fraction of the nominal noise variance */
+#define BMM350_KF_MIN_NOISE_FRACTION  (0.1f)
+
+/*! Adaptive measurement noise is not allowed above this multiple of the nominal noise variance; the
+ * innovation variance it leaves unexplained is model error and raises the process noise */
+#define BMM350_KF_MAX_NOISE_FACTOR    (4.0f)
+
+/*! Adaptive process noise is not allowed above this multiple of the configured process noise */
+#define BMM350_KF_MAX_PROCESS_GAIN    (1e5f)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the state of one axis: field and field rate with covariance
+ */
+struct bmm350_kf_axis
+{
+    /*! Filtered field in uT */
+    float field;
+
+    /*! Field rate in uT/s */
+    float rate;
+
+    /*! Covariance P = [p00 p01; p01 p11] */
+    float p00, p01, p11;
+
+    /*! Measurement noise variance in uT^2 */
+    float noise_var;
+
+    /*! Lower and upper bound of noise_var */
+    float noise_var_min;
+    float noise_var_max;
+
+    /*! Adaptive process noise spectral density in uT^2/s^3 */
+    float process;
+
+    /*! Streaming estimate of the innovation variance */
+    float innov_var;
+};
+
+/*!
+ * @brief Structure to define the state of the per-axis Kalman filter
+ */
+struct bmm350_kf
+{
+    /*! X, Y and Z axis state */
+    struct bmm350_kf_axis axis[3];
+
+    /*! Sample period in s */
+    float dt;
+
+    /*! Process noise spectral density in uT^2/s^3, the lower bound of the adaptive process noise */
+    float process;
+
+    /*! Weight of the streaming innovation variance estimate, 0 disables adaptation */
+    float alpha;
+
+    /*! Flag to track if the filter is initialized with a first sample */
+    bool started;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the filter for an ODR and averaging configuration. The
+ * sample period follows from the ODR and the measurement noise from the averaging.
+ *
+ * @param[in] odr            : ODR configured with bmm350_set_odr_performance
+ * @param[in] avg            : Averaging configured with bmm350_set_odr_performance
+ * @param[out] kf            : Structure that stores the state of the filter
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_kf_init(enum bmm350_data_rates odr, enum bmm350_performance_parameters avg, struct bmm350_kf *kf);
+
+/*!
+ * @brief Function to filter a block of samples. Each sample costs one predict and one update per
+ * axis. When alpha is non zero, the measurement noise follows the innovation variance within
+ * BMM350_KF_MIN_NOISE_FRACTION and BMM350_KF_MAX_NOISE_FACTOR of the nominal noise, and the process noise
+ * grows while the innovations exceed what the model and the measurement noise explain, e.g. when the
+ * field changes faster than process allows, and falls back to process when they agree again.
+ * Temperature is passed through. in and out may point to the same buffer.
+ *
+ * @param[in] in             : Compensated samples
+ * @param[out] out           : Filtered samples
+ * @param[in] len            : Number of samples
+ * @param[in,out] kf         : Structure that stores the state of the filter
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_kf_process_block(const struct bmm350_mag_temp_data *in,
+                               struct bmm350_mag_temp_data *out,
+                               uint16_t len,
+                               struct bmm350_kf *kf);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_KALMAN_H */
@@ -0,0 +1,294 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_lod.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_lod.h"
+
+/*!
+ * @brief This internal API is used to empty a node.
+ */
+static void clear_node(struct bmm350_lod_node *node)
+{
+    uint8_t chan;
+
+    for (chan = 0; chan < BMM350_LOD_CHANNELS; chan++)
+    {
+        node->min[chan] = 0.0f;
+        node->max[chan] = 0.0f;
+        node->mean[chan] = 0.0f;
+    }
+
+    node->count = 0;
+}
+
+/*!
+ * @brief This internal API is used to merge node src into node dst.
+ */
+static void merge_node(struct bmm350_lod_node *dst, const struct bmm350_lod_node *src)
+{
+    uint8_t chan;
+    float weight;
+
+    if (src->count > 0)
+    {
+        if (dst->count == 0)
+        {
+            *dst = *src;
+        }
+        else
+        {
+            weight = (float)src->count / (float)(dst->count + src->count);
+
+            for (chan = 0; chan < BMM350_LOD_CHANNELS; chan++)
+            {
+                dst->min[chan] = (src->min[chan] < dst->min[chan]) ? src->min[chan] : dst->min[chan];
+                dst->max[chan] = (src->max[chan] > dst->max[chan]) ? src->max[chan] : dst->max[chan];
+                dst->mean[chan] += weight * (src->mean[chan] - dst->mean[chan]);
+            }
+
+            dst->count += src->count;
+        }
+    }
+}
+
+/*!
+ * @brief This internal API is used to store a complete node in a level and propagate it upwards.
+ */
+static void complete_node(uint8_t lvl, struct bmm350_lod *lod)
+{
+    struct bmm350_lod_level *level = &lod->level[lvl];
+
+    if (level->count < level->capacity)
+    {
+        level->nodes[level->count] = lod->pending[lvl];
+        level->count++;
+    }
+    else
+    {
+        level->overflow = true;
+    }
+
+    if ((lvl + 1) < lod->n_levels)
+    {
+        merge_node(&lod->pending[lvl + 1], &lod->pending[lvl]);
+
+        if (lod->pending[lvl + 1].count == (lod->pending[lvl].count * lod->factor))
+        {
+            complete_node(lvl + 1, lod);
+        }
+    }
+
+    clear_node(&lod->pending[lvl]);
+}
+
+/*!
+ * @brief This API is used to initialize an empty pyramid.
+ */
+int8_t bmm350_lod_init(uint8_t factor,
+                       uint8_t n_levels,
+                       struct bmm350_lod_node * const *nodes,
+                       const uint32_t *capacity,
+                       struct bmm350_lod *lod)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t lvl;
+
+    if ((nodes != NULL) && (capacity != NULL) && (lod != NULL))
+    {
+        if ((factor < 2) || (n_levels == 0) || (n_levels > BMM350_LOD_MAX_LEVELS))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+
+        for (lvl = 0; (lvl < n_levels) && (rslt == BMM350_OK); lvl++)
+        {
+            if ((nodes[lvl] == NULL) && (capacity[lvl] > 0))
+            {
+                rslt = BMM350_E_NULL_PTR;
+            }
+            else
+            {
+                lod->level[lvl].nodes = nodes[lvl];
+                lod->level[lvl].capacity = capacity[lvl];
+                lod->level[lvl].count = 0;
+                lod->level[lvl].overflow = false;
+                clear_node(&lod->pending[lvl]);
+            }
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            lod->factor = factor;
+            lod->n_levels = n_levels;
+            lod->sample_count = 0;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to add recorded samples to the pyramid.
+ */
+int8_t bmm350_lod_add(const struct bmm350_mag_temp_data *data, uint16_t len, struct bmm350_lod *lod)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t indx;
+    uint8_t chan;
+    float value[BMM350_LOD_CHANNELS];
+    struct bmm350_lod_node *node;
+
+    if ((data != NULL) && (lod != NULL))
+    {
+        node = &lod->pending[0];
+
+        for (indx = 0; indx < len; indx++)
+        {
+            value[0] = data[indx].x;
+            value[1] = data[indx].y;
+            value[2] = data[indx].z;
+            value[3] = data[indx].temperature;
+
+            node->count++;
+
+            for (chan = 0; chan < BMM350_LOD_CHANNELS; chan++)
+            {
+                if ((node->count == 1) || (value[chan] < node->min[chan]))
+                {
+                    node->min[chan] = value[chan];
+                }
+
+                if ((node->count == 1) || (value[chan] > node->max[chan]))
+                {
+                    node->max[chan] = value[chan];
+                }
+
+                node->mean[chan] += (value[chan] - node->mean[chan]) / (float)node->count;
+            }
+
+            if (node->count == lod->factor)
+            {
+                complete_node(0, lod);
+            }
+        }
+
+        lod->sample_count += len;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to summarize a sample range in n_buckets buckets.
+ */
+int8_t bmm350_lod_query(uint64_t first,
+                        uint64_t last,
+                        struct bmm350_lod_node *buckets,
+                        uint16_t n_buckets,
+                        uint8_t *used_level,
+                        const struct bmm350_lod *lod)
+{
+    int8_t rslt = BMM350_OK;
+    uint64_t span, node_len, start, end, node;
+    uint16_t bucket;
+    uint8_t lvl = 0;
+    const struct bmm350_lod_level *level;
+
+    if ((buckets != NULL) && (lod != NULL))
+    {
+        if ((last < first) || (n_buckets == 0))
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            span = last - first + 1;
+            node_len = lod->factor;
+
+            /* Coarsest level with nodes not longer than a bucket */
+            while (((lvl + 1) < lod->n_levels) && ((node_len * lod->factor * n_buckets) <= span))
+            {
+                node_len *= lod->factor;
+                lvl++;
+            }
+
+            level = &lod->level[lvl];
+
+            for (bucket = 0; bucket < n_buckets; bucket++)
+            {
+                clear_node(&buckets[bucket]);
+
+                /* A node belongs to the bucket that holds its first sample, so that no node is
+                 * counted twice; the first bucket also takes the node the range starts in */
+                if (bucket == 0)
+                {
+                    start = first / node_len;
+                }
+                else
+                {
+                    start = (first + (span * bucket) / n_buckets + node_len - 1u) / node_len;
+                }
+
+                end = (first + (span * (bucket + 1u)) / n_buckets + node_len - 1u) / node_len;
+
+                for (node = start; (node < end) && (node < level->count); node++)
+                {
+                    merge_node(&buckets[bucket], &level->nodes[node]);
+                }
+            }
+
+            if (used_level != NULL)
+            {
+                *used_level = lvl;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
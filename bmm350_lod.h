@@ -0,0 +1,188 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_lod.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_LOD_H
+#define _BMM350_LOD_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Maximum number of levels */
+#define BMM350_LOD_MAX_LEVELS        UINT8_C(12)
+
+/*! Channels of a node: x, y, z and temperature */
+#define BMM350_LOD_CHANNELS          UINT8_C(4)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define a node of the pyramid: min, max and mean of a sample range
+ */
+struct bmm350_lod_node
+{
+    /*! Minimum, maximum and mean of x, y, z in uT and temperature in degC */
+    float min[BMM350_LOD_CHANNELS];
+    float max[BMM350_LOD_CHANNELS];
+    float mean[BMM350_LOD_CHANNELS];
+
+    /*! Number of samples, 0 for an empty node */
+    uint32_t count;
+};
+
+/*!
+ * @brief Structure to define a level of the pyramid. Node i of level L covers the samples
+ * i * factor^(L+1) to (i + 1) * factor^(L+1) - 1.
+ */
+struct bmm350_lod_level
+{
+    /*! Node storage, provided by the application */
+    struct bmm350_lod_node *nodes;
+
+    /*! Capacity of nodes */
+    uint32_t capacity;
+
+    /*! Number of complete nodes */
+    uint32_t count;
+
+    /*! Flag set if nodes were dropped because the level is full */
+    bool overflow;
+};
+
+/*!
+ * @brief Structure to define the state of the pyramid
+ */
+struct bmm350_lod
+{
+    /*! Reduction factor between levels */
+    uint8_t factor;
+
+    /*! Number of levels */
+    uint8_t n_levels;
+
+    /*! Levels, level 0 aggregates factor samples */
+    struct bmm350_lod_level level[BMM350_LOD_MAX_LEVELS];
+
+    /*! Node in progress of each level */
+    struct bmm350_lod_node pending[BMM350_LOD_MAX_LEVELS];
+
+    /*! Number of samples added */
+    uint64_t sample_count;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize an empty pyramid on application provided storage.
+ *
+ * @details Level L needs total_samples / factor^(L+1) nodes, so all levels together need
+ * about total_samples / (factor - 1) nodes. The level arrays can be written next to the
+ * recording and loaded again with the counts.
+ *
+ * @param[in] factor         : Reduction factor between levels, at least 2
+ * @param[in] n_levels       : Number of levels, 1 to BMM350_LOD_MAX_LEVELS
+ * @param[in] nodes          : Storage of each level, n_levels entries
+ * @param[in] capacity       : Capacity of each level, n_levels entries
+ * @param[out] lod           : Structure that stores the state of the pyramid
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Factor or number of levels out of range
+ */
+int8_t bmm350_lod_init(uint8_t factor,
+                       uint8_t n_levels,
+                       struct bmm350_lod_node * const *nodes,
+                       const uint32_t *capacity,
+                       struct bmm350_lod *lod);
+
+/*!
+ * @brief Function to add recorded samples to the pyramid. A level that is full stops storing
+ * nodes and sets its overflow flag; the other levels continue.
+ *
+ * @param[in] data           : Compensated samples
+ * @param[in] len            : Number of samples
+ * @param[in,out] lod        : Structure that stores the state of the pyramid
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_lod_add(const struct bmm350_mag_temp_data *data, uint16_t len, struct bmm350_lod *lod);
+
+/*!
+ * @brief Function to summarize a sample range in n_buckets buckets, e.g. one per pixel.
+ *
+ * @details The query uses the coarsest level whose nodes are not longer than a bucket, so the cost
+ * is at most (factor + 1) nodes per bucket whatever the length of the range. Each node of that level
+ * goes to the bucket that holds its first sample, and the first bucket also takes the node the range
+ * starts in, so every node is counted once. Buckets shorter than factor samples are answered
+ * from level 0; read the raw samples to zoom further. Samples that are not yet in a complete
+ * level 0 node are not included, and a bucket without data has a count of 0.
+ *
+ * @param[in] first          : First sample of the range
+ * @param[in] last           : Last sample of the range, inclusive
+ * @param[out] buckets       : Summary of each bucket
+ * @param[in] n_buckets      : Number of buckets
+ * @param[out] used_level    : Level used for the query, can be NULL
+ * @param[in] lod            : Structure that stores the state of the pyramid
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_INPUT -> Empty range or no bucket
+ */
+int8_t bmm350_lod_query(uint64_t first,
+                        uint64_t last,
+                        struct bmm350_lod_node *buckets,
+                        uint16_t n_buckets,
+                        uint8_t *used_level,
+                        const struct bmm350_lod *lod);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_LOD_H */
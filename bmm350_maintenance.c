@@ -0,0 +1,304 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_maintenance.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_maintenance.h"
+
+/*!
+ * @brief This internal API is used to get the idle window until the next expected sample.
+ */
+static uint32_t idle_window_us(uint32_t now_us, const struct bmm350_maint *maint)
+{
+    uint32_t window = UINT32_MAX;
+    uint32_t since_sample;
+
+    if (maint->sampling && (maint->sample_interval_us > 0))
+    {
+        since_sample = now_us - maint->last_sample_us;
+
+        if (since_sample < maint->sample_interval_us)
+        {
+            window = maint->sample_interval_us - since_sample;
+        }
+        else if (since_sample < (maint->sample_interval_us * BMM350_MAINT_IDLE_INTERVALS))
+        {
+            /* Next sample is already due */
+            window = 0;
+        }
+    }
+
+    return window;
+}
+
+/*!
+ * @brief This internal API is used to run a magnetic reset and update the statistics.
+ */
+static int8_t run_reset(enum bmm350_magreset_type reset_type,
+                        uint32_t now_us,
+                        uint32_t idle_us,
+                        struct bmm350_maint *maint,
+                        struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    uint32_t duration;
+
+    rslt = bmm350_magnetic_reset(reset_type, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        duration = bmm350_maint_reset_duration_us(reset_type, maint->config.normal_mode);
+
+        maint->stats.maint_time_us += duration;
+        maint->pending_flags |= BMM350_MAINT_FLAG_AFTER_RESET;
+
+        if (duration > idle_us)
+        {
+            maint->stats.data_time_lost_us += duration - idle_us;
+            maint->pending_flags |= BMM350_MAINT_FLAG_DELAYED;
+        }
+
+        maint->last_reset_us = now_us;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to initialize the maintenance scheduler.
+ */
+int8_t bmm350_maint_init(const struct bmm350_maint_config *config, uint32_t now_us, struct bmm350_maint *maint)
+{
+    int8_t rslt = BMM350_OK;
+    struct bmm350_maint_stats stats = { 0 };
+
+    if ((config != NULL) && (maint != NULL))
+    {
+        if ((config->reset_period_us == 0) || (config->full_reset == BMM350_NOMAGRESET) ||
+            (config->fast_reset == BMM350_NOMAGRESET))
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            maint->config = *config;
+            maint->stats = stats;
+            maint->last_reset_us = now_us;
+            maint->last_sample_us = now_us;
+            maint->sample_interval_us = 0;
+            maint->pending_flags = BMM350_MAINT_FLAG_NONE;
+            maint->sampling = false;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to register an acquired sample.
+ */
+int8_t bmm350_maint_sample(uint32_t now_us, uint8_t *flags, struct bmm350_maint *maint)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t interval;
+
+    if ((flags != NULL) && (maint != NULL))
+    {
+        if (maint->sampling)
+        {
+            interval = now_us - maint->last_sample_us;
+
+            /* Samples delayed by maintenance or after a pause do not describe the acquisition rate */
+            if ((maint->pending_flags & BMM350_MAINT_FLAG_DELAYED) == 0)
+            {
+                if ((maint->sample_interval_us == 0) ||
+                    (interval >= (maint->sample_interval_us * BMM350_MAINT_IDLE_INTERVALS)))
+                {
+                    maint->sample_interval_us = interval;
+                }
+                else
+                {
+                    /* Exponential average with a weight of 1/8 */
+                    maint->sample_interval_us = maint->sample_interval_us - (maint->sample_interval_us / 8) +
+                                                (interval / 8);
+                }
+            }
+        }
+
+        *flags = maint->pending_flags;
+
+        if (maint->pending_flags != BMM350_MAINT_FLAG_NONE)
+        {
+            maint->stats.flagged_samples++;
+        }
+
+        maint->pending_flags = BMM350_MAINT_FLAG_NONE;
+        maint->last_sample_us = now_us;
+        maint->sampling = true;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to run a due magnetic reset if the idle window allows it.
+ */
+int8_t bmm350_maint_run(uint32_t now_us,
+                        enum bmm350_magreset_type *reset_type,
+                        struct bmm350_maint *maint,
+                        struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t elapsed, idle, window;
+    enum bmm350_magreset_type selected = BMM350_NOMAGRESET;
+    bool full = false, forced = false;
+
+    if ((reset_type != NULL) && (maint != NULL))
+    {
+        elapsed = now_us - maint->last_reset_us;
+
+        if (elapsed >= maint->config.reset_period_us)
+        {
+            idle = idle_window_us(now_us, maint);
+
+            window = idle;
+
+            if (window <= (UINT32_MAX - maint->config.latency_budget_us))
+            {
+                window += maint->config.latency_budget_us;
+            }
+
+            if (bmm350_maint_reset_duration_us(maint->config.full_reset, maint->config.normal_mode) <= window)
+            {
+                selected = maint->config.full_reset;
+                full = true;
+            }
+            else if (bmm350_maint_reset_duration_us(maint->config.fast_reset, maint->config.normal_mode) <= window)
+            {
+                selected = maint->config.fast_reset;
+            }
+            else if ((elapsed - maint->config.reset_period_us) >= maint->config.max_defer_us)
+            {
+                selected = maint->config.fast_reset;
+                forced = true;
+            }
+            else
+            {
+                maint->stats.deferrals++;
+            }
+
+            if (selected != BMM350_NOMAGRESET)
+            {
+                rslt = run_reset(selected, now_us, idle, maint, dev);
+
+                /* Only resets that completed count as run */
+                if (rslt != BMM350_OK)
+                {
+                    maint->stats.failed_resets++;
+                    selected = BMM350_NOMAGRESET;
+                }
+                else if (full)
+                {
+                    maint->stats.full_resets++;
+                }
+                else
+                {
+                    maint->stats.fast_resets++;
+
+                    if (forced)
+                    {
+                        maint->stats.forced_resets++;
+                    }
+                }
+            }
+        }
+
+        *reset_type = selected;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the time a magnetic reset blocks the sensor.
+ */
+uint32_t bmm350_maint_reset_duration_us(enum bmm350_magreset_type reset_type, bool normal_mode)
+{
+    uint32_t duration;
+
+    switch (reset_type)
+    {
+        case BMM350_FLUXGUIDE_9MS:
+            duration = (uint32_t)BMM350_BR_DELAY + BMM350_FGR_DELAY;
+            break;
+
+        case BMM350_FLUXGUIDE_FAST:
+            duration = (uint32_t)BMM350_BR_FAST_DELAY + BMM350_FGR_FAST_DELAY;
+            break;
+
+        case BMM350_BITRESET_9MS:
+            duration = BMM350_BR_DELAY;
+            break;
+
+        case BMM350_BITRESET_FAST:
+            duration = BMM350_BR_FAST_DELAY;
+            break;
+
+        default:
+            duration = 0;
+            break;
+    }
+
+    /* A reset in normal mode goes through suspend and back to normal mode */
+    if (normal_mode && (duration > 0))
+    {
+        duration += BMM350_GOTO_SUSPEND_DELAY + BMM350_SUSPEND_TO_NORMAL_DELAY;
+    }
+
+    return duration;
+}
@@ -0,0 +1,217 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_maintenance.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_MAINTENANCE_H
+#define _BMM350_MAINTENANCE_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Sample flags returned by bmm350_maint_sample */
+#define BMM350_MAINT_FLAG_NONE         UINT8_C(0x00)
+
+/*! A magnetic reset ran since the previous sample */
+#define BMM350_MAINT_FLAG_AFTER_RESET  UINT8_C(0x01)
+
+/*! The magnetic reset overlapped the expected time of this sample */
+#define BMM350_MAINT_FLAG_DELAYED      UINT8_C(0x02)
+
+/*! Acquisition is considered stopped when no sample arrived for this many sample intervals */
+#define BMM350_MAINT_IDLE_INTERVALS    UINT8_C(4)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the maintenance scheduler configuration
+ */
+struct bmm350_maint_config
+{
+    /*! Nominal time between two magnetic resets in us */
+    uint32_t reset_period_us;
+
+    /*! Time a due reset may be deferred while waiting for an idle window, in us.
+     *  Once exceeded, the fast reset is run even if it delays a sample. */
+    uint32_t max_defer_us;
+
+    /*! Time the consumer accepts a sample to be delayed by maintenance, in us */
+    uint32_t latency_budget_us;
+
+    /*! Reset run when the idle window allows it */
+    enum bmm350_magreset_type full_reset;
+
+    /*! Reset run when only a shorter window is available */
+    enum bmm350_magreset_type fast_reset;
+
+    /*! Sensor runs in normal mode, a reset then includes the suspend and normal mode transitions */
+    bool normal_mode;
+};
+
+/*!
+ * @brief Structure to define the maintenance statistics
+ */
+struct bmm350_maint_stats
+{
+    /*! Number of full resets run */
+    uint32_t full_resets;
+
+    /*! Number of fast resets run */
+    uint32_t fast_resets;
+
+    /*! Number of resets run after max_defer_us without a fitting window */
+    uint32_t forced_resets;
+
+    /*! Number of resets that failed, not counted above */
+    uint32_t failed_resets;
+
+    /*! Number of calls that deferred a due reset */
+    uint32_t deferrals;
+
+    /*! Number of samples flagged as affected by maintenance */
+    uint32_t flagged_samples;
+
+    /*! Total time the sensor was blocked by maintenance in us */
+    uint32_t maint_time_us;
+
+    /*! Part of maint_time_us that overlapped expected sample times in us */
+    uint32_t data_time_lost_us;
+};
+
+/*!
+ * @brief Structure to define the state of the maintenance scheduler
+ */
+struct bmm350_maint
+{
+    /*! Scheduler configuration */
+    struct bmm350_maint_config config;
+
+    /*! Scheduler statistics */
+    struct bmm350_maint_stats stats;
+
+    /*! Host time of the last reset in us */
+    uint32_t last_reset_us;
+
+    /*! Host time of the last sample in us */
+    uint32_t last_sample_us;
+
+    /*! Smoothed time between two samples in us, 0 if not known yet */
+    uint32_t sample_interval_us;
+
+    /*! Flags to report with the next sample */
+    uint8_t pending_flags;
+
+    /*! Flag to track if a sample has been seen */
+    bool sampling;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the maintenance scheduler. The reset period starts at now_us.
+ *
+ * @param[in] config         : Scheduler configuration
+ * @param[in] now_us         : Host time in us
+ * @param[out] maint         : Structure that stores the state of the scheduler
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_maint_init(const struct bmm350_maint_config *config, uint32_t now_us, struct bmm350_maint *maint);
+
+/*!
+ * @brief Function to register an acquired sample. It tracks the acquisition load and returns
+ * the flags of the sample.
+ *
+ * @param[in] now_us         : Host time of the sample in us
+ * @param[out] flags         : BMM350_MAINT_FLAG_* of the sample
+ * @param[in,out] maint      : Structure that stores the state of the scheduler
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_maint_sample(uint32_t now_us, uint8_t *flags, struct bmm350_maint *maint);
+
+/*!
+ * @brief Function to run a due magnetic reset if the current idle window allows it. It is called
+ * when the consumer is idle, e.g. right after a sample was processed.
+ *
+ * @details The idle window is the time until the next expected sample plus the latency budget.
+ * The full reset is run if it fits, otherwise the fast reset if it fits. A due reset that fits
+ * neither is deferred until max_defer_us has passed, then the fast reset is run.
+ * When no acquisition is running, the window is unlimited.
+ *
+ * @param[in] now_us         : Host time in us
+ * @param[out] reset_type    : Reset that was run, BMM350_NOMAGRESET if none or if it failed
+ * @param[in,out] maint      : Structure that stores the state of the scheduler
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_maint_run(uint32_t now_us,
+                        enum bmm350_magreset_type *reset_type,
+                        struct bmm350_maint *maint,
+                        struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get the time a magnetic reset blocks the sensor.
+ *
+ * @param[in] reset_type     : Magnetic reset type
+ * @param[in] normal_mode    : Sensor runs in normal mode
+ *
+ *  @return Reset duration in us
+ */
+uint32_t bmm350_maint_reset_duration_us(enum bmm350_magreset_type reset_type, bool normal_mode);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_MAINTENANCE_H */
@@ -297,6 +297,7 @@ int8_t bmm350_oor_read(bool *out_of_range,
 {
     int8_t rslt = 0;
     uint8_t pmu_cmd = BMM350_PMU_CMD_SUS;
+    bool was_out_of_range = *out_of_range;
 
 #ifdef BMM350_OOR_HALF_SELF_TEST
     rslt = trigger_half_selftest(oor, dev);
@@ -323,6 +324,11 @@ int8_t bmm350_oor_read(bool *out_of_range,
 
     validate_out_of_range(out_of_range, data, oor);
 
+    if (*out_of_range != was_out_of_range)
+    {
+        (void)bmm350_log_event(BMM350_EVENT_OOR, rslt, (*out_of_range) ? 1 : 0, dev);
+    }
+
     oor->last_st_cmd = oor->st_cmd;
 
     return rslt;
@@ -0,0 +1,269 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_raw_ring.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_raw_ring.h"
+
+/*!
+ * @brief This internal API is used to get the compensated sample of a slot, compensating it on first use.
+ */
+static int8_t compensate_slot(struct bmm350_raw_ring_slot *slot,
+                              struct bmm350_mag_temp_data *mag_temp_data,
+                              struct bmm350_raw_ring *ring,
+                              const struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (slot->compensated)
+    {
+        ring->memo_hits++;
+    }
+    else
+    {
+        rslt = bmm350_compensate_raw_mag_temp_data(&slot->raw, 1, &slot->data, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            slot->compensated = true;
+            ring->compensated_count++;
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        *mag_temp_data = slot->data;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to initialize an empty ring.
+ */
+int8_t bmm350_raw_ring_init(struct bmm350_raw_ring_slot *slots, uint16_t capacity, struct bmm350_raw_ring *ring)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((slots != NULL) && (ring != NULL))
+    {
+        /* Power of 2 so that the slot index is a mask of the sequence number */
+        if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            ring->slots = slots;
+            ring->capacity = capacity;
+            ring->head = 0;
+            ring->compensated_count = 0;
+            ring->memo_hits = 0;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to store a raw sample.
+ */
+int8_t bmm350_raw_ring_push(const struct bmm350_raw_mag_data *raw_data, struct bmm350_raw_ring *ring)
+{
+    int8_t rslt = BMM350_OK;
+    struct bmm350_raw_ring_slot *slot;
+
+    if ((raw_data != NULL) && (ring != NULL) && (ring->slots != NULL))
+    {
+        slot = &ring->slots[ring->head & (uint32_t)(ring->capacity - 1)];
+        slot->raw = *raw_data;
+        slot->compensated = false;
+        ring->head++;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to read a raw sample from the sensor and store it.
+ */
+int8_t bmm350_raw_ring_read(struct bmm350_raw_ring *ring, struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    struct bmm350_raw_mag_data raw_data = { 0 };
+
+    rslt = bmm350_read_uncomp_mag_temp_data(&raw_data, dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_raw_ring_push(&raw_data, ring);
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the compensated sample with a sequence number.
+ */
+int8_t bmm350_raw_ring_get(uint32_t seq,
+                           struct bmm350_mag_temp_data *mag_temp_data,
+                           struct bmm350_raw_ring *ring,
+                           const struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((mag_temp_data != NULL) && (ring != NULL) && (ring->slots != NULL))
+    {
+        /* Pushed and not yet overwritten */
+        if ((seq < ring->head) && ((ring->head - seq) <= ring->capacity))
+        {
+            rslt = compensate_slot(&ring->slots[seq & (uint32_t)(ring->capacity - 1)], mag_temp_data, ring, dev);
+        }
+        else
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get the latest compensated sample.
+ */
+int8_t bmm350_raw_ring_get_latest(struct bmm350_mag_temp_data *mag_temp_data,
+                                  struct bmm350_raw_ring *ring,
+                                  const struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    if (ring != NULL)
+    {
+        rslt = bmm350_raw_ring_get(ring->head - 1, mag_temp_data, ring, dev);
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to get a range of compensated samples.
+ */
+int8_t bmm350_raw_ring_get_range(uint32_t from_seq,
+                                 struct bmm350_mag_temp_data *mag_temp_data,
+                                 uint16_t max_samples,
+                                 uint16_t *n_samples,
+                                 uint32_t *first_seq,
+                                 struct bmm350_raw_ring *ring,
+                                 const struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    uint32_t first, count, index;
+
+    if ((mag_temp_data != NULL) && (n_samples != NULL) && (first_seq != NULL) && (ring != NULL) &&
+        (ring->slots != NULL))
+    {
+        /* Oldest sample still in the ring */
+        first = (ring->head > ring->capacity) ? (ring->head - ring->capacity) : 0;
+
+        if (from_seq > first)
+        {
+            first = (from_seq < ring->head) ? from_seq : ring->head;
+        }
+
+        count = ring->head - first;
+
+        if (count > max_samples)
+        {
+            count = max_samples;
+        }
+
+        for (index = 0; (index < count) && (rslt == BMM350_OK); index++)
+        {
+            rslt = compensate_slot(&ring->slots[(first + index) & (uint32_t)(ring->capacity - 1)],
+                                   &mag_temp_data[index],
+                                   ring,
+                                   dev);
+        }
+
+        *n_samples = (rslt == BMM350_OK) ? (uint16_t)count : 0;
+        *first_seq = first;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to drop the memoized compensations.
+ */
+int8_t bmm350_raw_ring_invalidate(struct bmm350_raw_ring *ring)
+{
+    int8_t rslt = BMM350_OK;
+    uint16_t index;
+
+    if ((ring != NULL) && (ring->slots != NULL))
+    {
+        for (index = 0; index < ring->capacity; index++)
+        {
+            ring->slots[index].compensated = false;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,201 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_raw_ring.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_RAW_RING_H
+#define _BMM350_RAW_RING_H
+
+#include <stdbool.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define a slot of the ring: the raw sample and its memoized compensation
+ */
+struct bmm350_raw_ring_slot
+{
+    /*! Raw mag and temperature */
+    struct bmm350_raw_mag_data raw;
+
+    /*! Compensated sample, valid if compensated is set */
+    struct bmm350_mag_temp_data data;
+
+    /*! Flag to track if the sample has been compensated */
+    bool compensated;
+};
+
+/*!
+ * @brief Structure to define the state of the raw sample ring
+ */
+struct bmm350_raw_ring
+{
+    /*! Slot storage, provided by the application */
+    struct bmm350_raw_ring_slot *slots;
+
+    /*! Number of slots, a power of 2 */
+    uint16_t capacity;
+
+    /*! Number of samples pushed; the sequence number of the next sample */
+    uint32_t head;
+
+    /*! Samples compensated, and reads served from a memoized compensation */
+    uint32_t compensated_count;
+    uint32_t memo_hits;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize an empty ring on application provided storage.
+ *
+ * @param[in] slots          : Slot storage
+ * @param[in] capacity       : Number of slots, a power of 2
+ * @param[out] ring          : Structure that stores the state of the ring
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Capacity not a power of 2
+ */
+int8_t bmm350_raw_ring_init(struct bmm350_raw_ring_slot *slots, uint16_t capacity, struct bmm350_raw_ring *ring);
+
+/*!
+ * @brief Function to store a raw sample, overwriting the oldest one when the ring is full.
+ * No compensation is done here.
+ *
+ * @param[in] raw_data       : Raw sample
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_raw_ring_push(const struct bmm350_raw_mag_data *raw_data, struct bmm350_raw_ring *ring);
+
+/*!
+ * @brief Function to read a raw sample from the sensor and store it, see bmm350_raw_ring_push.
+ *
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ * @param[in,out] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_raw_ring_read(struct bmm350_raw_ring *ring, struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get the compensated sample with a sequence number. The sample is compensated on the
+ * first read and the result is kept in its slot for later reads.
+ *
+ * @param[in] seq            : Sequence number, the position of the sample since the ring was initialized
+ * @param[out] mag_temp_data : Compensated sample
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ * @param[in] dev            : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_INPUT -> Sample not in the ring, not yet pushed or overwritten
+ */
+int8_t bmm350_raw_ring_get(uint32_t seq,
+                           struct bmm350_mag_temp_data *mag_temp_data,
+                           struct bmm350_raw_ring *ring,
+                           const struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get the latest compensated sample, see bmm350_raw_ring_get.
+ *
+ * @param[out] mag_temp_data : Compensated sample
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ * @param[in] dev            : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_INPUT -> Ring empty
+ */
+int8_t bmm350_raw_ring_get_latest(struct bmm350_mag_temp_data *mag_temp_data,
+                                  struct bmm350_raw_ring *ring,
+                                  const struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to get a range of compensated samples, oldest first, starting at sequence number from_seq
+ * or at the oldest sample still in the ring. Only the samples copied are compensated, each at most once.
+ *
+ * @param[in] from_seq       : Sequence number of the first sample wanted, 0 for all
+ * @param[out] mag_temp_data : Compensated samples
+ * @param[in] max_samples    : Size of mag_temp_data
+ * @param[out] n_samples     : Number of samples copied
+ * @param[out] first_seq     : Sequence number of mag_temp_data[0]; from_seq for the next call is
+ *                             first_seq + n_samples
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ * @param[in] dev            : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_raw_ring_get_range(uint32_t from_seq,
+                                 struct bmm350_mag_temp_data *mag_temp_data,
+                                 uint16_t max_samples,
+                                 uint16_t *n_samples,
+                                 uint32_t *first_seq,
+                                 struct bmm350_raw_ring *ring,
+                                 const struct bmm350_dev *dev);
+
+/*!
+ * @brief Function to drop the memoized compensations, e.g. after the compensation coefficients of the
+ * device were read again. The raw samples are kept.
+ *
+ * @param[in,out] ring       : Structure that stores the state of the ring
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_raw_ring_invalidate(struct bmm350_raw_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_RAW_RING_H */
@@ -0,0 +1,446 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_redundant.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_redundant.h"
+
+/*!
+ * @brief This internal API is used to get the x, y or z value of a sample.
+ */
+static float axis_value(const struct bmm350_mag_temp_data *sample, uint8_t axis)
+{
+    float value;
+
+    if (axis == 0)
+    {
+        value = sample->x;
+    }
+    else if (axis == 1)
+    {
+        value = sample->y;
+    }
+    else
+    {
+        value = sample->z;
+    }
+
+    return value;
+}
+
+/*!
+ * @brief This internal API is used to get the median of up to BMM350_REDUNDANT_MAX_SENSORS values.
+ * The values are sorted in place.
+ */
+static float median(float *values, uint8_t count)
+{
+    uint8_t indx, pos;
+    float tmp;
+
+    for (indx = 1; indx < count; indx++)
+    {
+        tmp = values[indx];
+
+        for (pos = indx; (pos > 0) && (values[pos - 1] > tmp); pos--)
+        {
+            values[pos] = values[pos - 1];
+        }
+
+        values[pos] = tmp;
+    }
+
+    return ((count % 2) != 0) ? values[count / 2] : 0.5f * (values[count / 2 - 1] + values[count / 2]);
+}
+
+/*! Variance of the median of 1 to 3 values relative to the variance of one value, indexed by the count */
+static const float median_var_ratio[BMM350_REDUNDANT_MAX_SENSORS] = { 1.0f, 1.0f, 0.5f, 0.449f };
+
+/*!
+ * @brief This internal API is used to collect one axis of the reference sensors: the candidates in good
+ * standing, or all candidates if use_all is set. The sensor skip is left out, n_sensors to keep all.
+ * Returns the number of values; var_sum, if not NULL, gets the sum of their noise variances.
+ */
+static uint8_t reference_values(const struct bmm350_mag_temp_data *samples,
+                                const bool *candidate,
+                                bool use_all,
+                                uint8_t skip,
+                                uint8_t axis,
+                                const struct bmm350_redundant *red,
+                                float *values,
+                                float *var_sum)
+{
+    uint8_t indx, count = 0;
+    float sum = 0.0f;
+
+    for (indx = 0; indx < red->n_sensors; indx++)
+    {
+        if (candidate[indx] && (indx != skip) && (use_all || !red->sensor[indx].excluded))
+        {
+            values[count++] = axis_value(&samples[indx], axis);
+            sum += red->sensor[indx].var[axis];
+        }
+    }
+
+    if (var_sum != NULL)
+    {
+        *var_sum = sum;
+    }
+
+    return count;
+}
+
+/*!
+ * @brief This internal API is used to check for a stuck axis. Returns true if any axis repeated the
+ * identical value stuck times.
+ */
+static bool check_stuck(const struct bmm350_mag_temp_data *sample,
+                        uint16_t stuck,
+                        struct bmm350_redundant_sensor *sensor)
+{
+    uint8_t axis;
+    float value;
+    bool is_stuck = false;
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        value = axis_value(sample, axis);
+
+        /* Sensor noise makes identical compensated values in a row practically impossible */
+        if (value == sensor->prev[axis])
+        {
+            if (sensor->stuck_count[axis] < UINT16_MAX)
+            {
+                sensor->stuck_count[axis]++;
+            }
+        }
+        else
+        {
+            sensor->stuck_count[axis] = 1;
+        }
+
+        sensor->prev[axis] = value;
+
+        if (sensor->stuck_count[axis] >= stuck)
+        {
+            is_stuck = true;
+        }
+    }
+
+    return is_stuck;
+}
+
+/*!
+ * @brief This internal API is used to update the agreement counters of a sensor and exclude or readmit it.
+ */
+static void update_agreement(bool disagree, struct bmm350_redundant_sensor *sensor, const struct bmm350_redundant *red)
+{
+    if (disagree)
+    {
+        sensor->agree_count = 0;
+
+        if (sensor->disagree_count < UINT16_MAX)
+        {
+            sensor->disagree_count++;
+        }
+
+        if ((!sensor->excluded) && (sensor->disagree_count >= red->persist))
+        {
+            sensor->excluded = true;
+            sensor->exclusion_count++;
+        }
+
+        if (sensor->excluded)
+        {
+            sensor->health = BMM350_REDUNDANT_HEALTH_DISAGREE;
+        }
+    }
+    else
+    {
+        sensor->disagree_count = 0;
+
+        if (sensor->excluded)
+        {
+            sensor->agree_count++;
+
+            if (sensor->agree_count >= red->readmit)
+            {
+                sensor->excluded = false;
+                sensor->agree_count = 0;
+            }
+        }
+
+        if (!sensor->excluded)
+        {
+            sensor->health = BMM350_REDUNDANT_HEALTH_OK;
+        }
+    }
+}
+
+/*!
+ * @brief This API is used to initialize the redundant sensor fusion.
+ */
+int8_t bmm350_redundant_init(uint8_t n_sensors, float noise_ut, struct bmm350_redundant *red)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx, axis;
+    struct bmm350_redundant_sensor sensor = { 0 };
+
+    if (red != NULL)
+    {
+        if ((n_sensors < BMM350_REDUNDANT_MIN_SENSORS) || (n_sensors > BMM350_REDUNDANT_MAX_SENSORS) ||
+            (noise_ut <= 0.0f))
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+        else
+        {
+            red->n_sensors = n_sensors;
+            red->limit_ut = BMM350_REDUNDANT_DEFAULT_LIMIT_UT;
+            red->persist = BMM350_REDUNDANT_DEFAULT_PERSIST;
+            red->readmit = BMM350_REDUNDANT_DEFAULT_READMIT;
+            red->stuck = BMM350_REDUNDANT_DEFAULT_STUCK;
+            red->alpha = BMM350_REDUNDANT_DEFAULT_ALPHA;
+            red->nominal_var = noise_ut * noise_ut;
+            red->sample_count = 0;
+            red->unresolved_count = 0;
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                sensor.var[axis] = red->nominal_var;
+            }
+
+            for (indx = 0; indx < BMM350_REDUNDANT_MAX_SENSORS; indx++)
+            {
+                red->sensor[indx] = sensor;
+            }
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to fuse one set of time-aligned samples of the redundant sensors.
+ */
+int8_t bmm350_redundant_process(const struct bmm350_mag_temp_data *samples,
+                                const uint8_t *flags,
+                                struct bmm350_redundant_output *out,
+                                struct bmm350_redundant *red)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx, axis, n_cand = 0, n_ref = 0, n_other, flag;
+    bool candidate[BMM350_REDUNDANT_MAX_SENSORS] = { false };
+    bool disagree, unresolved = false;
+    float values[BMM350_REDUNDANT_MAX_SENSORS];
+    float consensus[3] = { 0.0f };
+    float fused[3] = { 0.0f };
+    float weight_sum[3] = { 0.0f };
+    float dev, diff, weight, ref_var, temp_sum = 0.0f, noise_var = 0.0f;
+    struct bmm350_redundant_sensor *sensor;
+
+    if ((samples != NULL) && (out != NULL) && (red != NULL))
+    {
+        red->sample_count++;
+        out->n_used = 0;
+        out->used_mask = 0;
+
+        for (indx = 0; indx < red->n_sensors; indx++)
+        {
+            sensor = &red->sensor[indx];
+            flag = (flags != NULL) ? flags[indx] : 0;
+            sensor->weight = 0.0f;
+
+            if ((flag & BMM350_REDUNDANT_FLAG_MISSING) != 0)
+            {
+                sensor->health = BMM350_REDUNDANT_HEALTH_MISSING;
+            }
+            else if ((flag & BMM350_REDUNDANT_FLAG_SELF_TEST) != 0)
+            {
+                sensor->health = BMM350_REDUNDANT_HEALTH_SELF_TEST;
+            }
+            else if ((flag & BMM350_REDUNDANT_FLAG_OOR) != 0)
+            {
+                sensor->health = BMM350_REDUNDANT_HEALTH_OOR;
+            }
+            else if (check_stuck(&samples[indx], red->stuck, sensor))
+            {
+                if (!sensor->excluded)
+                {
+                    sensor->excluded = true;
+                    sensor->exclusion_count++;
+                }
+
+                sensor->agree_count = 0;
+                sensor->health = BMM350_REDUNDANT_HEALTH_STUCK;
+            }
+            else
+            {
+                candidate[indx] = true;
+                n_cand++;
+
+                if (!sensor->excluded)
+                {
+                    n_ref++;
+                }
+            }
+        }
+
+        if (n_cand > 0)
+        {
+            /* Consensus of the sensors in good standing, or of all candidates if none is */
+            for (axis = 0; axis < 3; axis++)
+            {
+                n_cand = reference_values(samples, candidate, (n_ref == 0), red->n_sensors, axis, red, values, NULL);
+                consensus[axis] = median(values, n_cand);
+            }
+
+            for (indx = 0; indx < red->n_sensors; indx++)
+            {
+                if (candidate[indx])
+                {
+                    sensor = &red->sensor[indx];
+                    disagree = false;
+
+                    for (axis = 0; axis < 3; axis++)
+                    {
+                        if (fabsf(axis_value(&samples[indx], axis) - consensus[axis]) > red->limit_ut)
+                        {
+                            disagree = true;
+                        }
+                    }
+
+                    /* Two sensors in the consensus disagree by the same amount: no way to tell which one is off */
+                    if (disagree && (!sensor->excluded) && (n_ref < 3))
+                    {
+                        unresolved = true;
+                    }
+                    else
+                    {
+                        update_agreement(disagree, sensor, red);
+                    }
+
+                    if (!sensor->excluded)
+                    {
+                        for (axis = 0; axis < 3; axis++)
+                        {
+                            /*
+                             * Against the median of the other sensors only, so a noisy sensor does not pull
+                             * its own reference. The noise of that median is taken off the deviation to
+                             * attribute the noise to the right sensor.
+                             */
+                            n_other = reference_values(samples,
+                                                       candidate,
+                                                       (n_ref == 0),
+                                                       indx,
+                                                       axis,
+                                                       red,
+                                                       values,
+                                                       &ref_var);
+
+                            if (n_other > 0)
+                            {
+                                ref_var *= median_var_ratio[n_other] / (float)n_other;
+                                dev = axis_value(&samples[indx], axis) - median(values, n_other);
+                                diff = dev - sensor->bias[axis];
+                                sensor->bias[axis] += red->alpha * diff;
+                                sensor->var[axis] += red->alpha * (diff * diff - ref_var - sensor->var[axis]);
+
+                                if (sensor->var[axis] < (BMM350_REDUNDANT_VAR_FLOOR * red->nominal_var))
+                                {
+                                    sensor->var[axis] = BMM350_REDUNDANT_VAR_FLOOR * red->nominal_var;
+                                }
+                            }
+
+                            weight = 1.0f / sensor->var[axis];
+                            fused[axis] += weight * axis_value(&samples[indx], axis);
+                            weight_sum[axis] += weight;
+                            sensor->weight += weight;
+                        }
+
+                        temp_sum += samples[indx].temperature;
+                        out->n_used++;
+                        out->used_mask |= (uint8_t)(1u << indx);
+                    }
+                }
+            }
+        }
+
+        if (unresolved)
+        {
+            red->unresolved_count++;
+        }
+
+        for (indx = 0; indx < red->n_sensors; indx++)
+        {
+            sensor = &red->sensor[indx];
+
+            if ((out->used_mask & (1u << indx)) != 0)
+            {
+                sensor->used_count++;
+                sensor->weight /= weight_sum[0] + weight_sum[1] + weight_sum[2];
+            }
+            else
+            {
+                sensor->unused_count++;
+            }
+        }
+
+        if (out->n_used > 0)
+        {
+            for (axis = 0; axis < 3; axis++)
+            {
+                fused[axis] /= weight_sum[axis];
+                noise_var += 1.0f / weight_sum[axis];
+            }
+
+            out->data.x = fused[0];
+            out->data.y = fused[1];
+            out->data.z = fused[2];
+            out->data.temperature = temp_sum / (float)out->n_used;
+            out->noise_ut = sqrtf(noise_var / 3.0f);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
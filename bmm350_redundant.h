@@ -0,0 +1,223 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_redundant.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_REDUNDANT_H
+#define _BMM350_REDUNDANT_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Number of redundant sensors */
+#define BMM350_REDUNDANT_MIN_SENSORS      UINT8_C(2)
+#define BMM350_REDUNDANT_MAX_SENSORS      UINT8_C(4)
+
+/*! Default deviation from the consensus that counts as disagreement, in uT */
+#define BMM350_REDUNDANT_DEFAULT_LIMIT_UT (3.0f)
+
+/*! Default consecutive disagreeing samples before a sensor is excluded */
+#define BMM350_REDUNDANT_DEFAULT_PERSIST  UINT16_C(20)
+
+/*! Default consecutive agreeing samples before an excluded sensor is readmitted */
+#define BMM350_REDUNDANT_DEFAULT_READMIT  UINT16_C(100)
+
+/*! Default consecutive identical values of an axis that count as a stuck axis */
+#define BMM350_REDUNDANT_DEFAULT_STUCK    UINT16_C(8)
+
+/*! Default weight of the noise estimate update */
+#define BMM350_REDUNDANT_DEFAULT_ALPHA    (0.01f)
+
+/*! Noise variance floor as a fraction of the nominal variance, so that no sensor takes all the weight */
+#define BMM350_REDUNDANT_VAR_FLOOR        (0.25f)
+
+/*! Input flags of a sample */
+#define BMM350_REDUNDANT_FLAG_MISSING     UINT8_C(0x01)
+#define BMM350_REDUNDANT_FLAG_OOR         UINT8_C(0x02)
+#define BMM350_REDUNDANT_FLAG_SELF_TEST   UINT8_C(0x04)
+
+/*! Health of a sensor */
+#define BMM350_REDUNDANT_HEALTH_OK        UINT8_C(0)
+#define BMM350_REDUNDANT_HEALTH_MISSING   UINT8_C(1)
+#define BMM350_REDUNDANT_HEALTH_OOR       UINT8_C(2)
+#define BMM350_REDUNDANT_HEALTH_SELF_TEST UINT8_C(3)
+#define BMM350_REDUNDANT_HEALTH_STUCK     UINT8_C(4)
+#define BMM350_REDUNDANT_HEALTH_DISAGREE  UINT8_C(5)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the health and running estimates of one sensor
+ */
+struct bmm350_redundant_sensor
+{
+    /*! Health, one of BMM350_REDUNDANT_HEALTH_* */
+    uint8_t health;
+
+    /*! Flag to track if the sensor is excluded for a stuck axis or persistent disagreement */
+    bool excluded;
+
+    /*! Running bias against the other sensors and noise variance per axis, in uT and uT^2 */
+    float bias[3];
+    float var[3];
+
+    /*! Weight of the sensor in the last fused sample, 0 if not used */
+    float weight;
+
+    /*! Last sample and count of identical values per axis */
+    float prev[3];
+    uint16_t stuck_count[3];
+
+    /*! Consecutive disagreeing and agreeing samples */
+    uint16_t disagree_count;
+    uint16_t agree_count;
+
+    /*! Samples used in the fusion, and samples left out */
+    uint32_t used_count;
+    uint32_t unused_count;
+
+    /*! Number of exclusions */
+    uint32_t exclusion_count;
+};
+
+/*!
+ * @brief Structure to define a fused sample
+ */
+struct bmm350_redundant_output
+{
+    /*! Weighted average of mag in uT, plain average of the temperature in degC */
+    struct bmm350_mag_temp_data data;
+
+    /*! Estimated noise of the fused sample in uT rms, averaged over the axes */
+    float noise_ut;
+
+    /*! Number of sensors used, and bit mask of them */
+    uint8_t n_used;
+    uint8_t used_mask;
+};
+
+/*!
+ * @brief Structure to define the state of the redundant sensor fusion
+ */
+struct bmm350_redundant
+{
+    /*! Number of sensors */
+    uint8_t n_sensors;
+
+    /*! Deviation from the consensus that counts as disagreement, in uT */
+    float limit_ut;
+
+    /*! Consecutive disagreeing samples to exclude, agreeing samples to readmit, identical values of a stuck axis */
+    uint16_t persist;
+    uint16_t readmit;
+    uint16_t stuck;
+
+    /*! Weight of the noise estimate update */
+    float alpha;
+
+    /*! Nominal noise variance of one sensor in uT^2 */
+    float nominal_var;
+
+    /*! Number of samples fused, and disagreements that could not be attributed to one sensor */
+    uint32_t sample_count;
+    uint32_t unresolved_count;
+
+    /*! State of each sensor */
+    struct bmm350_redundant_sensor sensor[BMM350_REDUNDANT_MAX_SENSORS];
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the redundant sensor fusion with default limits. The limits can be
+ * changed in the structure afterwards.
+ *
+ * @param[in] n_sensors      : Number of sensors, BMM350_REDUNDANT_MIN_SENSORS to BMM350_REDUNDANT_MAX_SENSORS
+ * @param[in] noise_ut       : Nominal noise of one sensor per axis in uT rms, the start of the noise estimates
+ * @param[out] red           : Structure that stores the state of the redundant sensor fusion
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval BMM350_E_INVALID_CONFIG -> Sensor count out of range or noise not positive
+ */
+int8_t bmm350_redundant_init(uint8_t n_sensors, float noise_ut, struct bmm350_redundant *red);
+
+/*!
+ * @brief Function to fuse one set of time-aligned samples of the redundant sensors.
+ *
+ * @details A sample flagged missing, out of range or with a failed self-test is left out and the sensor
+ * health reports the reason. An axis repeating the identical value stuck times excludes the sensor.
+ *
+ * The consensus is the per-axis median of the sensors that are not excluded. A sensor deviating from it by
+ * more than limit_ut on any axis for persist consecutive samples is excluded; it is readmitted after readmit
+ * consecutive agreeing samples. With only two sensors in the consensus a disagreement cannot be attributed,
+ * so it is counted in unresolved_count and nobody is excluded.
+ *
+ * The fused mag is the average of the sensors in use weighted per axis by the inverse of their noise
+ * variance, estimated from the deviation from the median of the other sensors in the consensus less the noise
+ * of that median. With N equal sensors the noise drops by about sqrt(N). With only two sensors the noise
+ * cannot be attributed either and their sum is split between them.
+ *
+ * @param[in] samples        : Compensated samples, n_sensors entries
+ * @param[in] flags          : BMM350_REDUNDANT_FLAG_* of each sample, can be NULL
+ * @param[out] out           : Fused sample; n_used is 0 and data is unchanged if no sensor is usable
+ * @param[in,out] red        : Structure that stores the state of the redundant sensor fusion
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_redundant_process(const struct bmm350_mag_temp_data *samples,
+                                const uint8_t *flags,
+                                struct bmm350_redundant_output *out,
+                                struct bmm350_redundant *red);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_REDUNDANT_H */
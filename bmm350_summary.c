@@ -0,0 +1,359 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_summary.c
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#include "bmm350_summary.h"
+
+/*! Index of the accumulators */
+#define SUMMARY_ACC_MAGNITUDE    UINT8_C(3)
+#define SUMMARY_ACC_TEMPERATURE  UINT8_C(4)
+#define SUMMARY_ACC_COUNT        UINT8_C(5)
+
+/*!
+ * @brief This internal API is used to clear the open interval.
+ */
+static void reset_interval(struct bmm350_summary *summary)
+{
+    uint8_t indx;
+
+    for (indx = 0; indx < SUMMARY_ACC_COUNT; indx++)
+    {
+        summary->acc[indx].mean = 0.0f;
+        summary->acc[indx].m2 = 0.0f;
+        summary->acc[indx].min = 0.0f;
+        summary->acc[indx].max = 0.0f;
+    }
+
+    summary->count = 0;
+    summary->oor_count = 0;
+    summary->self_test_count = 0;
+}
+
+/*!
+ * @brief This internal API is used to add a value to an accumulator (Welford update).
+ */
+static void accumulate(float value, uint16_t count, struct bmm350_summary_acc *acc)
+{
+    float delta;
+
+    if (count == 1)
+    {
+        acc->mean = value;
+        acc->m2 = 0.0f;
+        acc->min = value;
+        acc->max = value;
+    }
+    else
+    {
+        delta = value - acc->mean;
+        acc->mean += delta / (float)count;
+        acc->m2 += delta * (value - acc->mean);
+
+        if (value < acc->min)
+        {
+            acc->min = value;
+        }
+
+        if (value > acc->max)
+        {
+            acc->max = value;
+        }
+    }
+}
+
+/*!
+ * @brief This internal API is used to convert an accumulator to statistics.
+ */
+static void to_stat(const struct bmm350_summary_acc *acc, uint16_t count, struct bmm350_summary_stat *stat)
+{
+    stat->mean = acc->mean;
+    stat->min = acc->min;
+    stat->max = acc->max;
+    stat->std = (count > 0) ? sqrtf(acc->m2 / (float)count) : 0.0f;
+}
+
+/*!
+ * @brief This internal API is used to close the open interval into a record.
+ */
+static void close_interval(struct bmm350_summary_record *record, const struct bmm350_summary *summary)
+{
+    uint8_t indx;
+
+    record->start_ms = summary->start_ms;
+    record->duration_ms = summary->last_ms - summary->start_ms;
+    record->count = summary->count;
+
+    for (indx = 0; indx < 3; indx++)
+    {
+        to_stat(&summary->acc[indx], summary->count, &record->axis[indx]);
+    }
+
+    to_stat(&summary->acc[SUMMARY_ACC_MAGNITUDE], summary->count, &record->magnitude);
+    to_stat(&summary->acc[SUMMARY_ACC_TEMPERATURE], summary->count, &record->temperature);
+
+    record->oor_count = summary->oor_count;
+    record->self_test_count = summary->self_test_count;
+}
+
+/*!
+ * @brief This internal API is used to scale and clip a value to int16, updating the saturation flag.
+ */
+static void put_int16(float value, float scale, uint8_t *buffer, uint8_t *flags)
+{
+    float scaled = roundf(value * scale);
+    int16_t out;
+
+    if (scaled > (float)INT16_MAX)
+    {
+        out = INT16_MAX;
+        *flags |= BMM350_SUMMARY_REC_SATURATED;
+    }
+    else if (scaled < (float)INT16_MIN)
+    {
+        out = INT16_MIN;
+        *flags |= BMM350_SUMMARY_REC_SATURATED;
+    }
+    else
+    {
+        out = (int16_t)scaled;
+    }
+
+    buffer[0] = (uint8_t)((uint16_t)out & 0xFF);
+    buffer[1] = (uint8_t)((uint16_t)out >> 8);
+}
+
+/*!
+ * @brief This internal API is used to scale and clip a value to uint16, updating the saturation flag.
+ */
+static void put_uint16(float value, float scale, uint8_t *buffer, uint8_t *flags)
+{
+    float scaled = roundf(value * scale);
+    uint16_t out;
+
+    if (scaled > (float)UINT16_MAX)
+    {
+        out = UINT16_MAX;
+        *flags |= BMM350_SUMMARY_REC_SATURATED;
+    }
+    else if (scaled < 0.0f)
+    {
+        out = 0;
+    }
+    else
+    {
+        out = (uint16_t)scaled;
+    }
+
+    buffer[0] = (uint8_t)(out & 0xFF);
+    buffer[1] = (uint8_t)(out >> 8);
+}
+
+/*!
+ * @brief This internal API is used to store a uint32 value little endian.
+ */
+static void put_uint32(uint32_t value, uint8_t *buffer)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[2] = (uint8_t)((value >> 16) & 0xFF);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+/*!
+ * @brief This API is used to initialize the summary aggregation.
+ */
+int8_t bmm350_summary_init(uint32_t interval_ms, struct bmm350_summary *summary)
+{
+    int8_t rslt = BMM350_OK;
+
+    if (summary != NULL)
+    {
+        if (interval_ms == 0)
+        {
+            rslt = BMM350_E_INVALID_INPUT;
+        }
+        else
+        {
+            summary->interval_ms = interval_ms;
+            summary->start_ms = 0;
+            summary->last_ms = 0;
+            reset_interval(summary);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to add a compensated sample.
+ */
+int8_t bmm350_summary_add(const struct bmm350_mag_temp_data *data,
+                          uint32_t timestamp_ms,
+                          uint8_t flags,
+                          bool *ready,
+                          struct bmm350_summary_record *record,
+                          struct bmm350_summary *summary)
+{
+    int8_t rslt = BMM350_OK;
+    float magnitude;
+
+    if ((data != NULL) && (ready != NULL) && (record != NULL) && (summary != NULL))
+    {
+        *ready = false;
+
+        if ((summary->count > 0) &&
+            (((timestamp_ms - summary->start_ms) >= summary->interval_ms) || (summary->count == UINT16_MAX)))
+        {
+            close_interval(record, summary);
+            reset_interval(summary);
+            *ready = true;
+        }
+
+        if (summary->count == 0)
+        {
+            summary->start_ms = timestamp_ms;
+        }
+
+        summary->count++;
+        summary->last_ms = timestamp_ms;
+
+        magnitude = sqrtf((data->x * data->x) + (data->y * data->y) + (data->z * data->z));
+
+        accumulate(data->x, summary->count, &summary->acc[0]);
+        accumulate(data->y, summary->count, &summary->acc[1]);
+        accumulate(data->z, summary->count, &summary->acc[2]);
+        accumulate(magnitude, summary->count, &summary->acc[SUMMARY_ACC_MAGNITUDE]);
+        accumulate(data->temperature, summary->count, &summary->acc[SUMMARY_ACC_TEMPERATURE]);
+
+        if (flags & BMM350_SUMMARY_FLAG_OOR)
+        {
+            summary->oor_count++;
+        }
+
+        if (flags & BMM350_SUMMARY_FLAG_SELF_TEST)
+        {
+            summary->self_test_count++;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to close the open interval.
+ */
+int8_t bmm350_summary_flush(bool *ready, struct bmm350_summary_record *record, struct bmm350_summary *summary)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((ready != NULL) && (record != NULL) && (summary != NULL))
+    {
+        *ready = (summary->count > 0);
+
+        if (*ready)
+        {
+            close_interval(record, summary);
+            reset_interval(summary);
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ * @brief This API is used to encode a summary into a fixed size record.
+ */
+int8_t bmm350_summary_encode(const struct bmm350_summary_record *record, uint8_t *buffer)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx, flags = 0;
+    uint8_t *pos;
+
+    if ((record != NULL) && (buffer != NULL))
+    {
+        buffer[0] = BMM350_SUMMARY_RECORD_VERSION;
+        put_uint32(record->start_ms, &buffer[2]);
+        put_uint32(record->duration_ms, &buffer[6]);
+        buffer[10] = (uint8_t)(record->count & 0xFF);
+        buffer[11] = (uint8_t)(record->count >> 8);
+
+        pos = &buffer[12];
+
+        for (indx = 0; indx < 3; indx++)
+        {
+            put_int16(record->axis[indx].mean, BMM350_SUMMARY_FIELD_SCALE, &pos[0], &flags);
+            put_int16(record->axis[indx].min, BMM350_SUMMARY_FIELD_SCALE, &pos[2], &flags);
+            put_int16(record->axis[indx].max, BMM350_SUMMARY_FIELD_SCALE, &pos[4], &flags);
+            put_uint16(record->axis[indx].std, BMM350_SUMMARY_STD_SCALE, &pos[6], &flags);
+            pos += 8;
+        }
+
+        put_uint16(record->magnitude.mean, BMM350_SUMMARY_FIELD_SCALE, &buffer[36], &flags);
+        put_uint16(record->magnitude.min, BMM350_SUMMARY_FIELD_SCALE, &buffer[38], &flags);
+        put_uint16(record->magnitude.max, BMM350_SUMMARY_FIELD_SCALE, &buffer[40], &flags);
+        put_uint16(record->magnitude.std, BMM350_SUMMARY_STD_SCALE, &buffer[42], &flags);
+
+        put_int16(record->temperature.mean, BMM350_SUMMARY_TEMP_SCALE, &buffer[44], &flags);
+        put_int16(record->temperature.min, BMM350_SUMMARY_TEMP_SCALE, &buffer[46], &flags);
+        put_int16(record->temperature.max, BMM350_SUMMARY_TEMP_SCALE, &buffer[48], &flags);
+
+        buffer[50] = (uint8_t)(record->oor_count & 0xFF);
+        buffer[51] = (uint8_t)(record->oor_count >> 8);
+        buffer[52] = (uint8_t)(record->self_test_count & 0xFF);
+        buffer[53] = (uint8_t)(record->self_test_count >> 8);
+
+        buffer[1] = flags;
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
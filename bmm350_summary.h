@@ -0,0 +1,239 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file       bmm350_summary.h
+* @date       2023-05-26
+* @version    v1.4.0
+*
+*/
+
+#ifndef _BMM350_SUMMARY_H
+#define _BMM350_SUMMARY_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#include "bmm350.h"
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/*! @name        General Macro Definitions                                    */
+/******************************************************************************/
+
+/*! Sample flags passed to bmm350_summary_add */
+#define BMM350_SUMMARY_FLAG_NONE       UINT8_C(0x00)
+
+/*! Sample was out of range, e.g. from bmm350_oor_read */
+#define BMM350_SUMMARY_FLAG_OOR        UINT8_C(0x01)
+
+/*! A self-test was active during the sample */
+#define BMM350_SUMMARY_FLAG_SELF_TEST  UINT8_C(0x02)
+
+/*! Version of the encoded record */
+#define BMM350_SUMMARY_RECORD_VERSION  UINT8_C(1)
+
+/*! Length of the encoded record in bytes */
+#define BMM350_SUMMARY_RECORD_LEN      UINT8_C(54)
+
+/*! Encoded record resolution: 0.1uT for field values, 0.01uT for standard deviations, 0.01degC */
+#define BMM350_SUMMARY_FIELD_SCALE     (10.0f)
+#define BMM350_SUMMARY_STD_SCALE       (100.0f)
+#define BMM350_SUMMARY_TEMP_SCALE      (100.0f)
+
+/*! Record flag: at least one value was clipped to the encoded range */
+#define BMM350_SUMMARY_REC_SATURATED   UINT8_C(0x01)
+
+/************************* Structure definitions *************************/
+
+/*!
+ * @brief Structure to define the statistics of one quantity
+ */
+struct bmm350_summary_stat
+{
+    float mean;
+    float min;
+    float max;
+    float std;
+};
+
+/*!
+ * @brief Structure to define the summary of one interval
+ */
+struct bmm350_summary_record
+{
+    /*! Timestamp of the first sample of the interval in ms */
+    uint32_t start_ms;
+
+    /*! Time from the first to the last sample in ms */
+    uint32_t duration_ms;
+
+    /*! Number of samples */
+    uint16_t count;
+
+    /*! X, Y and Z axis statistics in uT */
+    struct bmm350_summary_stat axis[3];
+
+    /*! Field magnitude |B| statistics in uT */
+    struct bmm350_summary_stat magnitude;
+
+    /*! Temperature statistics in degC, std is not used */
+    struct bmm350_summary_stat temperature;
+
+    /*! Number of out of range samples */
+    uint16_t oor_count;
+
+    /*! Number of samples with self-test active */
+    uint16_t self_test_count;
+};
+
+/*!
+ * @brief Structure to define the running accumulation of one quantity (Welford)
+ */
+struct bmm350_summary_acc
+{
+    float mean;
+    float m2;
+    float min;
+    float max;
+};
+
+/*!
+ * @brief Structure to define the state of the summary aggregation
+ */
+struct bmm350_summary
+{
+    /*! Interval length in ms */
+    uint32_t interval_ms;
+
+    /*! Timestamps of the first and last sample of the open interval in ms */
+    uint32_t start_ms;
+    uint32_t last_ms;
+
+    /*! Number of samples in the open interval */
+    uint16_t count;
+
+    /*! Accumulators for X, Y, Z, |B| and temperature */
+    struct bmm350_summary_acc acc[5];
+
+    /*! Counters of the open interval */
+    uint16_t oor_count;
+    uint16_t self_test_count;
+};
+
+/******************* Function prototype declarations ********************/
+
+/*!
+ * @brief Function to initialize the summary aggregation.
+ *
+ * @param[in] interval_ms    : Interval length in ms
+ * @param[out] summary       : Structure that stores the state of the aggregation
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_summary_init(uint32_t interval_ms, struct bmm350_summary *summary);
+
+/*!
+ * @brief Function to add a compensated sample. When the sample falls past the end of the
+ * open interval, the interval is closed into record and the sample opens the next one.
+ * Each sample is processed once in constant time and memory.
+ *
+ * @param[in] data           : Compensated sample
+ * @param[in] timestamp_ms   : Timestamp of the sample in ms
+ * @param[in] flags          : BMM350_SUMMARY_FLAG_* of the sample
+ * @param[out] ready         : Set to true when record holds a closed interval
+ * @param[out] record        : Summary of the closed interval
+ * @param[in,out] summary    : Structure that stores the state of the aggregation
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_summary_add(const struct bmm350_mag_temp_data *data,
+                          uint32_t timestamp_ms,
+                          uint8_t flags,
+                          bool *ready,
+                          struct bmm350_summary_record *record,
+                          struct bmm350_summary *summary);
+
+/*!
+ * @brief Function to close the open interval, e.g. before shutdown.
+ *
+ * @param[out] ready         : Set to true when record holds a closed interval, false if it was empty
+ * @param[out] record        : Summary of the closed interval
+ * @param[in,out] summary    : Structure that stores the state of the aggregation
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_summary_flush(bool *ready, struct bmm350_summary_record *record, struct bmm350_summary *summary);
+
+/*!
+ * @brief Function to encode a summary into a fixed size little endian record for transmission.
+ *
+ * @details Record layout (BMM350_SUMMARY_RECORD_LEN bytes):
+ *
+ *@verbatim
+ * Offset | Size | Content
+ * -------|------|----------------------------------------------------
+ *  0     | 1    | Version (BMM350_SUMMARY_RECORD_VERSION)
+ *  1     | 1    | Flags (BMM350_SUMMARY_REC_SATURATED)
+ *  2     | 4    | start_ms
+ *  6     | 4    | duration_ms
+ *  10    | 2    | count
+ *  12    | 24   | X, Y, Z: mean, min, max (int16, 0.1uT), std (uint16, 0.01uT)
+ *  36    | 8    | |B|: mean, min, max (uint16, 0.1uT), std (uint16, 0.01uT)
+ *  44    | 6    | Temperature: mean, min, max (int16, 0.01degC)
+ *  50    | 2    | oor_count
+ *  52    | 2    | self_test_count
+ *@endverbatim
+ *
+ * @param[in] record         : Summary of an interval
+ * @param[out] buffer        : Buffer of BMM350_SUMMARY_RECORD_LEN bytes
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+int8_t bmm350_summary_encode(const struct bmm350_summary_record *record, uint8_t *buffer);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _BMM350_SUMMARY_H */
@@ -0,0 +1,315 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_decimate_accuracy.c
+*
+* @brief Accuracy check of raw domain decimation against compensate-then-decimate on synthetic raw data.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bmm350_decimate.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Raw samples per run */
+#define NUM_SAMPLES      UINT32_C(20000)
+
+/*! Raw temperature at the start of a run and slope of the temperature ramp in lsb per sample */
+#define RAW_TEMP_START   INT32_C(3000000)
+#define RAW_TEMP_RAMP    INT32_C(200)
+
+/*! Relative float rounding allowed on top of the bound */
+#define FLOAT_ROUNDING   (1e-5)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Structure to define the result of one run
+ */
+struct run_result
+{
+    /*! Largest difference between both paths in uT */
+    double max_error;
+
+    /*! Bound at the window of the largest difference in uT */
+    double bound_at_max;
+
+    /*! Largest temperature step over a window in degC */
+    double max_dt;
+
+    /*! Windows exceeding the bound */
+    uint32_t fail_count;
+};
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to set exaggerated compensation coefficients, so the temperature terms
+ *  of the bound are visible above float rounding.
+ *
+ *  @param[out] dev       : Structure instance of bmm350_dev.
+ *
+ *  @return void.
+ */
+static void set_coefficients(struct bmm350_dev *dev);
+
+/*!
+ *  @brief This internal API is used to generate a raw sample: a sine on x, constant y and z, and small noise.
+ *
+ *  @param[in] indx       : Sample index
+ *  @param[in] temp_ramp  : Slope of the raw temperature in lsb per sample
+ *  @param[out] raw_data  : Raw sample
+ *
+ *  @return void.
+ */
+static void generate_sample(uint32_t indx, int32_t temp_ramp, struct bmm350_raw_mag_data *raw_data);
+
+/*!
+ *  @brief This internal API is used to feed the same raw samples through both paths and compare every window.
+ *
+ *  @param[in] factor     : Decimation factor
+ *  @param[in] temp_ramp  : Slope of the raw temperature in lsb per sample
+ *  @param[in] dev        : Structure instance of bmm350_dev.
+ *  @param[out] res       : Result of the run
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_factor(uint16_t factor,
+                         int32_t temp_ramp,
+                         const struct bmm350_dev *dev,
+                         struct run_result *res);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(void)
+{
+    int8_t rslt = BMM350_OK;
+    struct bmm350_dev dev = { 0 };
+    struct run_result res;
+    uint32_t fail_count = 0;
+    uint16_t factor;
+    uint8_t ramp;
+
+    set_coefficients(&dev);
+
+    printf("%-12s %6s %10s %12s %12s %8s\n", "temperature", "factor", "dT degC", "max |e| uT", "bound uT", "fails");
+
+    for (ramp = 0; (ramp < 2) && (rslt == BMM350_OK); ramp++)
+    {
+        for (factor = 4; (factor <= BMM350_DECIMATE_MAX_FACTOR) && (rslt == BMM350_OK); factor *= 2)
+        {
+            srand(1);
+            rslt = run_factor(factor, ramp ? RAW_TEMP_RAMP : 0, &dev, &res);
+
+            if (rslt == BMM350_OK)
+            {
+                printf("%-12s %6u %10.4f %12.3g %12.3g %8lu\n",
+                       ramp ? "ramp" : "constant",
+                       factor,
+                       res.max_dt,
+                       res.max_error,
+                       res.bound_at_max,
+                       (unsigned long)res.fail_count);
+
+                fail_count += res.fail_count;
+            }
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("\nWindows exceeding the bound: %lu\n", (unsigned long)fail_count);
+
+        if (fail_count > 0)
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to set exaggerated compensation coefficients.
+ */
+static void set_coefficients(struct bmm350_dev *dev)
+{
+    dev->axis_en = BMM350_EN_XYZ_MSK;
+
+    dev->mag_comp.dut_offset_coef.offset_x = 3.0f;
+    dev->mag_comp.dut_offset_coef.offset_y = -2.0f;
+    dev->mag_comp.dut_sensit_coef.sens_x = 0.01f;
+    dev->mag_comp.dut_sensit_coef.sens_y = -0.01f;
+
+    /* About ten times the coefficients of a typical part */
+    dev->mag_comp.dut_tco.tco_x = 0.05f;
+    dev->mag_comp.dut_tco.tco_y = -0.05f;
+    dev->mag_comp.dut_tcs.tcs_x = 0.002f;
+    dev->mag_comp.dut_tcs.tcs_y = -0.002f;
+    dev->mag_comp.dut_tcs.tcs_z = 0.001f;
+    dev->mag_comp.dut_t0 = 23.0f;
+
+    dev->mag_comp.cross_axis.cross_x_y = 0.01f;
+    dev->mag_comp.cross_axis.cross_y_x = -0.01f;
+    dev->mag_comp.cross_axis.cross_z_x = 0.01f;
+    dev->mag_comp.cross_axis.cross_z_y = -0.005f;
+}
+
+/*!
+ *  @brief This internal API is used to generate a raw sample.
+ */
+static void generate_sample(uint32_t indx, int32_t temp_ramp, struct bmm350_raw_mag_data *raw_data)
+{
+    raw_data->raw_xdata = (int32_t)(200000.0f * sinf((float)indx * 0.003f)) + (rand() % 200) - 100;
+    raw_data->raw_ydata = -300000 + (rand() % 200) - 100;
+    raw_data->raw_zdata = 500000 + (rand() % 50);
+    raw_data->raw_data_t = RAW_TEMP_START + temp_ramp * (int32_t)indx + (rand() % 20);
+}
+
+/*!
+ *  @brief This internal API is used to feed the same raw samples through both paths and compare every window.
+ */
+static int8_t run_factor(uint16_t factor,
+                         int32_t temp_ramp,
+                         const struct bmm350_dev *dev,
+                         struct run_result *res)
+{
+    int8_t rslt;
+    struct bmm350_decimate dec;
+    struct bmm350_raw_mag_data raw_data;
+    struct bmm350_mag_temp_data sample, out;
+    const float tco[3] = { dev->mag_comp.dut_tco.tco_x, dev->mag_comp.dut_tco.tco_y, dev->mag_comp.dut_tco.tco_z };
+    const float tcs[3] = { dev->mag_comp.dut_tcs.tcs_x, dev->mag_comp.dut_tcs.tcs_y, dev->mag_comp.dut_tcs.tcs_z };
+    double sum[4] = { 0.0 }, min[4] = { 0.0 }, max[4] = { 0.0 };
+    double value[4], out_value[3], bound[3];
+    double error, d_t, cross, max_bound;
+    uint32_t indx;
+    uint16_t count = 0;
+    uint8_t axis;
+    bool ready = false;
+
+    /* The cross axis correction mixes the errors of the axes before it by its coefficients */
+    cross = fabs(dev->mag_comp.cross_axis.cross_x_y) + fabs(dev->mag_comp.cross_axis.cross_y_x) +
+            fabs(dev->mag_comp.cross_axis.cross_z_x) + fabs(dev->mag_comp.cross_axis.cross_z_y);
+
+    res->max_error = 0.0;
+    res->bound_at_max = 0.0;
+    res->max_dt = 0.0;
+    res->fail_count = 0;
+
+    rslt = bmm350_decimate_init(factor, &dec);
+
+    for (indx = 0; (indx < NUM_SAMPLES) && (rslt == BMM350_OK); indx++)
+    {
+        generate_sample(indx, temp_ramp, &raw_data);
+
+        /* Reference: compensate every sample, then average the window */
+        rslt = bmm350_compensate_raw_mag_temp_data(&raw_data, 1, &sample, dev);
+
+        if (rslt == BMM350_OK)
+        {
+            value[0] = sample.x;
+            value[1] = sample.y;
+            value[2] = sample.z;
+            value[3] = sample.temperature;
+
+            for (axis = 0; axis < 4; axis++)
+            {
+                sum[axis] += value[axis];
+                min[axis] = ((count == 0) || (value[axis] < min[axis])) ? value[axis] : min[axis];
+                max[axis] = ((count == 0) || (value[axis] > max[axis])) ? value[axis] : max[axis];
+            }
+
+            count++;
+
+            rslt = bmm350_decimate_push(&raw_data, &out, &ready, &dec, dev);
+        }
+
+        if ((rslt == BMM350_OK) && ready)
+        {
+            out_value[0] = out.x;
+            out_value[1] = out.y;
+            out_value[2] = out.z;
+            d_t = max[3] - min[3];
+            max_bound = 0.0;
+
+            /* |e| <= |TCS| * (dB * dT + (|TCO| + |TCS| * |B|) * dT^2) / 4 per axis */
+            for (axis = 0; axis < 3; axis++)
+            {
+                bound[axis] = fabs(tcs[axis]) *
+                              ((max[axis] - min[axis]) * d_t +
+                               (fabs(tco[axis]) + fabs(tcs[axis]) * fmax(fabs(max[axis]), fabs(min[axis]))) * d_t *
+                               d_t) / 4.0;
+                max_bound = fmax(max_bound, bound[axis]);
+            }
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                error = fabs(out_value[axis] - sum[axis] / count);
+                bound[axis] += cross * max_bound + FLOAT_ROUNDING * fabs(sum[axis] / count);
+
+                if (error > bound[axis])
+                {
+                    res->fail_count++;
+                }
+
+                if (error > res->max_error)
+                {
+                    res->max_error = error;
+                    res->bound_at_max = bound[axis];
+                }
+            }
+
+            res->max_dt = fmax(res->max_dt, d_t);
+
+            for (axis = 0; axis < 4; axis++)
+            {
+                sum[axis] = 0.0;
+            }
+
+            count = 0;
+        }
+    }
+
+    return rslt;
+}
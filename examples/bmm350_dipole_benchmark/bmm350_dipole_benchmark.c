@@ -0,0 +1,319 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_dipole_benchmark.c
+*
+* @brief Throughput and convergence benchmark of the dipole solver on simulated scenarios.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bmm350_dipole.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Sensors of the simulated array: 3 x 3 grid */
+#define GRID_SIZE       UINT8_C(3)
+#define NUM_SENSORS     (GRID_SIZE * GRID_SIZE)
+
+/*! Grid pitch in m */
+#define GRID_PITCH      (0.05f)
+
+/*! Frames per scenario and per batch */
+#define NUM_FRAMES      UINT16_C(10000)
+#define BATCH_FRAMES    UINT16_C(100)
+
+/*! Sensor noise in uT (rms, per axis) */
+#define NOISE_UT        (0.5f)
+
+/*! Position error above which a frame counts as lost, in m */
+#define LOST_ERROR      (0.01f)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Structure to define a simulated scenario
+ */
+struct scenario
+{
+    /*! Name printed in the report */
+    const char *name;
+
+    /*! Height of the circular path above the array in m */
+    float height;
+
+    /*! Radius of the circular path in m */
+    float radius;
+
+    /*! Angular step per frame in rad */
+    float step;
+
+    /*! Dipole moment magnitude in A * m^2 */
+    float moment;
+
+    /*! Background field in uT */
+    float background[3];
+
+    /*! Fit the background field */
+    bool fit_background;
+};
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ *
+ *  @return Random value with zero mean and unit variance.
+ */
+static float rand_normal(void);
+
+/*!
+ *  @brief This internal API is used to generate the field of a dipole at all sensors of the array.
+ *
+ *  @param[in] pos        : Sensor positions in m
+ *  @param[in] state      : Dipole position, moment and background
+ *  @param[out] field     : Field buffer of the batch
+ *  @param[in] frame      : Frame index in the batch
+ *
+ *  @return void.
+ */
+static void simulate_frame(const float (*pos)[3],
+                           const struct bmm350_dipole_state *state,
+                           float *field,
+                           uint16_t frame);
+
+/*!
+ *  @brief This internal API is used to run one scenario and print throughput and convergence.
+ *
+ *  @param[in] pos        : Sensor positions in m
+ *  @param[in] scn        : Scenario
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_scenario(const float (*pos)[3], const struct scenario *scn);
+
+/*!
+ *  @brief This internal API is used to compare two floats for qsort.
+ */
+static int compare_float(const void *a, const void *b);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(void)
+{
+    int8_t rslt = BMM350_OK;
+    float pos[NUM_SENSORS][3];
+    uint8_t row, col, indx;
+
+    const struct scenario scenarios[] = {
+        { "slow circle", 0.08f, 0.04f, 0.002f, 0.5f, { 0.0f, 0.0f, 0.0f }, false },
+        { "fast circle", 0.08f, 0.04f, 0.02f, 0.5f, { 0.0f, 0.0f, 0.0f }, false },
+        { "far target", 0.15f, 0.05f, 0.002f, 2.0f, { 0.0f, 0.0f, 0.0f }, false },
+        { "earth field", 0.08f, 0.04f, 0.002f, 0.5f, { 20.0f, 5.0f, -40.0f }, true }
+    };
+
+    for (row = 0; row < GRID_SIZE; row++)
+    {
+        for (col = 0; col < GRID_SIZE; col++)
+        {
+            pos[row * GRID_SIZE + col][0] = ((float)col - 1.0f) * GRID_PITCH;
+            pos[row * GRID_SIZE + col][1] = ((float)row - 1.0f) * GRID_PITCH;
+            pos[row * GRID_SIZE + col][2] = 0.0f;
+        }
+    }
+
+    srand(1);
+
+    printf("%-12s %10s %8s %8s %8s %10s %10s\n", "scenario", "frames/s", "iter", "conv%", "lost%", "err p50mm",
+           "err max mm");
+
+    for (indx = 0; (indx < (sizeof(scenarios) / sizeof(scenarios[0]))) && (rslt == BMM350_OK); indx++)
+    {
+        rslt = run_scenario((const float (*)[3])pos, &scenarios[indx]);
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ */
+static float rand_normal(void)
+{
+    float u1 = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+    float u2 = (float)rand() / (float)RAND_MAX;
+
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+/*!
+ *  @brief This internal API is used to generate the field of a dipole at all sensors of the array.
+ */
+static void simulate_frame(const float (*pos)[3],
+                           const struct bmm350_dipole_state *state,
+                           float *field,
+                           uint16_t frame)
+{
+    uint8_t sensor, axis;
+    float d[3], dist2, inv_r3, md, value;
+
+    for (sensor = 0; sensor < NUM_SENSORS; sensor++)
+    {
+        for (axis = 0; axis < 3; axis++)
+        {
+            d[axis] = pos[sensor][axis] - state->pos[axis];
+        }
+
+        dist2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        inv_r3 = BMM350_DIPOLE_MU0_4PI / (dist2 * sqrtf(dist2));
+        md = state->moment[0] * d[0] + state->moment[1] * d[1] + state->moment[2] * d[2];
+
+        for (axis = 0; axis < 3; axis++)
+        {
+            value = inv_r3 * (3.0f * md * d[axis] / dist2 - state->moment[axis]) + state->background[axis];
+            field[(axis * NUM_SENSORS + sensor) * BATCH_FRAMES + frame] = value + NOISE_UT * rand_normal();
+        }
+    }
+}
+
+/*!
+ *  @brief This internal API is used to compare two floats for qsort.
+ */
+static int compare_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+/*!
+ *  @brief This internal API is used to run one scenario and print throughput and convergence.
+ */
+static int8_t run_scenario(const float (*pos)[3], const struct scenario *scn)
+{
+    int8_t rslt;
+    static float field[3 * NUM_SENSORS * BATCH_FRAMES];
+    static float error[NUM_FRAMES];
+    static struct bmm350_dipole_state truth[BATCH_FRAMES];
+    static struct bmm350_dipole_state solution[BATCH_FRAMES];
+    struct bmm350_dipole dipole;
+    struct bmm350_dipole_state start;
+    struct timespec t_start, t_end;
+    double solve_s = 0.0;
+    uint32_t lost = 0;
+    uint16_t batch, frame;
+    uint8_t axis;
+    float angle, dx, dy, dz;
+
+    rslt = bmm350_dipole_init(pos, NUM_SENSORS, scn->fit_background, &dipole);
+
+    if (rslt == BMM350_OK)
+    {
+        /* Acquisition: start from a coarse guess near the first target position */
+        memset(&start, 0, sizeof(start));
+        start.pos[0] = scn->radius * 0.5f;
+        start.pos[2] = scn->height * 1.2f;
+        start.moment[2] = scn->moment * 0.5f;
+        (void)bmm350_dipole_set_guess(&start, &dipole);
+    }
+
+    for (batch = 0; (batch < (NUM_FRAMES / BATCH_FRAMES)) && (rslt == BMM350_OK); batch++)
+    {
+        for (frame = 0; frame < BATCH_FRAMES; frame++)
+        {
+            angle = scn->step * (float)(batch * BATCH_FRAMES + frame);
+            memset(&truth[frame], 0, sizeof(truth[frame]));
+            truth[frame].pos[0] = scn->radius * cosf(angle);
+            truth[frame].pos[1] = scn->radius * sinf(angle);
+            truth[frame].pos[2] = scn->height;
+
+            /* Moment tilted 30 deg from z, turning with the target */
+            truth[frame].moment[0] = scn->moment * 0.5f * cosf(angle);
+            truth[frame].moment[1] = scn->moment * 0.5f * sinf(angle);
+            truth[frame].moment[2] = scn->moment * 0.866f;
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                truth[frame].background[axis] = scn->background[axis];
+            }
+
+            simulate_frame(pos, &truth[frame], field, frame);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        rslt = bmm350_dipole_solve_batch(field, BATCH_FRAMES, solution, &dipole);
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+        solve_s += (double)(t_end.tv_sec - t_start.tv_sec) + (double)(t_end.tv_nsec - t_start.tv_nsec) / 1e9;
+
+        for (frame = 0; frame < BATCH_FRAMES; frame++)
+        {
+            dx = solution[frame].pos[0] - truth[frame].pos[0];
+            dy = solution[frame].pos[1] - truth[frame].pos[1];
+            dz = solution[frame].pos[2] - truth[frame].pos[2];
+            error[batch * BATCH_FRAMES + frame] = sqrtf(dx * dx + dy * dy + dz * dz);
+
+            if (error[batch * BATCH_FRAMES + frame] > LOST_ERROR)
+            {
+                lost++;
+            }
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        qsort(error, NUM_FRAMES, sizeof(error[0]), compare_float);
+
+        printf("%-12s %10.0f %8.2f %8.1f %8.2f %10.2f %10.2f\n",
+               scn->name,
+               (double)NUM_FRAMES / solve_s,
+               (double)dipole.iteration_count / (double)dipole.frame_count,
+               100.0 * (double)dipole.converged_count / (double)dipole.frame_count,
+               100.0 * (double)lost / (double)NUM_FRAMES,
+               error[NUM_FRAMES / 2] * 1000.0f,
+               error[NUM_FRAMES - 1] * 1000.0f);
+    }
+
+    return rslt;
+}
@@ -0,0 +1,576 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_drdy_recovery.c
+*
+* @brief Runs the interrupt driven acquisition against a simulated sensor whose host loses every 7th data
+* ready edge, in pulsed and latched mode, with and without the edge timeout of bmm350_drdy_recovery.
+*
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bmm350.h"
+#include "bmm350_drdy_recovery.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Simulated run per scenario in s, default */
+#define RUN_TIME_S              UINT32_C(10)
+
+/*! Acquisition: 100Hz, no averaging */
+#define ODR                     BMM350_DATA_RATE_100HZ
+
+/*! Every LOSE_EVERY-th edge on the pin does not reach the host, default */
+#define LOSE_EVERY              UINT32_C(7)
+
+/*! Step of the host loop between polls in us */
+#define HOST_STEP_US            UINT32_C(50)
+
+/*! Simulated bus time per transaction and per byte in us */
+#define BUS_OVERHEAD_US         UINT32_C(20)
+#define BUS_BYTE_US             UINT32_C(25)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Structure to define the simulated sensor and its data ready pin
+ */
+struct sim_sensor
+{
+    /*! Register file */
+    uint8_t regs[128];
+
+    /*! Host time in us */
+    uint64_t time_us;
+
+    /*! Normal mode state: start, period and index of the last sample published */
+    bool normal;
+    uint64_t nm_start_us;
+    uint32_t period_us;
+    uint32_t published;
+
+    /*! Level of a latched pin, edges on the pin and edges lost by the host */
+    bool line;
+    uint32_t pin_edges;
+    uint32_t lost_edges;
+    uint32_t lose_every;
+
+    /*! Edges seen by the host */
+    volatile uint32_t host_edges;
+
+    /*! Acquisition that receives the edges, NULL without recovery */
+    struct bmm350_drdy_recovery *rec;
+};
+
+/*!
+ * @brief Structure to define the results of a scenario
+ */
+struct result
+{
+    /*! Samples published by the sensor and read by the host */
+    uint32_t published;
+    uint32_t read;
+
+    /*! Samples missing from the sensortime and longest gap between two samples in periods */
+    uint32_t missed_samples;
+    uint32_t max_gap;
+};
+
+/******************************************************************************/
+/*!                   Global variables                                        */
+
+/*! Simulated sensor, accessed by the bus callbacks */
+static struct sim_sensor sim;
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to reset the simulated registers to their defaults.
+ */
+static void sim_reset_regs(void);
+
+/*!
+ *  @brief This internal API is used to advance the simulated sensor to the current time:
+ *  publish new samples and drive the data ready pin.
+ */
+static void sim_update(void);
+
+/*!
+ *  @brief This internal API is used to execute a PMU command.
+ */
+static void sim_pmu_cmd(uint8_t cmd);
+
+/*!
+ *  @brief Bus read of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr);
+
+/*!
+ *  @brief Bus write of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr);
+
+/*!
+ *  @brief Delay of the simulated host: advances the simulated time.
+ */
+static void sim_delay_us(uint32_t period_us, void *intf_ptr);
+
+/*!
+ *  @brief This internal API is used to run one scenario.
+ *
+ *  @param[in] latching   : Interrupt mode configured in the sensor
+ *  @param[in] recovery   : Use bmm350_drdy_recovery, or read on edges only
+ *  @param[in] run_s      : Simulated run time in s
+ *  @param[in] lose_every : Every lose_every-th edge is lost, 0 for none
+ *  @param[out] res       : Results of the scenario
+ *  @param[out] stats     : Statistics of bmm350_drdy_recovery
+ *
+ *  @return Result of the configuration
+ */
+static int8_t run_scenario(enum bmm350_intr_latch latching,
+                           bool recovery,
+                           uint32_t run_s,
+                           uint32_t lose_every,
+                           struct result *res,
+                           struct bmm350_drdy_recovery_stats *stats);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(int argc, char *argv[])
+{
+    const char * const modes[2] = { "pulsed", "latched" };
+    const char * const handling[2] = { "edges only", "recovery" };
+
+    uint32_t run_s = RUN_TIME_S;
+    uint32_t lose_every = LOSE_EVERY;
+    struct result res;
+    struct bmm350_drdy_recovery_stats stats;
+    uint8_t mode, recovery;
+    int8_t rslt;
+    int status = EXIT_SUCCESS;
+
+    if (argc > 1)
+    {
+        run_s = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    if (argc > 2)
+    {
+        lose_every = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+
+    if ((run_s == 0) || (lose_every == 1))
+    {
+        fprintf(stderr, "Usage: %s [run time in s] [lose every n-th edge, 0 for none]\n", argv[0]);
+
+        return EXIT_FAILURE;
+    }
+
+    printf("%us per scenario, ODR 100Hz, host loses every %u-th edge\n\n", run_s, lose_every);
+    printf("%-8s %-11s %9s %7s %11s %8s %7s %7s %6s %6s %8s %8s\n", "mode", "handling", "published", "read",
+           "lost edges", "recov'd", "stuck", "late", "empty", "gaps", "missed", "max gap");
+
+    for (mode = 0; mode < 2; mode++)
+    {
+        for (recovery = 0; recovery < 2; recovery++)
+        {
+            rslt = run_scenario((mode == 0) ? BMM350_PULSED : BMM350_LATCHED,
+                                recovery != 0,
+                                run_s,
+                                lose_every,
+                                &res,
+                                &stats);
+
+            if (rslt != BMM350_OK)
+            {
+                printf("%-8s %-11s configuration failed: %d\n", modes[mode], handling[recovery], rslt);
+                status = EXIT_FAILURE;
+                continue;
+            }
+
+            printf("%-8s %-11s %9u %7u %11u %8u %7u %7u %6u %6u %8u %8u\n",
+                   modes[mode],
+                   handling[recovery],
+                   res.published,
+                   res.read,
+                   sim.lost_edges,
+                   stats.missed_edges,
+                   stats.stuck_lines,
+                   stats.late_edges,
+                   stats.empty_timeouts,
+                   stats.missed_samples,
+                   res.missed_samples,
+                   res.max_gap);
+
+            /* With the recovery, no sample may be lost */
+            if ((recovery != 0) && ((res.missed_samples != 0) || (res.read + 1 < res.published)))
+            {
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+
+    printf("\nrecov'd, stuck, late, empty, gaps: bmm350_drdy_recovery statistics; missed: samples missing\n"
+           "from the sensortime as seen by the host; max gap: longest step of the sensortime in periods\n");
+
+    return status;
+}
+
+/*!
+ *  @brief This internal API is used to reset the simulated registers to their defaults.
+ */
+static void sim_reset_regs(void)
+{
+    memset(sim.regs, 0, sizeof(sim.regs));
+    sim.regs[BMM350_REG_CHIP_ID] = BMM350_CHIP_ID;
+    sim.regs[BMM350_REG_PMU_CMD_AGGR_SET] = BMM350_ODR_100HZ;
+    sim.regs[BMM350_REG_PMU_CMD_AXIS_EN] = BMM350_EN_XYZ_MSK;
+    sim.normal = false;
+    sim.period_us = UINT32_C(10000);
+    sim.line = false;
+}
+
+/*!
+ *  @brief This internal API is used to advance the simulated sensor to the current time:
+ *  publish new samples and drive the data ready pin.
+ */
+static void sim_update(void)
+{
+    uint32_t index, sample, sensortime;
+    uint8_t int_ctrl = sim.regs[BMM350_REG_INT_CTRL];
+    bool edge;
+
+    if (!sim.normal || (sim.time_us < sim.nm_start_us + sim.period_us))
+    {
+        return;
+    }
+
+    sample = (uint32_t)((sim.time_us - sim.nm_start_us) / sim.period_us);
+
+    while (sim.published < sample)
+    {
+        sim.published++;
+
+        /* Sensortime of the sample, 25.6kHz */
+        sensortime = (uint32_t)(((sim.nm_start_us + (uint64_t)sim.published * sim.period_us) * 256 / 10000) &
+                                BMM350_SENSORTIME_MASK);
+
+        for (index = 0; index < 3; index++)
+        {
+            sim.regs[BMM350_REG_SENSORTIME_XLSB + index] = (uint8_t)(sensortime >> (8 * index));
+        }
+
+        sim.regs[BMM350_REG_INT_STATUS] |= BMM350_DRDY_DATA_REG_MSK;
+
+        if (((int_ctrl & BMM350_DRDY_DATA_REG_EN_MSK) != 0) && ((int_ctrl & BMM350_INT_OUTPUT_EN_MSK) != 0))
+        {
+            /* A pulse per sample; a latched pin only rises when it was released */
+            edge = ((int_ctrl & BMM350_INT_MODE_MSK) == BMM350_INT_MODE_PULSED) || !sim.line;
+            sim.line = ((int_ctrl & BMM350_INT_MODE_MSK) == BMM350_INT_MODE_LATCHED);
+
+            if (edge)
+            {
+                sim.pin_edges++;
+
+                if ((sim.lose_every != 0) && ((sim.pin_edges % sim.lose_every) == 0))
+                {
+                    sim.lost_edges++;
+                }
+                else
+                {
+                    /* Interrupt handler of the host */
+                    sim.host_edges++;
+                    bmm350_drdy_recovery_isr(sim.rec);
+                }
+            }
+        }
+    }
+}
+
+/*!
+ *  @brief This internal API is used to execute a PMU command.
+ */
+static void sim_pmu_cmd(uint8_t cmd)
+{
+    /* PMU_CMD_VALUE reported for each command */
+    const uint8_t cmd_value[] = {
+        BMM350_PMU_CMD_STATUS_0_SUS, BMM350_PMU_CMD_STATUS_0_NM, BMM350_PMU_CMD_STATUS_0_UPD_OAE,
+        BMM350_PMU_CMD_STATUS_0_FM, BMM350_PMU_CMD_STATUS_0_FM_FAST, BMM350_PMU_CMD_STATUS_0_FGR,
+        BMM350_PMU_CMD_STATUS_0_FGR_FAST, BMM350_PMU_CMD_STATUS_0_BR, BMM350_PMU_CMD_STATUS_0_BR_FAST,
+        BMM350_PMU_CMD_STATUS_0_NM_TC
+    };
+
+    if (cmd <= BMM350_PMU_CMD_NM_TC)
+    {
+        switch (cmd)
+        {
+            case BMM350_PMU_CMD_SUS:
+                sim.normal = false;
+                break;
+
+            case BMM350_PMU_CMD_NM:
+            case BMM350_PMU_CMD_NM_TC:
+                if (!sim.normal)
+                {
+                    sim.normal = true;
+                    sim.nm_start_us = sim.time_us;
+                    sim.published = 0;
+                }
+
+                break;
+
+            case BMM350_PMU_CMD_UPD_OAE:
+                sim.period_us = UINT32_C(625) << (sim.regs[BMM350_REG_PMU_CMD_AGGR_SET] & BMM350_ODR_MSK);
+                break;
+
+            default:
+                break;
+        }
+
+        sim.regs[BMM350_REG_PMU_CMD_STATUS_0] =
+            (uint8_t)((cmd_value[cmd] << BMM350_PMU_CMD_VALUE_POS) | (sim.normal ? BMM350_PWR_MODE_IS_NORMAL_MSK : 0));
+    }
+}
+
+/*!
+ *  @brief Bus read of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    uint32_t index;
+
+    (void)intf_ptr;
+
+    sim.time_us += BUS_OVERHEAD_US + BUS_BYTE_US * (length + 1);
+    sim_update();
+
+    /* Two dummy bytes precede the data */
+    for (index = 0; index < length; index++)
+    {
+        reg_data[index] = (index < BMM350_DUMMY_BYTES) ? 0 : sim.regs[(reg_addr + index - BMM350_DUMMY_BYTES) & 0x7F];
+    }
+
+    /* Reading INT_STATUS clears data ready and releases a latched pin */
+    if ((reg_addr <= BMM350_REG_INT_STATUS) && (reg_addr + length - BMM350_DUMMY_BYTES > BMM350_REG_INT_STATUS))
+    {
+        sim.regs[BMM350_REG_INT_STATUS] &= (uint8_t)~BMM350_DRDY_DATA_REG_MSK;
+        sim.line = false;
+    }
+
+    return BMM350_INTF_RET_SUCCESS;
+}
+
+/*!
+ *  @brief Bus write of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    uint32_t index;
+    uint8_t reg;
+
+    (void)intf_ptr;
+
+    sim.time_us += BUS_OVERHEAD_US + BUS_BYTE_US * (length + 1);
+    sim_update();
+
+    for (index = 0; index < length; index++)
+    {
+        reg = (uint8_t)((reg_addr + index) & 0x7F);
+        sim.regs[reg] = reg_data[index];
+
+        if (reg == BMM350_REG_PMU_CMD)
+        {
+            sim_pmu_cmd(reg_data[index]);
+        }
+        else if ((reg == BMM350_REG_OTP_CMD_REG) && ((reg_data[index] & BMM350_OTP_CMD_DIR_READ) != 0))
+        {
+            /* Blank OTP: all words read as 0 */
+            sim.regs[BMM350_REG_OTP_DATA_MSB_REG] = 0;
+            sim.regs[BMM350_REG_OTP_DATA_LSB_REG] = 0;
+            sim.regs[BMM350_REG_OTP_STATUS_REG] = BMM350_OTP_STATUS_CMD_DONE;
+        }
+        else if ((reg == BMM350_REG_CMD) && (reg_data[index] == BMM350_CMD_SOFTRESET))
+        {
+            sim_reset_regs();
+        }
+    }
+
+    return BMM350_INTF_RET_SUCCESS;
+}
+
+/*!
+ *  @brief Delay of the simulated host: advances the simulated time.
+ */
+static void sim_delay_us(uint32_t period_us, void *intf_ptr)
+{
+    (void)intf_ptr;
+
+    sim.time_us += period_us;
+    sim_update();
+}
+
+/*!
+ *  @brief This internal API is used to run one scenario.
+ */
+static int8_t run_scenario(enum bmm350_intr_latch latching,
+                           bool recovery,
+                           uint32_t run_s,
+                           uint32_t lose_every,
+                           struct result *res,
+                           struct bmm350_drdy_recovery_stats *stats)
+{
+    struct bmm350_dev dev = { 0 };
+    struct bmm350_drdy_recovery rec = { 0 };
+    struct bmm350_timed_mag_temp_data timed_data;
+    struct bmm350_timeline timeline = { 0 };
+    uint64_t end_us, end_ticks, last_ticks = 0;
+    uint32_t handled_edges = 0, published, sensortime, missed, gap;
+    uint32_t period_ticks = BMM350_ODR_PERIOD_BASE_TICKS << ODR;
+    uint8_t drdy;
+    bool ready;
+    int8_t rslt;
+
+    memset(res, 0, sizeof(*res));
+    memset(stats, 0, sizeof(*stats));
+    memset(&sim, 0, sizeof(sim));
+    sim_reset_regs();
+
+    dev.read = sim_read;
+    dev.write = sim_write;
+    dev.delay_us = sim_delay_us;
+
+    rslt = bmm350_init(&dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_configure_interrupt(latching, BMM350_ACTIVE_HIGH, BMM350_INTR_PUSH_PULL, BMM350_MAP_TO_PIN, &dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, &dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_set_odr_performance(ODR, BMM350_NO_AVERAGING, &dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, &dev);
+    }
+
+    if ((rslt == BMM350_OK) && recovery)
+    {
+        rslt = bmm350_drdy_recovery_init(ODR, latching, (uint32_t)sim.time_us, &rec);
+        sim.rec = &rec;
+    }
+
+    if (rslt != BMM350_OK)
+    {
+        return rslt;
+    }
+
+    sim.lose_every = lose_every;
+    published = sim.published;
+    end_us = sim.time_us + (uint64_t)run_s * 1000000;
+
+    while (sim.time_us < end_us)
+    {
+        ready = false;
+
+        if (recovery)
+        {
+            rslt = bmm350_drdy_recovery_poll((uint32_t)sim.time_us, &timed_data, &ready, &rec, &dev);
+        }
+        else if (sim.host_edges != handled_edges)
+        {
+            /* Without the recovery, a sample is only read after an edge */
+            handled_edges = sim.host_edges;
+
+            rslt = bmm350_get_status_compensated_mag_xyz_temp_sensortime(&drdy, &timed_data.data, &sensortime, &dev);
+
+            if ((rslt == BMM350_OK) && (drdy == BMM350_ENABLE))
+            {
+                rslt = bmm350_extend_sensortime(sensortime, 0, NULL, &timeline);
+                timed_data.sensortime = timeline.ticks;
+                ready = true;
+            }
+        }
+
+        if ((rslt == BMM350_OK) && ready)
+        {
+            if (res->read != 0)
+            {
+                gap = (uint32_t)((timed_data.sensortime - last_ticks + period_ticks / 2) / period_ticks);
+                missed = (gap > 1) ? gap - 1 : 0;
+                res->missed_samples += missed;
+
+                if (gap > res->max_gap)
+                {
+                    res->max_gap = gap;
+                }
+            }
+
+            last_ticks = timed_data.sensortime;
+            res->read++;
+        }
+
+        sim_delay_us(HOST_STEP_US, NULL);
+    }
+
+    res->published = sim.published - published;
+
+    /* A stalled acquisition stops reading: count the samples missing up to the end */
+    if (res->read != 0)
+    {
+        end_ticks = (sim.nm_start_us + (uint64_t)sim.published * sim.period_us) * 256 / 10000;
+        res->missed_samples += (uint32_t)((end_ticks - last_ticks + period_ticks / 2) / period_ticks);
+    }
+
+    if (recovery)
+    {
+        *stats = rec.stats;
+    }
+
+    return rslt;
+}
@@ -0,0 +1,154 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_duty_cycle.c
+*
+* @brief This file contains duty cycled forced mode acquisition where every sample
+* is stamped with the always-on sensortime.
+*
+*/
+
+#include <stdio.h>
+#include "bmm350.h"
+#include "bmm350_duty_cycle.h"
+#include "common.h"
+#include "coines.h"
+
+/******************************************************************************/
+/*!                   Macro Definitions                                       */
+
+#define SAMPLE_COUNT          UINT8_C(20)
+
+/*! Time the sensor stays in suspend mode between two conversions */
+#define SUSPEND_PERIOD_US     UINT32_C(200000)
+
+/******************************************************************************/
+/*!            Functions                                                      */
+
+/* This function starts the execution of program */
+int main(void)
+{
+    /* Status of api are returned to this variable */
+    int8_t rslt;
+
+    /* Sensor initialization configuration */
+    struct bmm350_dev dev = { 0 };
+
+    uint8_t int_status;
+    uint8_t loop = SAMPLE_COUNT;
+    uint64_t time_ns, last_time_ns = 0;
+
+    struct bmm350_duty_cycle dc = { 0 };
+    struct bmm350_timed_mag_temp_data timed_data = { { 0 }, 0 };
+
+    /* Update device structure */
+    rslt = bmm350_interface_init(&dev);
+    bmm350_error_codes_print_result("bmm350_interface_selection", rslt);
+
+    /* Initialize BMM350 */
+    rslt = bmm350_init(&dev);
+    bmm350_error_codes_print_result("bmm350_init", rslt);
+
+    printf("Read : 0x00 : BMM350 Chip ID : 0x%X\n", dev.chip_id);
+
+    /* Configure interrupt settings */
+    rslt = bmm350_configure_interrupt(BMM350_PULSED,
+                                      BMM350_ACTIVE_HIGH,
+                                      BMM350_INTR_PUSH_PULL,
+                                      BMM350_UNMAP_FROM_PIN,
+                                      &dev);
+    bmm350_error_codes_print_result("bmm350_configure_interrupt", rslt);
+
+    /* Enable data ready interrupt */
+    rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, &dev);
+    bmm350_error_codes_print_result("bmm350_enable_interrupt", rslt);
+
+    /* Set ODR and performance */
+    rslt = bmm350_set_odr_performance(BMM350_DATA_RATE_100HZ, BMM350_AVERAGING_4, &dev);
+    bmm350_error_codes_print_result("bmm350_set_odr_performance", rslt);
+
+    /* Enable all axis */
+    rslt = bmm350_enable_axes(BMM350_X_EN, BMM350_Y_EN, BMM350_Z_EN, &dev);
+    bmm350_error_codes_print_result("bmm350_enable_axes", rslt);
+
+    /* Enable always-on sensortime and enter suspend mode */
+    rslt = bmm350_duty_cycle_init(BMM350_FORCED_MODE_FAST, &dc, &dev);
+    bmm350_error_codes_print_result("bmm350_duty_cycle_init", rslt);
+
+    if (rslt == BMM350_OK)
+    {
+        printf("Sensortime(secs), Delta(ms), Mag_X(uT), Mag_Y(uT), Mag_Z(uT), Temperature(degC)\n");
+
+        while (loop > 0)
+        {
+            rslt = bmm350_duty_cycle_trigger(&dc, &dev);
+            bmm350_error_codes_print_result("bmm350_duty_cycle_trigger", rslt);
+
+            int_status = 0;
+
+            /* Wait for the data ready of the forced conversion */
+            while ((rslt == BMM350_OK) && !(int_status & BMM350_DRDY_DATA_REG_MSK))
+            {
+                rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, &int_status, 1, &dev);
+            }
+
+            bmm350_error_codes_print_result("bmm350_get_regs", rslt);
+
+            rslt = bmm350_duty_cycle_read(&timed_data, &dc, &dev);
+            bmm350_error_codes_print_result("bmm350_duty_cycle_read", rslt);
+
+            time_ns = bmm350_duty_cycle_ticks_to_ns(timed_data.sensortime);
+
+            printf("%lu.%09lu, %lu.%03lu, %f, %f, %f, %f\n",
+                   (long unsigned int)(time_ns / 1000000000),
+                   (long unsigned int)(time_ns % 1000000000),
+                   (long unsigned int)((time_ns - last_time_ns) / 1000000),
+                   (long unsigned int)(((time_ns - last_time_ns) / 1000) % 1000),
+                   timed_data.data.x,
+                   timed_data.data.y,
+                   timed_data.data.z,
+                   timed_data.data.temperature);
+
+            last_time_ns = time_ns;
+
+            /* Sensor returns to suspend mode after the conversion, sensortime keeps running */
+            rslt = bmm350_delay_us(SUSPEND_PERIOD_US, &dev);
+            bmm350_error_codes_print_result("bmm350_delay_us", rslt);
+
+            loop--;
+        }
+    }
+
+    bmm350_coines_deinit();
+
+    return rslt;
+}
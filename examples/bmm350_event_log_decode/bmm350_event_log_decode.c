@@ -0,0 +1,272 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_event_log_decode.c
+*
+* @brief Offline decoder that prints a dump of the bmm350 event log as text.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bmm350_defs.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Length of a sensortime tick in ns */
+#define SENSORTIME_TICK_NS  (39062.5)
+
+/******************************************************************************/
+/*!                   Static function definitions                             */
+
+/*!
+ *  @brief This internal API returns the name of an error code.
+ */
+static const char *code_name(int8_t code)
+{
+    static const char * const names[] = {
+        "BMM350_OK", "BMM350_E_NULL_PTR", "BMM350_E_COM_FAIL", "BMM350_E_DEV_NOT_FOUND", "BMM350_E_INVALID_CONFIG",
+        "BMM350_E_BAD_PAD_DRIVE", "BMM350_E_RESET_UNFINISHED", "BMM350_E_INVALID_INPUT",
+        "BMM350_E_SELF_TEST_INVALID_AXIS", "BMM350_E_OTP_BOOT", "BMM350_E_OTP_PAGE_RD", "BMM350_E_OTP_PAGE_PRG",
+        "BMM350_E_OTP_SIGN", "BMM350_E_OTP_INV_CMD", "BMM350_E_OTP_UNDEFINED", "BMM350_E_ALL_AXIS_DISABLED",
+        "BMM350_E_PMU_CMD_VALUE"
+    };
+
+    const char *name = "UNKNOWN";
+
+    if ((code <= 0) && (-code < (int)(sizeof(names) / sizeof(names[0]))))
+    {
+        name = names[-code];
+    }
+
+    return name;
+}
+
+/*!
+ *  @brief This internal API returns the name of a PMU command.
+ */
+static const char *pmu_cmd_name(uint8_t cmd)
+{
+    static const char * const names[] = {
+        "SUS", "NM", "UPD_OAE", "FM", "FM_FAST", "FGR", "FGR_FAST", "BR", "BR_FAST", "NM_TC"
+    };
+
+    const char *name = "UNKNOWN";
+
+    if (cmd < (sizeof(names) / sizeof(names[0])))
+    {
+        name = names[cmd];
+    }
+    else if (cmd == BMM350_CMD_SOFTRESET)
+    {
+        name = "SOFTRESET";
+    }
+
+    return name;
+}
+
+/*!
+ *  @brief This internal API prints the PMU status of a PMU status or PMU error event.
+ */
+static void print_pmu_status(uint16_t arg)
+{
+    uint8_t flags = (uint8_t)(arg >> 8);
+
+    printf("pmu_cmd_value=%u%s%s%s%s%s", arg & 0xFF, (flags & BMM350_EVENT_PMU_BUSY) ? " busy" : "",
+           (flags & BMM350_EVENT_PMU_ODR_OVWR) ? " odr_ovwr" : "",
+           (flags & BMM350_EVENT_PMU_AVG_OVWR) ? " avg_ovwr" : "",
+           (flags & BMM350_EVENT_PMU_NORMAL) ? " normal" : "", (flags & BMM350_EVENT_PMU_ILLEGAL) ? " illegal" : "");
+}
+
+/*!
+ *  @brief This internal API prints the register write of a configuration event.
+ */
+static void print_config(uint16_t arg)
+{
+    uint8_t reg = (uint8_t)(arg & 0xFF);
+    uint8_t value = (uint8_t)(arg >> 8);
+    uint8_t odr;
+
+    switch (reg)
+    {
+        case BMM350_REG_PMU_CMD:
+            printf("power mode %s", pmu_cmd_name(value));
+            break;
+
+        case BMM350_REG_PMU_CMD_AGGR_SET:
+            odr = value & BMM350_ODR_MSK;
+
+            if ((odr >= BMM350_ODR_400HZ) && (odr <= BMM350_ODR_1_5625HZ))
+            {
+                printf("odr %gHz", 400.0 / (double)(1u << (odr - BMM350_ODR_400HZ)));
+            }
+            else
+            {
+                printf("odr 0x%X", odr);
+            }
+
+            printf(" avg %u", 1u << ((value & BMM350_AVG_MSK) >> BMM350_AVG_POS));
+            break;
+
+        case BMM350_REG_PMU_CMD_AXIS_EN:
+            printf("axes%s%s%s", (value & BMM350_EN_X_MSK) ? " x" : "", (value & BMM350_EN_Y_MSK) ? " y" : "",
+                   (value & BMM350_EN_Z_MSK) ? " z" : "");
+            break;
+
+        default:
+            printf("reg 0x%02X = 0x%02X", reg, value);
+            break;
+    }
+}
+
+/*!
+ *  @brief This internal API prints one event.
+ */
+static void print_event(unsigned long seq, const uint8_t *record)
+{
+    uint32_t host_time_us = (uint32_t)record[0] | ((uint32_t)record[1] << 8) | ((uint32_t)record[2] << 16) |
+                            ((uint32_t)record[3] << 24);
+    uint32_t sensortime = (uint32_t)record[4] | ((uint32_t)record[5] << 8) | ((uint32_t)record[6] << 16);
+    uint8_t type = record[8];
+    int8_t code = (int8_t)record[9];
+    uint16_t arg = (uint16_t)(record[10] | ((uint16_t)record[11] << 8));
+
+    printf("#%-6lu host %10lu us  st %8lu (%12.6f s)  ",
+           seq,
+           (unsigned long)host_time_us,
+           (unsigned long)sensortime,
+           sensortime * SENSORTIME_TICK_NS / 1e9);
+
+    switch (type)
+    {
+        case BMM350_EVENT_ERROR:
+            printf("ERROR      %s ", code_name(code));
+
+            if (code == BMM350_E_PMU_CMD_VALUE)
+            {
+                print_pmu_status(arg);
+            }
+            else if (code == BMM350_E_DEV_NOT_FOUND)
+            {
+                printf("chip_id=0x%02X", arg & 0xFF);
+            }
+            else if ((code <= BMM350_E_OTP_BOOT) && (code >= BMM350_E_OTP_UNDEFINED))
+            {
+                printf("otp_addr=0x%02X", arg & 0xFF);
+            }
+            else
+            {
+                printf("reg=0x%02X", arg & 0xFF);
+            }
+
+            break;
+
+        case BMM350_EVENT_PMU_STATUS:
+            printf("PMU_STATUS ");
+            print_pmu_status(arg);
+            break;
+
+        case BMM350_EVENT_RESET:
+            printf("RESET      %s %s", pmu_cmd_name((uint8_t)arg), code_name(code));
+            break;
+
+        case BMM350_EVENT_OOR:
+            printf("OOR        %s", arg ? "out of range" : "in range");
+            break;
+
+        case BMM350_EVENT_RETRY:
+            printf("RETRY      attempt %u %s", arg & 0xFF, code_name(code));
+            break;
+
+        case BMM350_EVENT_CONFIG:
+            printf("CONFIG     ");
+            print_config(arg);
+            printf(" %s", code_name(code));
+            break;
+
+        default:
+            printf("TYPE %u     code %d arg 0x%04X", type, code, arg);
+            break;
+    }
+
+    printf("\n");
+}
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(int argc, char *argv[])
+{
+    FILE *file = stdin;
+    uint8_t record[BMM350_EVENT_LEN];
+    unsigned long seq = 0;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "Usage: %s <dump.bin|-> [first_seq]\n", argv[0]);
+
+        return EXIT_FAILURE;
+    }
+
+    if ((argv[1][0] != '-') || (argv[1][1] != '\0'))
+    {
+        file = fopen(argv[1], "rb");
+
+        if (file == NULL)
+        {
+            perror(argv[1]);
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc == 3)
+    {
+        seq = strtoul(argv[2], NULL, 0);
+    }
+
+    while (fread(record, 1, sizeof(record), file) == sizeof(record))
+    {
+        print_event(seq, record);
+        seq++;
+    }
+
+    if (file != stdin)
+    {
+        fclose(file);
+    }
+
+    return EXIT_SUCCESS;
+}
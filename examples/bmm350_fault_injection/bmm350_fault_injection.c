@@ -0,0 +1,1062 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_fault_injection.c
+*
+* @brief Fault injection harness: runs the driver against a simulated sensor, injects bus, PMU,
+* OTP and field faults and bus hangs, and measures recovery time, samples lost and the error codes
+* surfaced. Bus hangs are recovered with bmm350_i2c_recovery.
+*
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bmm350.h"
+#include "bmm350_i2c_recovery.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Simulated run per scenario in s, default */
+#define RUN_TIME_S              UINT32_C(60)
+
+/*! Acquisition: 100Hz, no averaging */
+#define ODR                     BMM350_DATA_RATE_100HZ
+#define ODR_PERIOD_US           UINT32_C(10000)
+
+/*! Polling interval of INT_STATUS in us */
+#define POLL_US                 UINT32_C(1000)
+
+/*! Application workload: magnetic reset every 2s, power cycle (re-init) every 10s */
+#define MAINT_RESET_PERIOD_US   UINT64_C(2000000)
+#define REINIT_PERIOD_US        UINT64_C(10000000)
+
+/*! Recovery policy: retries of a failed access, delay between retries, stall timeout in periods,
+ *  delay between re-init attempts */
+#define MAX_RETRIES             UINT8_C(3)
+#define RETRY_DELAY_US          UINT32_C(1000)
+#define STALL_PERIODS           UINT8_C(5)
+#define REINIT_BACKOFF_US       UINT32_C(10000)
+
+/*! Out of range detection thresholds in uT, as in bmm350_oor */
+#define OOR_ENTER_UT            (2400.0f)
+#define OOR_EXIT_UT             (2000.0f)
+
+/*! Simulated sensor: bus time per transaction and per byte in us, full scale and noise in uT,
+ *  tolerance of a valid sample in uT */
+#define BUS_OVERHEAD_US         UINT32_C(20)
+#define BUS_BYTE_US             UINT32_C(25)
+#define FULL_SCALE_UT           (2500.0f)
+#define NOISE_UT                (0.1f)
+#define VALID_TOLERANCE_UT      (1.0f)
+
+/*! Fault parameters: NACK burst length, field shock length, amplitude and residual offset */
+#define NACK_BURST_US           UINT32_C(5000)
+#define SHOCK_US                UINT32_C(100000)
+#define SHOCK_UT                (3000.0f)
+#define SHOCK_RESIDUAL_UT       (20.0f)
+
+/*! Bus hang: transfer timeout of the host controller in us, result the bus callbacks return for it
+ *  (-ETIMEDOUT as with i2c-dev), share of the hangs after which the device has been reset */
+#define HOST_TIMEOUT_US         UINT32_C(1000)
+#define BUS_TIMEOUT_CODE        (-110)
+#define HANG_RESET_SHARE        (0.5f)
+
+/*! I2C recovery: bus clock, time of a bus clear (nine clocks and a stop) in us, attempts */
+#define BUS_SPEED_HZ            UINT32_C(400000)
+#define BUS_CLEAR_US            UINT32_C(25)
+#define I2C_RECOVERY_ATTEMPTS   UINT8_C(3)
+
+/*! Pending recoveries kept per scenario */
+#define MAX_PENDING             UINT8_C(16)
+
+/*! Error codes counted, BMM350_E_PMU_CMD_VALUE is the last one */
+#define NUM_CODES               UINT8_C(17)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Fault types
+ */
+enum fault_type {
+    FAULT_NONE,
+    FAULT_NACK,
+    FAULT_STUCK_BUSY,
+    FAULT_OTP_ERROR,
+    FAULT_ILLEGAL_CMD,
+    FAULT_SHOCK,
+    FAULT_BUS_HANG,
+    NUM_FAULTS
+};
+
+/*!
+ * @brief Structure to define the simulated sensor with its fault state
+ */
+struct sim_sensor
+{
+    /*! Register file */
+    uint8_t regs[128];
+
+    /*! Host time in us */
+    uint64_t time_us;
+
+    /*! Normal mode state: start, period and index of the last sample published */
+    bool normal;
+    uint64_t nm_start_us;
+    uint32_t period_us;
+    uint32_t published;
+
+    /*! Samples published since the start of the run; also the serial number of the sample in the data registers */
+    uint32_t published_total;
+
+    /*! Undisturbed field, and the residual offset left by a field shock until a flux guide reset */
+    float field[3];
+    float residual[3];
+
+    /*! Fault injected by this scenario and its rate in 1/s */
+    enum fault_type fault;
+    float rate;
+
+    /*! Time of the next injection */
+    uint64_t next_fault_us;
+
+    /*! Active faults: end of NACK burst and of field shock, PMU hung, pending one-shot faults */
+    uint64_t nack_until_us;
+    uint64_t shock_until_us;
+    bool pmu_hung;
+    bool illegal_pending;
+    bool otp_error_pending;
+
+    /*! Bus held by the sensor until bus_release_us; the device is reset on release if reset_on_release is set */
+    bool bus_hung;
+    bool reset_on_release;
+    uint64_t bus_release_us;
+
+    /*! Faults injected and activated; activation times not yet recovered, and whether the application saw
+     *  an error code, an invalid sample or a stall since */
+    uint32_t injected;
+    uint32_t activated;
+    uint64_t pending_us[MAX_PENDING];
+    bool pending_detected[MAX_PENDING];
+    uint8_t n_pending;
+
+    /*! PRNG state */
+    uint32_t seed;
+};
+
+/*!
+ * @brief Structure to define the results of a scenario
+ */
+struct result
+{
+    /*! Samples published by the sensor, valid samples delivered to the application, and samples overwritten
+     *  unread while the workload reset or re-initialized the sensor */
+    uint32_t published;
+    uint32_t valid;
+    uint32_t consumed;
+
+    /*! Recovery time statistics in us */
+    uint32_t recoveries;
+    uint64_t recovery_sum_us;
+    uint64_t recovery_max_us;
+
+    /*! Activated faults followed by a valid sample without being detected; not counted as recoveries */
+    uint32_t undetected;
+
+    /*! Error codes returned by the API, indexed by -code */
+    uint32_t codes[NUM_CODES];
+
+    /*! Retries and re-initializations of the recovery policy */
+    uint32_t retries;
+    uint32_t reinits;
+
+    /*! I2C recovery statistics, time spent in bmm350_i2c_recovery_handle for recovered hangs in us,
+     *  without [0] and with [1] resynchronization of the configuration */
+    struct bmm350_i2c_recovery_stats i2c;
+    uint64_t hang_cost_sum_us[2];
+    uint64_t hang_cost_max_us[2];
+};
+
+/******************************************************************************/
+/*!                   Global variables                                        */
+
+/*! Simulated sensor, accessed by the bus callbacks */
+static struct sim_sensor sim;
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to generate a uniform random value in [0, 1).
+ */
+static float rand_uniform(void);
+
+/*!
+ *  @brief This internal API is used to reset the simulated registers to their defaults.
+ */
+static void sim_reset_regs(void);
+
+/*!
+ *  @brief This internal API is used to activate a fault and remember it for the recovery time.
+ */
+static void sim_activate(void);
+
+/*!
+ *  @brief This internal API is used to mark the pending faults as detected by the application.
+ */
+static void sim_detect(void);
+
+/*!
+ *  @brief This internal API is used to advance the simulated sensor to the current time:
+ *  inject faults and publish new samples.
+ */
+static void sim_update(void);
+
+/*!
+ *  @brief This internal API is used to execute a PMU command.
+ */
+static void sim_pmu_cmd(uint8_t cmd);
+
+/*!
+ *  @brief This internal API is used to release a hung bus, resetting the device if the hang came with a reset.
+ */
+static void sim_release_bus(void);
+
+/*!
+ *  @brief Bus clear of the simulated host: nine clocks and a stop condition release the bus.
+ */
+static BMM350_INTF_RET_TYPE sim_bus_clear(void *intf_ptr);
+
+/*!
+ *  @brief Bus read of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr);
+
+/*!
+ *  @brief Bus write of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr);
+
+/*!
+ *  @brief Delay of the simulated host: advances the simulated time.
+ */
+static void sim_delay_us(uint32_t period_us, void *intf_ptr);
+
+/*!
+ *  @brief This internal API is used to record the result of an API call.
+ */
+static void count_code(int8_t rslt, struct result *res);
+
+/*!
+ *  @brief This internal API is used to initialize and configure the sensor and the I2C recovery,
+ *  repeating until it succeeds.
+ *
+ *  @param[out] res       : Results of the scenario
+ *  @param[in,out] i2c_rec: I2C recovery, its statistics are kept
+ *  @param[in,out] dev    : Structure instance of bmm350_dev
+ *  @param[in] end_us     : End of the run
+ *
+ *  @return Number of attempts
+ */
+static uint32_t reinit(struct result *res,
+                       struct bmm350_i2c_recovery *i2c_rec,
+                       struct bmm350_dev *dev,
+                       uint64_t end_us);
+
+/*!
+ *  @brief This internal API is used to run one scenario.
+ *
+ *  @param[in] fault      : Injected fault
+ *  @param[in] rate       : Injection rate in 1/s
+ *  @param[in] run_s      : Simulated run time in s
+ *  @param[out] res       : Results of the scenario
+ */
+static void run_scenario(enum fault_type fault, float rate, uint32_t run_s, struct result *res);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(int argc, char *argv[])
+{
+    const char * const names[NUM_FAULTS] = {
+        "none", "nack", "stuck busy", "otp error", "illegal cmd", "field shock", "bus hang"
+    };
+
+    /* Default injection rates in 1/s */
+    const float rates[NUM_FAULTS] = { 0.0f, 0.5f, 0.1f, 0.5f, 0.5f, 0.2f, 0.5f };
+
+    uint32_t run_s = RUN_TIME_S;
+    float scale = 1.0f;
+    struct result res, hang;
+    uint8_t fault, code;
+
+    if (argc > 1)
+    {
+        run_s = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    if (argc > 2)
+    {
+        scale = strtof(argv[2], NULL);
+    }
+
+    if ((run_s == 0) || (scale <= 0.0f))
+    {
+        fprintf(stderr, "Usage: %s [run time in s] [rate scale]\n", argv[0]);
+
+        return EXIT_FAILURE;
+    }
+
+    printf("%us per fault type, ODR 100Hz, magnetic reset every 2s, re-init every 10s\n\n", run_s);
+    printf("%-12s %7s %9s %7s %7s %9s %9s %7s %10s %10s %7s %7s  %s\n", "fault", "rate/s", "injected", "active",
+           "undet", "published", "valid", "lost", "rec avg ms", "rec max ms", "retries", "reinits", "error codes");
+
+    for (fault = FAULT_NONE; fault < NUM_FAULTS; fault++)
+    {
+        run_scenario((enum fault_type)fault, rates[fault] * scale, run_s, &res);
+
+        /* Samples lost to the faults: published, not consumed by the workload and not delivered as valid */
+        printf("%-12s %7.2f %9u %7u %7u %9u %9u %7u %10.1f %10.1f %7u %7u ",
+               names[fault],
+               rates[fault] * scale,
+               sim.injected,
+               sim.activated,
+               res.undetected,
+               res.published,
+               res.valid,
+               res.published - res.consumed - res.valid,
+               (res.recoveries != 0) ? ((double)res.recovery_sum_us / res.recoveries / 1000.0) : 0.0,
+               (double)res.recovery_max_us / 1000.0,
+               res.retries,
+               res.reinits);
+
+        for (code = 1; code < NUM_CODES; code++)
+        {
+            if (res.codes[code] != 0)
+            {
+                printf(" %d:%u", -(int)code, res.codes[code]);
+            }
+        }
+
+        printf("\n");
+
+        if (fault == FAULT_BUS_HANG)
+        {
+            hang = res;
+        }
+    }
+
+    printf("\nbus hang: %u detected, %u recovered, %u failed\n",
+           hang.i2c.hangs,
+           hang.i2c.recoveries,
+           hang.i2c.failures);
+    printf("time in bmm350_i2c_recovery_handle: avg %.2f ms, max %.2f ms for %u hangs without resync, "
+           "avg %.2f ms, max %.2f ms for %u hangs with resync\n",
+           (hang.i2c.recoveries > hang.i2c.resyncs) ?
+           ((double)hang.hang_cost_sum_us[0] / (hang.i2c.recoveries - hang.i2c.resyncs) / 1000.0) : 0.0,
+           (double)hang.hang_cost_max_us[0] / 1000.0,
+           hang.i2c.recoveries - hang.i2c.resyncs,
+           (hang.i2c.resyncs != 0) ? ((double)hang.hang_cost_sum_us[1] / hang.i2c.resyncs / 1000.0) : 0.0,
+           (double)hang.hang_cost_max_us[1] / 1000.0,
+           hang.i2c.resyncs);
+
+    return EXIT_SUCCESS;
+}
+
+/*!
+ *  @brief This internal API is used to generate a uniform random value in [0, 1).
+ */
+static float rand_uniform(void)
+{
+    /* xorshift32, deterministic across hosts */
+    sim.seed ^= sim.seed << 13;
+    sim.seed ^= sim.seed >> 17;
+    sim.seed ^= sim.seed << 5;
+
+    return (float)(sim.seed >> 8) / 16777216.0f;
+}
+
+/*!
+ *  @brief This internal API is used to reset the simulated registers to their defaults.
+ */
+static void sim_reset_regs(void)
+{
+    memset(sim.regs, 0, sizeof(sim.regs));
+    sim.regs[BMM350_REG_CHIP_ID] = BMM350_CHIP_ID;
+    sim.regs[BMM350_REG_PMU_CMD_AGGR_SET] = BMM350_ODR_100HZ;
+    sim.regs[BMM350_REG_PMU_CMD_AXIS_EN] = BMM350_EN_XYZ_MSK;
+    sim.normal = false;
+    sim.period_us = ODR_PERIOD_US;
+    sim.pmu_hung = false;
+}
+
+/*!
+ *  @brief This internal API is used to activate a fault and remember it for the recovery time.
+ */
+static void sim_activate(void)
+{
+    sim.activated++;
+
+    if (sim.n_pending < MAX_PENDING)
+    {
+        sim.pending_us[sim.n_pending] = sim.time_us;
+        sim.pending_detected[sim.n_pending] = false;
+        sim.n_pending++;
+    }
+}
+
+/*!
+ *  @brief This internal API is used to mark the pending faults as detected by the application.
+ */
+static void sim_detect(void)
+{
+    uint8_t index;
+
+    for (index = 0; index < sim.n_pending; index++)
+    {
+        sim.pending_detected[index] = true;
+    }
+}
+
+/*!
+ *  @brief This internal API is used to advance the simulated sensor to the current time:
+ *  inject faults and publish new samples.
+ */
+static void sim_update(void)
+{
+    uint32_t index, sample;
+    uint8_t axis;
+    float value;
+    int32_t raw;
+
+    /* 1 LSB in uT for x, y and z, as in the driver conversion without OTP corrections */
+    const float lsb_ut[3] = {
+        (1000000.0f / 1048576.0f) / (14.55f * 19.46f * (1 / 1.5f) * 0.714607238769531f),
+        (1000000.0f / 1048576.0f) / (14.55f * 19.46f * (1 / 1.5f) * 0.714607238769531f),
+        (1000000.0f / 1048576.0f) / (9.0f * 31.0f * (1 / 1.5f) * 0.714607238769531f)
+    };
+
+    /* Inject faults as a Poisson process */
+    while ((sim.fault != FAULT_NONE) && (sim.time_us >= sim.next_fault_us))
+    {
+        sim.injected++;
+
+        switch (sim.fault)
+        {
+            case FAULT_NACK:
+                sim.nack_until_us = sim.next_fault_us + NACK_BURST_US;
+                sim_activate();
+                break;
+
+            case FAULT_STUCK_BUSY:
+                sim.pmu_hung = true;
+                sim.regs[BMM350_REG_PMU_CMD_STATUS_0] |= BMM350_PMU_CMD_BUSY_MSK;
+                sim_activate();
+                break;
+
+            case FAULT_OTP_ERROR:
+                sim.otp_error_pending = true;
+                break;
+
+            case FAULT_ILLEGAL_CMD:
+                sim.illegal_pending = true;
+                break;
+
+            case FAULT_SHOCK:
+                sim.shock_until_us = sim.next_fault_us + SHOCK_US;
+                sim.residual[0] = SHOCK_RESIDUAL_UT;
+                sim.residual[1] = -SHOCK_RESIDUAL_UT / 2.0f;
+                sim_activate();
+                break;
+
+            case FAULT_BUS_HANG:
+                /* The sensor holds SDA low; its I2C watchdog, if enabled, releases it after the timeout */
+                sim.bus_hung = true;
+                sim.reset_on_release = (rand_uniform() < HANG_RESET_SHARE);
+
+                if ((sim.regs[BMM350_REG_I2C_WDT_SET] & BMM350_I2C_WDT_EN_MSK) == 0)
+                {
+                    sim.bus_release_us = UINT64_MAX;
+                }
+                else if ((sim.regs[BMM350_REG_I2C_WDT_SET] & BMM350_I2C_WDT_SEL_MSK) != 0)
+                {
+                    sim.bus_release_us = sim.next_fault_us + BMM350_I2C_WDT_LONG_US;
+                }
+                else
+                {
+                    sim.bus_release_us = sim.next_fault_us + BMM350_I2C_WDT_SHORT_US;
+                }
+
+                sim_activate();
+                break;
+
+            default:
+                break;
+        }
+
+        sim.next_fault_us += (uint64_t)(-logf(1.0f - rand_uniform()) / sim.rate * 1e6f) + 1;
+    }
+
+    if (sim.bus_hung && (sim.time_us >= sim.bus_release_us))
+    {
+        sim_release_bus();
+    }
+
+    /* Publish the latest sample; a hung PMU stops the measurements */
+    if (sim.normal && !sim.pmu_hung && (sim.time_us >= sim.nm_start_us + sim.period_us))
+    {
+        sample = (uint32_t)((sim.time_us - sim.nm_start_us) / sim.period_us);
+
+        if (sample != sim.published)
+        {
+            /* Samples overwritten before this one count as published too */
+            sim.published_total += sample - sim.published;
+            sim.published = sample;
+
+            for (axis = 0; axis < 3; axis++)
+            {
+                /* Uniform noise of NOISE_UT rms */
+                value = sim.field[axis] + sim.residual[axis] + NOISE_UT * 1.7320508f * (2.0f * rand_uniform() - 1.0f);
+
+                if (sim.time_us < sim.shock_until_us)
+                {
+                    value += SHOCK_UT;
+                }
+
+                /* Saturate at full scale */
+                value = fminf(fmaxf(value, -FULL_SCALE_UT), FULL_SCALE_UT);
+                raw = (int32_t)lrintf(value / lsb_ut[axis]);
+
+                for (index = 0; index < 3; index++)
+                {
+                    sim.regs[BMM350_REG_MAG_X_XLSB + axis * 3 + index] = (uint8_t)((uint32_t)raw >> (8 * index));
+                }
+            }
+
+            /* Temperature of 25 degC */
+            raw = (int32_t)lrintf(50.49f * (0.00204f * (1 / 1.5f) * 0.714607238769531f * 1048576.0f));
+
+            for (index = 0; index < 3; index++)
+            {
+                sim.regs[BMM350_REG_MAG_X_XLSB + 9 + index] = (uint8_t)((uint32_t)raw >> (8 * index));
+            }
+
+            /* Sensortime of the sample, 25.6kHz */
+            raw = (int32_t)(((sim.nm_start_us + (uint64_t)sample * sim.period_us) * 256 / 10000) & 0xFFFFFF);
+
+            for (index = 0; index < 3; index++)
+            {
+                sim.regs[BMM350_REG_SENSORTIME_XLSB + index] = (uint8_t)((uint32_t)raw >> (8 * index));
+            }
+
+            sim.regs[BMM350_REG_INT_STATUS] |= BMM350_DRDY_DATA_REG_MSK;
+        }
+    }
+}
+
+/*!
+ *  @brief This internal API is used to execute a PMU command.
+ */
+static void sim_pmu_cmd(uint8_t cmd)
+{
+    /* PMU_CMD_VALUE reported for each command */
+    const uint8_t cmd_value[] = {
+        BMM350_PMU_CMD_STATUS_0_SUS, BMM350_PMU_CMD_STATUS_0_NM, BMM350_PMU_CMD_STATUS_0_UPD_OAE,
+        BMM350_PMU_CMD_STATUS_0_FM, BMM350_PMU_CMD_STATUS_0_FM_FAST, BMM350_PMU_CMD_STATUS_0_FGR,
+        BMM350_PMU_CMD_STATUS_0_FGR_FAST, BMM350_PMU_CMD_STATUS_0_BR, BMM350_PMU_CMD_STATUS_0_BR_FAST,
+        BMM350_PMU_CMD_STATUS_0_NM_TC
+    };
+
+    uint8_t *status = &sim.regs[BMM350_REG_PMU_CMD_STATUS_0];
+
+    if (sim.pmu_hung || (cmd > BMM350_PMU_CMD_NM_TC))
+    {
+        /* Ignored: the PMU does not accept commands */
+    }
+    else if (sim.illegal_pending)
+    {
+        sim.illegal_pending = false;
+        *status |= BMM350_CMD_IS_ILLEGAL_MSK;
+        sim_activate();
+    }
+    else
+    {
+        switch (cmd)
+        {
+            case BMM350_PMU_CMD_SUS:
+                sim.normal = false;
+                break;
+
+            case BMM350_PMU_CMD_NM:
+            case BMM350_PMU_CMD_NM_TC:
+                if (!sim.normal)
+                {
+                    sim.normal = true;
+                    sim.nm_start_us = sim.time_us;
+                    sim.published = 0;
+                }
+
+                break;
+
+            case BMM350_PMU_CMD_UPD_OAE:
+                sim.period_us = UINT32_C(625) << (sim.regs[BMM350_REG_PMU_CMD_AGGR_SET] & BMM350_ODR_MSK);
+                break;
+
+            case BMM350_PMU_CMD_FGR:
+            case BMM350_PMU_CMD_FGR_FAST:
+                /* The flux guide reset removes the magnetization left by a shock */
+                memset(sim.residual, 0, sizeof(sim.residual));
+                break;
+
+            default:
+                break;
+        }
+
+        *status = (uint8_t)((cmd_value[cmd] << BMM350_PMU_CMD_VALUE_POS) |
+                            (sim.normal ? BMM350_PWR_MODE_IS_NORMAL_MSK : 0));
+    }
+}
+
+/*!
+ *  @brief This internal API is used to release a hung bus, resetting the device if the hang came with a reset.
+ */
+static void sim_release_bus(void)
+{
+    sim.bus_hung = false;
+
+    if (sim.reset_on_release)
+    {
+        sim.reset_on_release = false;
+        sim_reset_regs();
+    }
+}
+
+/*!
+ *  @brief Bus clear of the simulated host: nine clocks and a stop condition release the bus.
+ */
+static BMM350_INTF_RET_TYPE sim_bus_clear(void *intf_ptr)
+{
+    (void)intf_ptr;
+
+    sim.time_us += BUS_CLEAR_US;
+
+    if (sim.bus_hung)
+    {
+        sim_release_bus();
+    }
+
+    return BMM350_INTF_RET_SUCCESS;
+}
+
+/*!
+ *  @brief Bus read of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+    uint32_t index;
+
+    (void)intf_ptr;
+
+    sim.time_us += BUS_OVERHEAD_US + BUS_BYTE_US * (length + 1);
+    sim_update();
+
+    if (sim.time_us < sim.nack_until_us)
+    {
+        rslt = -1;
+    }
+    else if (sim.bus_hung)
+    {
+        /* The host controller gives up after its transfer timeout */
+        sim.time_us += HOST_TIMEOUT_US;
+        rslt = BUS_TIMEOUT_CODE;
+    }
+    else
+    {
+        /* Two dummy bytes precede the data */
+        for (index = 0; index < length; index++)
+        {
+            reg_data[index] =
+                (index < BMM350_DUMMY_BYTES) ? 0 : sim.regs[(reg_addr + index - BMM350_DUMMY_BYTES) & 0x7F];
+        }
+
+        /* Reading INT_STATUS clears data ready */
+        if ((reg_addr <= BMM350_REG_INT_STATUS) && (reg_addr + length - BMM350_DUMMY_BYTES > BMM350_REG_INT_STATUS))
+        {
+            sim.regs[BMM350_REG_INT_STATUS] &= (uint8_t)~BMM350_DRDY_DATA_REG_MSK;
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief Bus write of the simulated sensor.
+ */
+static BMM350_INTF_RET_TYPE sim_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+    uint32_t index;
+    uint8_t reg;
+
+    (void)intf_ptr;
+
+    sim.time_us += BUS_OVERHEAD_US + BUS_BYTE_US * (length + 1);
+    sim_update();
+
+    if (sim.time_us < sim.nack_until_us)
+    {
+        rslt = -1;
+    }
+    else if (sim.bus_hung)
+    {
+        sim.time_us += HOST_TIMEOUT_US;
+        rslt = BUS_TIMEOUT_CODE;
+    }
+    else
+    {
+        for (index = 0; index < length; index++)
+        {
+            reg = (uint8_t)((reg_addr + index) & 0x7F);
+            sim.regs[reg] = reg_data[index];
+
+            if (reg == BMM350_REG_PMU_CMD)
+            {
+                sim_pmu_cmd(reg_data[index]);
+            }
+            else if ((reg == BMM350_REG_OTP_CMD_REG) && ((reg_data[index] & BMM350_OTP_CMD_DIR_READ) != 0))
+            {
+                /* Blank OTP: all words read as 0 */
+                sim.regs[BMM350_REG_OTP_DATA_MSB_REG] = 0;
+                sim.regs[BMM350_REG_OTP_DATA_LSB_REG] = 0;
+                sim.regs[BMM350_REG_OTP_STATUS_REG] = BMM350_OTP_STATUS_CMD_DONE;
+
+                if (sim.otp_error_pending)
+                {
+                    sim.otp_error_pending = false;
+                    sim.regs[BMM350_REG_OTP_STATUS_REG] |= BMM350_OTP_STATUS_PAGE_RD_ERR;
+                    sim_activate();
+                }
+            }
+            else if ((reg == BMM350_REG_CMD) && (reg_data[index] == BMM350_CMD_SOFTRESET))
+            {
+                /* Soft-reset also recovers a hung PMU */
+                sim_reset_regs();
+            }
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief Delay of the simulated host: advances the simulated time.
+ */
+static void sim_delay_us(uint32_t period_us, void *intf_ptr)
+{
+    (void)intf_ptr;
+
+    sim.time_us += period_us;
+}
+
+/*!
+ *  @brief This internal API is used to record the result of an API call.
+ */
+static void count_code(int8_t rslt, struct result *res)
+{
+    if ((rslt < 0) && (-rslt < NUM_CODES))
+    {
+        res->codes[-rslt]++;
+    }
+
+    if (rslt < 0)
+    {
+        sim_detect();
+    }
+}
+
+/*!
+ *  @brief This internal API is used to initialize and configure the sensor and the I2C recovery,
+ *  repeating until it succeeds.
+ */
+static uint32_t reinit(struct result *res,
+                       struct bmm350_i2c_recovery *i2c_rec,
+                       struct bmm350_dev *dev,
+                       uint64_t end_us)
+{
+    const struct bmm350_i2c_recovery_config i2c_config = {
+        BUS_SPEED_HZ, 0, BUS_TIMEOUT_CODE, sim_bus_clear, I2C_RECOVERY_ATTEMPTS
+    };
+
+    int8_t rslt;
+    uint32_t attempts = 0;
+    struct bmm350_i2c_recovery_stats i2c_stats;
+
+    do
+    {
+        attempts++;
+
+        rslt = bmm350_init(dev);
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_set_odr_performance(ODR, BMM350_NO_AVERAGING, dev);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, dev);
+        }
+
+        /* Enable the I2C watchdog and take the configuration as reference, keeping the statistics */
+        if (rslt == BMM350_OK)
+        {
+            i2c_stats = i2c_rec->stats;
+            rslt = bmm350_i2c_recovery_init(&i2c_config, i2c_rec, dev);
+            i2c_rec->stats = i2c_stats;
+        }
+
+        count_code(rslt, res);
+
+        if (rslt != BMM350_OK)
+        {
+            /* The bus may be hung with the watchdog disabled by a reset */
+            (void)sim_bus_clear(NULL);
+            sim_delay_us(REINIT_BACKOFF_US, NULL);
+        }
+    } while ((rslt != BMM350_OK) && (sim.time_us < end_us));
+
+    return attempts;
+}
+
+/*!
+ *  @brief This internal API is used to run one scenario.
+ */
+static void run_scenario(enum fault_type fault, float rate, uint32_t run_s, struct result *res)
+{
+    struct bmm350_dev dev = { 0 };
+    struct bmm350_i2c_recovery i2c_rec = { 0 };
+    struct bmm350_mag_temp_data data;
+    uint64_t end_us, last_data_us, next_maint_us, next_reinit_us, hang_start_us;
+    uint32_t sensortime, last_sensortime = UINT32_MAX;
+    uint32_t last_serial = 0;
+    bool workload = true;
+    uint8_t drdy, attempt, index, resync;
+    uint32_t resyncs;
+    bool out_of_range = false, valid, hang_retry;
+    int8_t rslt;
+    float magnitude;
+
+    memset(res, 0, sizeof(*res));
+    memset(&sim, 0, sizeof(sim));
+
+    sim.seed = UINT32_C(0x2545F491);
+    sim.fault = fault;
+    sim.rate = rate;
+    sim.field[0] = 20.0f;
+    sim.field[1] = 5.0f;
+    sim.field[2] = -40.0f;
+    sim_reset_regs();
+
+    if (fault != FAULT_NONE)
+    {
+        sim.next_fault_us = (uint64_t)(-logf(1.0f - rand_uniform()) / rate * 1e6f);
+    }
+    else
+    {
+        sim.next_fault_us = UINT64_MAX;
+    }
+
+    dev.read = sim_read;
+    dev.write = sim_write;
+    dev.delay_us = sim_delay_us;
+
+    end_us = (uint64_t)run_s * 1000000;
+
+    /* Failed attempts of a planned power cycle count as recovery */
+    res->reinits += reinit(res, &i2c_rec, &dev, end_us) - 1;
+
+    last_data_us = sim.time_us;
+    next_maint_us = sim.time_us + MAINT_RESET_PERIOD_US;
+    next_reinit_us = sim.time_us + REINIT_PERIOD_US;
+
+    while (sim.time_us < end_us)
+    {
+        /* Workload: power cycle and periodic magnetic reset */
+        if (sim.time_us >= next_reinit_us)
+        {
+            next_reinit_us += REINIT_PERIOD_US;
+            res->reinits += reinit(res, &i2c_rec, &dev, end_us) - 1;
+            last_data_us = sim.time_us;
+            workload = true;
+        }
+        else if (sim.time_us >= next_maint_us)
+        {
+            next_maint_us += MAINT_RESET_PERIOD_US;
+            rslt = bmm350_magnetic_reset_and_wait(&dev);
+            count_code(rslt, res);
+
+            if (rslt != BMM350_OK)
+            {
+                res->reinits += reinit(res, &i2c_rec, &dev, end_us);
+            }
+
+            last_data_us = sim.time_us;
+            workload = true;
+        }
+
+        /* Poll data ready, then read; retry a failed access */
+        drdy = 0;
+        rslt = BMM350_E_COM_FAIL;
+
+        for (attempt = 0; (attempt <= MAX_RETRIES) && (rslt != BMM350_OK); attempt++)
+        {
+            if (attempt != 0)
+            {
+                res->retries++;
+                sim_delay_us(RETRY_DELAY_US, NULL);
+            }
+
+            rslt = bmm350_get_interrupt_status(&drdy, &dev);
+
+            if ((rslt == BMM350_OK) && (drdy == BMM350_ENABLE))
+            {
+                rslt = bmm350_get_compensated_mag_xyz_temp_sensortime(&data, &sensortime, &dev);
+            }
+
+            count_code(rslt, res);
+
+            /* A bus hang is recovered by the I2C recovery, then the access is repeated */
+            if (rslt == BMM350_E_COM_FAIL)
+            {
+                hang_start_us = sim.time_us;
+                resyncs = i2c_rec.stats.resyncs;
+                rslt = bmm350_i2c_recovery_handle(rslt, &hang_retry, &i2c_rec, &dev);
+
+                if (hang_retry)
+                {
+                    resync = (i2c_rec.stats.resyncs != resyncs) ? 1 : 0;
+                    res->hang_cost_sum_us[resync] += sim.time_us - hang_start_us;
+
+                    if ((sim.time_us - hang_start_us) > res->hang_cost_max_us[resync])
+                    {
+                        res->hang_cost_max_us[resync] = sim.time_us - hang_start_us;
+                    }
+
+                    rslt = BMM350_E_COM_FAIL;
+                }
+            }
+        }
+
+        if ((rslt == BMM350_OK) && (drdy == BMM350_ENABLE) && (sensortime != last_sensortime))
+        {
+            last_sensortime = sensortime;
+            last_data_us = sim.time_us;
+
+            /* Samples overwritten before this one are the workload's if it ran since the last read, else lost */
+            if (workload)
+            {
+                res->consumed += sim.published_total - last_serial - 1;
+                workload = false;
+            }
+
+            last_serial = sim.published_total;
+
+            magnitude = sqrtf(data.x * data.x + data.y * data.y + data.z * data.z);
+
+            /* Out of range: invalid until back in range, then a magnetic reset clears the magnetization */
+            if (magnitude >= OOR_ENTER_UT)
+            {
+                out_of_range = true;
+            }
+            else if (out_of_range && (magnitude < OOR_EXIT_UT))
+            {
+                out_of_range = false;
+                rslt = bmm350_magnetic_reset_and_wait(&dev);
+                count_code(rslt, res);
+            }
+
+            valid = !out_of_range && (fabsf(data.x - sim.field[0]) < VALID_TOLERANCE_UT) &&
+                    (fabsf(data.y - sim.field[1]) < VALID_TOLERANCE_UT) &&
+                    (fabsf(data.z - sim.field[2]) < VALID_TOLERANCE_UT);
+
+            if (valid)
+            {
+                res->valid++;
+
+                /* Every fault activated and detected so far is recovered; an undetected one was swallowed */
+                for (index = 0; index < sim.n_pending; index++)
+                {
+                    if (!sim.pending_detected[index])
+                    {
+                        res->undetected++;
+                        continue;
+                    }
+
+                    res->recoveries++;
+                    res->recovery_sum_us += sim.time_us - sim.pending_us[index];
+
+                    if ((sim.time_us - sim.pending_us[index]) > res->recovery_max_us)
+                    {
+                        res->recovery_max_us = sim.time_us - sim.pending_us[index];
+                    }
+                }
+
+                sim.n_pending = 0;
+            }
+            else
+            {
+                sim_detect();
+            }
+        }
+        else if ((sim.time_us - last_data_us) > (uint64_t)STALL_PERIODS * ODR_PERIOD_US)
+        {
+            /* No data: the sensor or the bus is stuck, start over */
+            sim_detect();
+            res->reinits += reinit(res, &i2c_rec, &dev, end_us);
+            last_data_us = sim.time_us;
+        }
+
+        sim_delay_us(POLL_US, NULL);
+    }
+
+    /* Samples still unread at the end of the run */
+    res->consumed += sim.published_total - last_serial;
+    res->published = sim.published_total;
+    res->i2c = i2c_rec.stats;
+}
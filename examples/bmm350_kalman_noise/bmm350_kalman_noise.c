@@ -0,0 +1,222 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_kalman_noise.c
+*
+* @brief Noise reduction of the per-axis Kalman filter on a synthetic 100Hz stream without averaging.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bmm350_kalman.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Samples per run: 60s at 100Hz, and samples skipped while the filter settles */
+#define NUM_SAMPLES      UINT16_C(6000)
+#define SETTLE_SAMPLES   UINT16_C(1000)
+
+/*! Samples per call of bmm350_kf_process_block */
+#define BLOCK_SAMPLES    UINT16_C(64)
+
+/*! Sample period at 100Hz in s */
+#define SAMPLE_PERIOD_S  (0.01f)
+
+/*! Mean field in uT */
+#define FIELD_OFFSET_UT  (20.0f)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Structure to define a simulated scenario
+ */
+struct scenario
+{
+    /*! Name printed in the report */
+    const char *name;
+
+    /*! Amplitude of the sine in uT */
+    float amplitude;
+
+    /*! Frequency of the sine in Hz */
+    float frequency;
+
+    /*! Weight of the noise adaptation, 0 keeps the default noises fixed */
+    float alpha;
+};
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ *
+ *  @return Random value with zero mean and unit variance.
+ */
+static float rand_normal(void);
+
+/*!
+ *  @brief This internal API is used to filter one scenario and print the rms error before and after the filter.
+ *
+ *  @param[in] scn        : Scenario
+ *  @param[out] worse     : Flag set when the output error exceeds the input error on an axis
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_scenario(const struct scenario *scn, bool *worse);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(void)
+{
+    int8_t rslt = BMM350_OK;
+    uint8_t indx, regressions = 0;
+    bool worse;
+
+    /* Default settings, and once without adaptation for comparison */
+    const struct scenario scenarios[] = {
+        { "slow sine", 5.0f, 0.1f, BMM350_KF_DEFAULT_ALPHA }, { "sine 0.5Hz", 5.0f, 0.5f, BMM350_KF_DEFAULT_ALPHA },
+        { "sine 2Hz", 5.0f, 2.0f, BMM350_KF_DEFAULT_ALPHA }, { "0.5Hz fixed", 5.0f, 0.5f, 0.0f }
+    };
+
+    printf("Nominal rms noise in uT: x,y %.3f z %.3f without averaging, x,y %.3f z %.3f with AVG_8\n\n",
+           BMM350_KF_NOISE_XY_NO_AVG,
+           BMM350_KF_NOISE_Z_NO_AVG,
+           BMM350_KF_NOISE_XY_NO_AVG / sqrtf(8.0f),
+           BMM350_KF_NOISE_Z_NO_AVG / sqrtf(8.0f));
+
+    printf("%-12s %10s %10s %10s %10s %12s %12s\n", "scenario", "x in rms", "x out rms", "z in rms", "z out rms",
+           "x noise", "x process");
+
+    for (indx = 0; (indx < (sizeof(scenarios) / sizeof(scenarios[0]))) && (rslt == BMM350_OK); indx++)
+    {
+        srand(1);
+        rslt = run_scenario(&scenarios[indx], &worse);
+
+        /* With adaptation the filter must not be worse than the raw data */
+        if ((rslt == BMM350_OK) && worse && (scenarios[indx].alpha > 0.0f))
+        {
+            regressions++;
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("\nScenarios with adaptation where the output is noisier than the input: %u\n", regressions);
+
+        if (regressions > 0)
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ */
+static float rand_normal(void)
+{
+    float u1 = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+    float u2 = (float)rand() / (float)RAND_MAX;
+
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+/*!
+ *  @brief This internal API is used to filter one scenario and print the rms error before and after the filter.
+ */
+static int8_t run_scenario(const struct scenario *scn, bool *worse)
+{
+    int8_t rslt;
+    static struct bmm350_mag_temp_data in[NUM_SAMPLES];
+    static struct bmm350_mag_temp_data out[NUM_SAMPLES];
+    static float truth[NUM_SAMPLES];
+    struct bmm350_kf kf;
+    double err_in[2] = { 0.0 }, err_out[2] = { 0.0 };
+    uint16_t indx, len;
+
+    for (indx = 0; indx < NUM_SAMPLES; indx++)
+    {
+        truth[indx] = FIELD_OFFSET_UT + scn->amplitude *
+                      sinf(6.2831853f * scn->frequency * SAMPLE_PERIOD_S * (float)indx);
+        in[indx].x = truth[indx] + BMM350_KF_NOISE_XY_NO_AVG * rand_normal();
+        in[indx].y = truth[indx] + BMM350_KF_NOISE_XY_NO_AVG * rand_normal();
+        in[indx].z = truth[indx] + BMM350_KF_NOISE_Z_NO_AVG * rand_normal();
+        in[indx].temperature = 25.0f;
+    }
+
+    /* Same configuration as bmm350_set_odr_performance(BMM350_DATA_RATE_100HZ, BMM350_NO_AVERAGING, dev) */
+    rslt = bmm350_kf_init(BMM350_DATA_RATE_100HZ, BMM350_NO_AVERAGING, &kf);
+
+    kf.alpha = scn->alpha;
+
+    for (indx = 0; (indx < NUM_SAMPLES) && (rslt == BMM350_OK); indx += len)
+    {
+        len = ((NUM_SAMPLES - indx) < BLOCK_SAMPLES) ? (NUM_SAMPLES - indx) : BLOCK_SAMPLES;
+        rslt = bmm350_kf_process_block(&in[indx], &out[indx], len, &kf);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        for (indx = SETTLE_SAMPLES; indx < NUM_SAMPLES; indx++)
+        {
+            err_in[0] += (in[indx].x - truth[indx]) * (in[indx].x - truth[indx]);
+            err_out[0] += (out[indx].x - truth[indx]) * (out[indx].x - truth[indx]);
+            err_in[1] += (in[indx].z - truth[indx]) * (in[indx].z - truth[indx]);
+            err_out[1] += (out[indx].z - truth[indx]) * (out[indx].z - truth[indx]);
+        }
+
+        *worse = (err_out[0] > err_in[0]) || (err_out[1] > err_in[1]);
+
+        printf("%-12s %10.3f %10.3f %10.3f %10.3f %12.3f %12.1f\n",
+               scn->name,
+               sqrt(err_in[0] / (NUM_SAMPLES - SETTLE_SAMPLES)),
+               sqrt(err_out[0] / (NUM_SAMPLES - SETTLE_SAMPLES)),
+               sqrt(err_in[1] / (NUM_SAMPLES - SETTLE_SAMPLES)),
+               sqrt(err_out[1] / (NUM_SAMPLES - SETTLE_SAMPLES)),
+               sqrtf(kf.axis[0].noise_var),
+               kf.axis[0].process);
+    }
+
+    return rslt;
+}
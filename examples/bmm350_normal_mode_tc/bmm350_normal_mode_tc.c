@@ -0,0 +1,246 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @file  bmm350_normal_mode_tc.c
+*
+* @brief This file compares data quality and host read cost of normal mode and normal mode TC.
+*
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "bmm350.h"
+#include "common.h"
+#include "coines.h"
+
+/******************************************************************************/
+/*!                   Macro Definitions                                       */
+
+#define MAG_SAMPLE_COUNT  UINT8_C(100)
+
+/******************************************************************************/
+/*!                   Static Structure Definitions                            */
+
+/*!
+ * @brief Statistics of one power mode run
+ */
+struct bmm350_mode_stats
+{
+    /*! Mean of compensated mag X, Y, Z data in uT */
+    double mean_x, mean_y, mean_z;
+
+    /*! Noise (standard deviation) of compensated mag X, Y, Z data in uT */
+    double noise_x, noise_y, noise_z;
+
+    /*! Mean temperature in degC */
+    double mean_temp;
+
+    /*! Average host time spent per read and compensation in microseconds */
+    double read_time_us;
+};
+
+/******************************************************************************/
+/*!                   Static Function Declaration                             */
+
+/*!
+ *  @brief This internal API collects MAG_SAMPLE_COUNT samples in the given power mode and
+ *  calculates their statistics.
+ *
+ *  @param[in] powermode  : Power mode to characterize.
+ *  @param[out] stats     : Structure to store the statistics.
+ *  @param[in] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval = 0 -> Success
+ *  @retval < 0 -> Error
+ */
+static int8_t characterize_mode(enum bmm350_power_modes powermode,
+                                struct bmm350_mode_stats *stats,
+                                struct bmm350_dev *dev);
+
+/******************************************************************************/
+/*!            Functions                                                      */
+
+/* This function starts the execution of program */
+int main(void)
+{
+    /* Status of api are returned to this variable */
+    int8_t rslt;
+
+    /* Sensor initialization configuration */
+    struct bmm350_dev dev = { 0 };
+
+    struct bmm350_mode_stats nm_stats = { 0 };
+    struct bmm350_mode_stats nm_tc_stats = { 0 };
+
+    /* Update device structure */
+    rslt = bmm350_interface_init(&dev);
+    bmm350_error_codes_print_result("bmm350_interface_selection", rslt);
+
+    /* Initialize BMM350 */
+    rslt = bmm350_init(&dev);
+    bmm350_error_codes_print_result("bmm350_init", rslt);
+
+    printf("Read : 0x00 : BMM350 Chip ID : 0x%X\n", dev.chip_id);
+
+    /* Enable data ready interrupt to poll INT_STATUS */
+    rslt = bmm350_configure_interrupt(BMM350_PULSED,
+                                      BMM350_ACTIVE_HIGH,
+                                      BMM350_INTR_PUSH_PULL,
+                                      BMM350_UNMAP_FROM_PIN,
+                                      &dev);
+    bmm350_error_codes_print_result("bmm350_configure_interrupt", rslt);
+
+    rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, &dev);
+    bmm350_error_codes_print_result("bmm350_enable_interrupt", rslt);
+
+    /* Set ODR and performance */
+    rslt = bmm350_set_odr_performance(BMM350_DATA_RATE_100HZ, BMM350_AVERAGING_4, &dev);
+    bmm350_error_codes_print_result("bmm350_set_odr_performance", rslt);
+
+    /* Enable all axis */
+    rslt = bmm350_enable_axes(BMM350_X_EN, BMM350_Y_EN, BMM350_Z_EN, &dev);
+    bmm350_error_codes_print_result("bmm350_enable_axes", rslt);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = characterize_mode(BMM350_NORMAL_MODE, &nm_stats, &dev);
+        bmm350_error_codes_print_result("characterize_mode NORMAL", rslt);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = characterize_mode(BMM350_NORMAL_MODE_TC, &nm_tc_stats, &dev);
+        bmm350_error_codes_print_result("characterize_mode NORMAL_TC", rslt);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("\nMode, Mean_X(uT), Mean_Y(uT), Mean_Z(uT), Noise_X(uT), Noise_Y(uT), Noise_Z(uT), "
+               "Temperature(degC), Read_time(us)\n");
+
+        printf("NORMAL, %lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf\n",
+               nm_stats.mean_x,
+               nm_stats.mean_y,
+               nm_stats.mean_z,
+               nm_stats.noise_x,
+               nm_stats.noise_y,
+               nm_stats.noise_z,
+               nm_stats.mean_temp,
+               nm_stats.read_time_us);
+
+        printf("NORMAL_TC, %lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf\n",
+               nm_tc_stats.mean_x,
+               nm_tc_stats.mean_y,
+               nm_tc_stats.mean_z,
+               nm_tc_stats.noise_x,
+               nm_tc_stats.noise_y,
+               nm_tc_stats.noise_z,
+               nm_tc_stats.mean_temp,
+               nm_tc_stats.read_time_us);
+    }
+
+    rslt = bmm350_set_powermode(BMM350_SUSPEND_MODE, &dev);
+    bmm350_error_codes_print_result("bmm350_set_powermode", rslt);
+
+    bmm350_coines_deinit();
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API collects samples in the given power mode and calculates their statistics.
+ */
+static int8_t characterize_mode(enum bmm350_power_modes powermode,
+                                struct bmm350_mode_stats *stats,
+                                struct bmm350_dev *dev)
+{
+    int8_t rslt;
+
+    uint8_t int_status;
+    uint8_t loop = 0;
+    uint64_t start_us, total_us = 0;
+
+    struct bmm350_mag_temp_data mag_temp_data[MAG_SAMPLE_COUNT] = { { 0 } };
+
+    rslt = bmm350_set_powermode(powermode, dev);
+
+    while ((rslt == BMM350_OK) && (loop < MAG_SAMPLE_COUNT))
+    {
+        int_status = 0;
+
+        /* Get data ready interrupt status */
+        rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, &int_status, 1, dev);
+
+        /* Check if data ready interrupt occurred */
+        if ((rslt == BMM350_OK) && (int_status & BMM350_DRDY_DATA_REG_MSK))
+        {
+            start_us = coines_get_micro_sec();
+
+            rslt = bmm350_get_compensated_mag_xyz_temp_data(&mag_temp_data[loop], dev);
+
+            total_us += coines_get_micro_sec() - start_us;
+
+            stats->mean_x += mag_temp_data[loop].x;
+            stats->mean_y += mag_temp_data[loop].y;
+            stats->mean_z += mag_temp_data[loop].z;
+            stats->mean_temp += mag_temp_data[loop].temperature;
+
+            loop++;
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        stats->mean_x /= MAG_SAMPLE_COUNT;
+        stats->mean_y /= MAG_SAMPLE_COUNT;
+        stats->mean_z /= MAG_SAMPLE_COUNT;
+        stats->mean_temp /= MAG_SAMPLE_COUNT;
+        stats->read_time_us = (double)total_us / MAG_SAMPLE_COUNT;
+
+        for (loop = 0; loop < MAG_SAMPLE_COUNT; loop++)
+        {
+            stats->noise_x += (mag_temp_data[loop].x - stats->mean_x) * (mag_temp_data[loop].x - stats->mean_x);
+            stats->noise_y += (mag_temp_data[loop].y - stats->mean_y) * (mag_temp_data[loop].y - stats->mean_y);
+            stats->noise_z += (mag_temp_data[loop].z - stats->mean_z) * (mag_temp_data[loop].z - stats->mean_z);
+        }
+
+        stats->noise_x = sqrt(stats->noise_x / MAG_SAMPLE_COUNT);
+        stats->noise_y = sqrt(stats->noise_y / MAG_SAMPLE_COUNT);
+        stats->noise_z = sqrt(stats->noise_z / MAG_SAMPLE_COUNT);
+    }
+
+    return rslt;
+}
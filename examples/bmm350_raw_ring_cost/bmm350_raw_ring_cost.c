@@ -0,0 +1,325 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_raw_ring_cost.c
+*
+* @brief Compensation counts and cost of the raw sample ring with lazy memoized compensation.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bmm350_raw_ring.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Slots of the ring, and samples pushed in the counting run */
+#define RING_SLOTS       UINT16_C(8)
+#define COUNT_SAMPLES    UINT32_C(20)
+
+/*! Samples of the timing run, and ratio of samples pushed to samples read by the application */
+#define TIMING_SAMPLES   UINT32_C(1000000)
+#define READ_EVERY       UINT32_C(10)
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to generate a raw sample.
+ *
+ *  @param[in] seq        : Sequence number of the sample
+ *  @param[out] raw_data  : Raw sample
+ *
+ *  @return void.
+ */
+static void generate_sample(uint32_t seq, struct bmm350_raw_mag_data *raw_data);
+
+/*!
+ *  @brief This internal API is used to print the counters of the ring after a step.
+ *
+ *  @param[in] step       : Step printed in the report
+ *  @param[in] ring       : Structure that stores the state of the ring
+ *
+ *  @return void.
+ */
+static void print_counts(const char *step, const struct bmm350_raw_ring *ring);
+
+/*!
+ *  @brief This internal API is used to count compensations and memo hits on a small ring, and to check the
+ *  memoized samples against a direct compensation.
+ *
+ *  @param[in] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_counts(const struct bmm350_dev *dev);
+
+/*!
+ *  @brief This internal API is used to compare the time per sample of compensating every sample with the
+ *  ring, where the application only reads every READ_EVERY-th sample.
+ *
+ *  @param[in] dev        : Structure instance of bmm350_dev.
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_timing(const struct bmm350_dev *dev);
+
+/*!
+ *  @brief This internal API is used to get the time between two timestamps in ns.
+ */
+static double elapsed_ns(const struct timespec *start, const struct timespec *end);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(void)
+{
+    int8_t rslt;
+    struct bmm350_dev dev = { 0 };
+
+    /* Compensation needs no bus access, the default conversion and zero coefficients are enough here */
+    dev.axis_en = BMM350_EN_XYZ_MSK;
+
+    rslt = run_counts(&dev);
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = run_timing(&dev);
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to generate a raw sample.
+ */
+static void generate_sample(uint32_t seq, struct bmm350_raw_mag_data *raw_data)
+{
+    raw_data->raw_xdata = (int32_t)(seq % 1000) * 100 - 50000;
+    raw_data->raw_ydata = -300000 + (rand() % 200);
+    raw_data->raw_zdata = 500000 + (rand() % 50);
+    raw_data->raw_data_t = 3000000 + (rand() % 20);
+}
+
+/*!
+ *  @brief This internal API is used to print the counters of the ring after a step.
+ */
+static void print_counts(const char *step, const struct bmm350_raw_ring *ring)
+{
+    printf("%-36s %12lu %12lu\n",
+           step,
+           (unsigned long)ring->compensated_count,
+           (unsigned long)ring->memo_hits);
+}
+
+/*!
+ *  @brief This internal API is used to count compensations and memo hits on a small ring.
+ */
+static int8_t run_counts(const struct bmm350_dev *dev)
+{
+    int8_t rslt;
+    struct bmm350_raw_ring_slot slots[RING_SLOTS];
+    struct bmm350_raw_mag_data raw[COUNT_SAMPLES];
+    struct bmm350_mag_temp_data data[2 * RING_SLOTS], direct;
+    struct bmm350_raw_ring ring;
+    uint32_t seq, first_seq = 0, mismatch = 0;
+    uint16_t n_samples = 0, indx;
+
+    srand(1);
+
+    rslt = bmm350_raw_ring_init(slots, RING_SLOTS, &ring);
+
+    for (seq = 0; (seq < COUNT_SAMPLES) && (rslt == BMM350_OK); seq++)
+    {
+        generate_sample(seq, &raw[seq]);
+        rslt = bmm350_raw_ring_push(&raw[seq], &ring);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("%lu samples pushed into %u slots\n\n", (unsigned long)COUNT_SAMPLES, RING_SLOTS);
+        printf("%-36s %12s %12s\n", "step", "compensated", "memo hits");
+        print_counts("push", &ring);
+
+        rslt = bmm350_raw_ring_get_latest(&data[0], &ring, dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        print_counts("get latest", &ring);
+        rslt = bmm350_raw_ring_get_latest(&data[0], &ring, dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        print_counts("get latest again", &ring);
+        rslt = bmm350_raw_ring_get_range(0, data, 2 * RING_SLOTS, &n_samples, &first_seq, &ring, dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("%-36s %12lu %12lu   %u samples from %lu\n",
+               "get range from 0",
+               (unsigned long)ring.compensated_count,
+               (unsigned long)ring.memo_hits,
+               n_samples,
+               (unsigned long)first_seq);
+
+        /* The memoized samples must equal a direct compensation of the same raw samples */
+        for (indx = 0; (indx < n_samples) && (rslt == BMM350_OK); indx++)
+        {
+            rslt = bmm350_compensate_raw_mag_temp_data(&raw[first_seq + indx], 1, &direct, dev);
+
+            if (memcmp(&direct, &data[indx], sizeof(direct)) != 0)
+            {
+                mismatch++;
+            }
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_raw_ring_invalidate(&ring);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_raw_ring_get_range(COUNT_SAMPLES - 2, data, 2 * RING_SLOTS, &n_samples, &first_seq, &ring, dev);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("%-36s %12lu %12lu   %u samples from %lu\n",
+               "invalidate, get range from 18",
+               (unsigned long)ring.compensated_count,
+               (unsigned long)ring.memo_hits,
+               n_samples,
+               (unsigned long)first_seq);
+        printf("\nSamples differing from a direct compensation: %lu\n\n", (unsigned long)mismatch);
+
+        if (mismatch > 0)
+        {
+            rslt = BMM350_E_INVALID_CONFIG;
+        }
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to get the time between two timestamps in ns.
+ */
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) * 1e9 + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*!
+ *  @brief This internal API is used to compare the time per sample of compensating every sample with the ring.
+ */
+static int8_t run_timing(const struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    static struct bmm350_raw_mag_data raw[TIMING_SAMPLES];
+    struct bmm350_raw_ring_slot slots[RING_SLOTS];
+    struct bmm350_mag_temp_data data;
+    struct bmm350_raw_ring ring;
+    struct timespec t_start, t_end;
+    double eager_ns, lazy_ns;
+    volatile float sink = 0.0f;
+    uint32_t seq;
+
+    srand(1);
+
+    for (seq = 0; seq < TIMING_SAMPLES; seq++)
+    {
+        generate_sample(seq, &raw[seq]);
+    }
+
+    /* Compensate every sample as it is read */
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+    for (seq = 0; (seq < TIMING_SAMPLES) && (rslt == BMM350_OK); seq++)
+    {
+        rslt = bmm350_compensate_raw_mag_temp_data(&raw[seq], 1, &data, dev);
+        sink += data.x;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    eager_ns = elapsed_ns(&t_start, &t_end) / TIMING_SAMPLES;
+
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_raw_ring_init(slots, RING_SLOTS, &ring);
+    }
+
+    /* Store raw samples and compensate only those the application reads */
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+    for (seq = 0; (seq < TIMING_SAMPLES) && (rslt == BMM350_OK); seq++)
+    {
+        rslt = bmm350_raw_ring_push(&raw[seq], &ring);
+
+        if ((rslt == BMM350_OK) && ((seq % READ_EVERY) == 0))
+        {
+            rslt = bmm350_raw_ring_get_latest(&data, &ring, dev);
+            sink += data.x;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    lazy_ns = elapsed_ns(&t_start, &t_end) / TIMING_SAMPLES;
+
+    if (rslt == BMM350_OK)
+    {
+        printf("%lu samples, the application reads 1 in %lu:\n",
+               (unsigned long)TIMING_SAMPLES,
+               (unsigned long)READ_EVERY);
+        printf("  compensate every sample %8.1f ns per sample\n", eager_ns);
+        printf("  raw ring                %8.1f ns per sample, %lu compensations\n",
+               lazy_ns,
+               (unsigned long)ring.compensated_count);
+    }
+
+    (void)sink;
+
+    return rslt;
+}
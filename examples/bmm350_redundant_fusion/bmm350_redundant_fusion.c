@@ -0,0 +1,351 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_redundant_fusion.c
+*
+* @brief Noise and fault exclusion of the redundant sensor fusion on four simulated sensors.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bmm350_redundant.h"
+
+/******************************************************************************/
+/*!                   Macro definitions                                       */
+
+/*! Simulated sensors and samples */
+#define NUM_SENSORS      UINT8_C(4)
+#define NUM_SAMPLES      UINT16_C(6000)
+
+/*! Noise of a sensor in uT rms, sensor 1 is twice as noisy on x */
+#define NOISE_UT         (0.5f)
+#define NOISY_SENSOR     UINT8_C(1)
+
+/*! Samples before the first fault over which the noise is compared, after the weights settled */
+#define CLEAN_START      UINT16_C(500)
+#define CLEAN_END        UINT16_C(1000)
+
+/*! Fault types */
+#define FAULT_OFFSET     UINT8_C(0)
+#define FAULT_STUCK      UINT8_C(1)
+#define FAULT_OOR        UINT8_C(2)
+
+/*! Offset of the offset fault in uT, and value of the stuck axis */
+#define FAULT_OFFSET_UT  (10.0f)
+#define FAULT_STUCK_UT   (-7.25f)
+
+/*! Samples and disagreement of the two sensor run */
+#define TWO_SAMPLES      UINT16_C(100)
+
+/******************************************************************************/
+/*!                   Structure definitions                                   */
+
+/*!
+ * @brief Structure to define an injected fault and what the fusion made of it
+ */
+struct fault
+{
+    /*! Name printed in the report */
+    const char *name;
+
+    /*! Fault type, one of FAULT_* */
+    uint8_t type;
+
+    /*! Faulty sensor */
+    uint8_t sensor;
+
+    /*! First sample with the fault, and first sample without it */
+    uint16_t start;
+    uint16_t end;
+
+    /*! First sample the sensor was left out, and first sample it was used again after the fault */
+    int32_t left_out;
+    int32_t used_again;
+
+    /*! Health reported when the sensor was left out */
+    uint8_t health;
+
+    /*! Largest error of the fused sample while the fault was active, in uT */
+    float max_error;
+};
+
+/******************************************************************************/
+/*!           Static Function Declaration                                     */
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ *
+ *  @return Random value with zero mean and unit variance.
+ */
+static float rand_normal(void);
+
+/*!
+ *  @brief This internal API is used to generate the samples of all sensors and apply the active faults.
+ *
+ *  @param[in] indx       : Sample index
+ *  @param[in] faults     : Injected faults
+ *  @param[in] n_faults   : Number of faults
+ *  @param[out] truth     : True field
+ *  @param[out] samples   : Samples of the sensors
+ *  @param[out] flags     : Flags of the samples
+ *
+ *  @return void.
+ */
+static void generate_samples(uint16_t indx,
+                             const struct fault *faults,
+                             uint8_t n_faults,
+                             struct bmm350_mag_temp_data *truth,
+                             struct bmm350_mag_temp_data *samples,
+                             uint8_t *flags);
+
+/*!
+ *  @brief This internal API is used to run two disagreeing sensors, where the faulty one cannot be told.
+ *
+ *  @return Result of API execution status
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+static int8_t run_two_sensors(void);
+
+/******************************************************************************/
+/*!            Functions                                        */
+
+/* This function starts the execution of program. */
+int main(void)
+{
+    int8_t rslt;
+    struct bmm350_redundant red;
+    struct bmm350_redundant_output out;
+    struct bmm350_mag_temp_data truth, samples[NUM_SENSORS];
+    uint8_t flags[NUM_SENSORS];
+    double err_fused = 0.0, err_single = 0.0;
+    float error, noise_x[NUM_SENSORS] = { 0.0f };
+    uint16_t indx;
+    uint8_t sensor, idx;
+
+    struct fault faults[] = {
+        { "offset x", FAULT_OFFSET, 2, 1000, 2500, -1, -1, 0, 0.0f },
+        { "stuck y", FAULT_STUCK, 3, 3000, 3500, -1, -1, 0, 0.0f },
+        { "out of range", FAULT_OOR, 0, 4000, 4100, -1, -1, 0, 0.0f }
+    };
+    const uint8_t n_faults = sizeof(faults) / sizeof(faults[0]);
+
+    srand(1);
+
+    rslt = bmm350_redundant_init(NUM_SENSORS, NOISE_UT, &red);
+
+    for (indx = 0; (indx < NUM_SAMPLES) && (rslt == BMM350_OK); indx++)
+    {
+        generate_samples(indx, faults, n_faults, &truth, samples, flags);
+
+        rslt = bmm350_redundant_process(samples, flags, &out, &red);
+
+        if ((rslt == BMM350_OK) && (indx >= CLEAN_START) && (indx < CLEAN_END))
+        {
+            err_fused += (out.data.x - truth.x) * (out.data.x - truth.x);
+            err_single += (samples[0].x - truth.x) * (samples[0].x - truth.x);
+        }
+
+        if (indx == (CLEAN_END - 1))
+        {
+            /* Estimated noise on x before the first fault */
+            for (sensor = 0; sensor < NUM_SENSORS; sensor++)
+            {
+                noise_x[sensor] = sqrtf(red.sensor[sensor].var[0]);
+            }
+        }
+
+        for (idx = 0; (idx < n_faults) && (rslt == BMM350_OK); idx++)
+        {
+            sensor = faults[idx].sensor;
+
+            if ((indx >= faults[idx].start) && (indx < faults[idx].end))
+            {
+                error = fmaxf(fmaxf(fabsf(out.data.x - truth.x), fabsf(out.data.y - truth.y)),
+                              fabsf(out.data.z - truth.z));
+                faults[idx].max_error = fmaxf(faults[idx].max_error, error);
+            }
+
+            if ((indx >= faults[idx].start) && (faults[idx].left_out < 0) && !(out.used_mask & (1u << sensor)))
+            {
+                faults[idx].left_out = indx;
+                faults[idx].health = red.sensor[sensor].health;
+            }
+
+            if ((indx >= faults[idx].end) && (faults[idx].used_again < 0) && (out.used_mask & (1u << sensor)))
+            {
+                faults[idx].used_again = indx;
+            }
+        }
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("Noise on x before the first fault, samples %u to %u:\n", CLEAN_START, CLEAN_END);
+        printf("  single sensor %.3f uT rms, fused %.3f uT rms\n\n",
+               sqrt(err_single / (CLEAN_END - CLEAN_START)),
+               sqrt(err_fused / (CLEAN_END - CLEAN_START)));
+
+        printf("%-14s %6s %8s %8s %10s %8s %12s %14s\n", "fault", "sensor", "start", "end", "left out", "health",
+               "used again", "max error uT");
+
+        for (idx = 0; idx < n_faults; idx++)
+        {
+            printf("%-14s %6u %8u %8u %10ld %8u %12ld %14.3f\n",
+                   faults[idx].name,
+                   faults[idx].sensor,
+                   faults[idx].start,
+                   faults[idx].end,
+                   (long)faults[idx].left_out,
+                   faults[idx].health,
+                   (long)faults[idx].used_again,
+                   faults[idx].max_error);
+        }
+
+        printf("\n%-8s %10s %10s %12s %14s\n", "sensor", "used", "unused", "exclusions", "x noise uT");
+
+        for (sensor = 0; sensor < NUM_SENSORS; sensor++)
+        {
+            printf("%-8u %10lu %10lu %12lu %14.3f\n",
+                   sensor,
+                   (unsigned long)red.sensor[sensor].used_count,
+                   (unsigned long)red.sensor[sensor].unused_count,
+                   (unsigned long)red.sensor[sensor].exclusion_count,
+                   noise_x[sensor]);
+        }
+
+        rslt = run_two_sensors();
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API is used to generate a normally distributed random value.
+ */
+static float rand_normal(void)
+{
+    float u1 = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+    float u2 = (float)rand() / (float)RAND_MAX;
+
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+/*!
+ *  @brief This internal API is used to generate the samples of all sensors and apply the active faults.
+ */
+static void generate_samples(uint16_t indx,
+                             const struct fault *faults,
+                             uint8_t n_faults,
+                             struct bmm350_mag_temp_data *truth,
+                             struct bmm350_mag_temp_data *samples,
+                             uint8_t *flags)
+{
+    uint8_t sensor, idx;
+
+    truth->x = 20.0f + 5.0f * sinf((float)indx * 0.01f);
+    truth->y = -10.0f;
+    truth->z = 40.0f;
+    truth->temperature = 25.0f;
+
+    for (sensor = 0; sensor < NUM_SENSORS; sensor++)
+    {
+        samples[sensor].x = truth->x + NOISE_UT * rand_normal() * ((sensor == NOISY_SENSOR) ? 2.0f : 1.0f);
+        samples[sensor].y = truth->y + NOISE_UT * rand_normal();
+        samples[sensor].z = truth->z + NOISE_UT * rand_normal();
+        samples[sensor].temperature = truth->temperature;
+        flags[sensor] = 0;
+    }
+
+    for (idx = 0; idx < n_faults; idx++)
+    {
+        if ((indx >= faults[idx].start) && (indx < faults[idx].end))
+        {
+            sensor = faults[idx].sensor;
+
+            switch (faults[idx].type)
+            {
+                case FAULT_OFFSET:
+                    samples[sensor].x += FAULT_OFFSET_UT;
+                    break;
+                case FAULT_STUCK:
+                    samples[sensor].y = FAULT_STUCK_UT;
+                    break;
+                default:
+                    flags[sensor] = BMM350_REDUNDANT_FLAG_OOR;
+                    break;
+            }
+        }
+    }
+}
+
+/*!
+ *  @brief This internal API is used to run two disagreeing sensors, where the faulty one cannot be told.
+ */
+static int8_t run_two_sensors(void)
+{
+    int8_t rslt;
+    struct bmm350_redundant red;
+    struct bmm350_redundant_output out;
+    struct bmm350_mag_temp_data samples[2];
+    uint16_t indx;
+    uint8_t sensor;
+
+    rslt = bmm350_redundant_init(2, NOISE_UT, &red);
+
+    for (indx = 0; (indx < TWO_SAMPLES) && (rslt == BMM350_OK); indx++)
+    {
+        for (sensor = 0; sensor < 2; sensor++)
+        {
+            samples[sensor].x = NOISE_UT * rand_normal() + ((sensor == 1) ? FAULT_OFFSET_UT : 0.0f);
+            samples[sensor].y = NOISE_UT * rand_normal();
+            samples[sensor].z = NOISE_UT * rand_normal();
+            samples[sensor].temperature = 25.0f;
+        }
+
+        rslt = bmm350_redundant_process(samples, NULL, &out, &red);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        printf("\nTwo sensors %.0f uT apart for %u samples: %u sensors used, %lu unresolved disagreements\n",
+               FAULT_OFFSET_UT,
+               TWO_SAMPLES,
+               out.n_used,
+               (unsigned long)red.unresolved_count);
+    }
+
+    return rslt;
+}
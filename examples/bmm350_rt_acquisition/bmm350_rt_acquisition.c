@@ -0,0 +1,497 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_rt_acquisition.c
+*
+* @brief This file contains a real-time acquisition runner for Linux hosts. A worker thread
+* pinned to one CPU polls data ready four times per output data rate period, so that drift
+* between the host clock and the sensor clock cannot slip a sample, and reads data and
+* sensortime in one burst. Memory is locked and all buffers are preallocated; missing
+* privileges fall back to normal scheduling. Wake-up latency and the gaps in the sensortime
+* are reported at the end.
+*
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "bmm350.h"
+#include "linux_common.h"
+
+/******************************************************************************/
+/*!                   Macro Definitions                                       */
+
+/*! Number of samples acquired by the runner */
+#define SAMPLE_COUNT        UINT32_C(4000)
+
+/*! Output data rate: 400Hz */
+#define ODR                 BMM350_DATA_RATE_400HZ
+
+/*! Sample period of the ODR in ns and in sensortime ticks */
+#define ODR_PERIOD_NS       UINT32_C(2500000)
+#define ODR_PERIOD_TICKS    (BMM350_ODR_PERIOD_BASE_TICKS << ODR)
+
+/*! Polls per sample period */
+#define POLLS_PER_PERIOD    UINT32_C(4)
+
+/*! Stack reserved and prefaulted for the worker thread */
+#define WORKER_STACK_SIZE   (256 * 1024)
+
+#define NSEC_PER_SEC        INT64_C(1000000000)
+
+/******************************************************************************/
+/*!                   Static Structure Definitions                            */
+
+/*!
+ * @brief Runner configuration
+ */
+struct rt_config
+{
+    /*! CPU the worker thread is pinned to, -1 to not pin */
+    int cpu;
+
+    /*! Scheduling policy: SCHED_FIFO, SCHED_RR or SCHED_OTHER */
+    int policy;
+
+    /*! Real-time priority for SCHED_FIFO and SCHED_RR */
+    int priority;
+
+    /*! Poll period in ns, a fraction of the sample period */
+    uint32_t period_ns;
+};
+
+/*!
+ * @brief Sample acquired by the worker
+ */
+struct rt_sample
+{
+    /*! Compensated mag and temperature data */
+    struct bmm350_mag_temp_data data;
+
+    /*! Raw sensortime of the sample */
+    uint32_t sensortime;
+
+    /*! Wake-up latency of the worker in ns */
+    uint32_t latency_ns;
+};
+
+/*!
+ * @brief Runner state, all buffers are allocated before acquisition starts
+ */
+struct rt_runner
+{
+    struct rt_config config;
+    struct bmm350_dev *dev;
+
+    /*! Preallocated sample buffer */
+    struct rt_sample *samples;
+
+    /*! Number of valid samples */
+    uint32_t count;
+
+    /*! Number of polls without data ready */
+    uint32_t no_drdy;
+
+    /*! Sensortime extended over the samples, gaps in it and samples missing in the gaps */
+    struct bmm350_timeline timeline;
+    uint32_t gaps;
+    uint32_t missed;
+
+    /*! Result of the last API call in the worker */
+    int8_t rslt;
+
+    /*! Applied settings, after fallback */
+    int memory_locked;
+    int pinned;
+    int realtime;
+};
+
+/******************************************************************************/
+/*!                   Static Function Declaration                             */
+
+/*!
+ *  @brief This internal API prepares memory: preallocates the sample buffer and locks
+ *  current and future pages, falling back to unlocked memory without privileges.
+ *
+ *  @param[in,out] runner   : Runner state
+ *
+ *  @return 0 on success, -1 if the buffer cannot be allocated
+ */
+static int prepare_memory(struct rt_runner *runner);
+
+/*!
+ *  @brief This internal API starts the worker with the configured affinity and policy. If the
+ *  attributes are refused, it retries without them.
+ *
+ *  @param[in,out] runner   : Runner state
+ *  @param[out] thread      : Worker thread handle
+ *
+ *  @return 0 on success, error number otherwise
+ */
+static int start_worker(struct rt_runner *runner, pthread_t *thread);
+
+/*!
+ *  @brief Worker thread: absolute periodic wake-up, data ready check, burst read and sensortime gap check.
+ *
+ *  @param[in,out] arg      : Runner state
+ *
+ *  @return NULL
+ */
+static void *worker(void *arg);
+
+/*!
+ *  @brief This internal API prints the wake-up latency statistics.
+ *
+ *  @param[in,out] runner   : Runner state, the latencies are sorted in place
+ *
+ *  @return void.
+ */
+static void report_latency(struct rt_runner *runner);
+
+/******************************************************************************/
+/*!            Functions                                                      */
+
+/* This function starts the execution of program */
+int main(int argc, char *argv[])
+{
+    /* Status of api are returned to this variable */
+    int8_t rslt;
+
+    /* Sensor initialization configuration */
+    struct bmm350_dev dev = { 0 };
+    struct bmm350_linux_intf intf = { 0 };
+    struct rt_runner runner;
+    pthread_t thread;
+
+    const char *bus_path = "/dev/i2c-1";
+
+    memset(&runner, 0, sizeof(runner));
+    runner.config.cpu = 1;
+    runner.config.policy = SCHED_FIFO;
+    runner.config.priority = 80;
+    runner.config.period_ns = ODR_PERIOD_NS / POLLS_PER_PERIOD;
+    runner.dev = &dev;
+
+    if (argc > 1)
+    {
+        bus_path = argv[1];
+    }
+
+    if (argc > 2)
+    {
+        runner.config.cpu = atoi(argv[2]);
+    }
+
+    if (argc > 3)
+    {
+        runner.config.priority = atoi(argv[3]);
+        runner.config.policy = (runner.config.priority > 0) ? SCHED_FIFO : SCHED_OTHER;
+    }
+
+    rslt = bmm350_linux_interface_init(bus_path, BMM350_I2C_ADSEL_SET_LOW, &intf, &dev);
+    bmm350_linux_print_result("bmm350_linux_interface_init", rslt);
+
+    if (rslt == BMM350_OK)
+    {
+        /* Initialize BMM350 */
+        rslt = bmm350_init(&dev);
+        bmm350_linux_print_result("bmm350_init", rslt);
+
+        printf("Read : 0x00 : BMM350 Chip ID : 0x%X\n", dev.chip_id);
+
+        rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, &dev);
+        bmm350_linux_print_result("bmm350_enable_interrupt", rslt);
+
+        /* 400Hz without averaging */
+        rslt = bmm350_set_odr_performance(ODR, BMM350_NO_AVERAGING, &dev);
+        bmm350_linux_print_result("bmm350_set_odr_performance", rslt);
+
+        rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, &dev);
+        bmm350_linux_print_result("bmm350_set_powermode", rslt);
+    }
+
+    if ((rslt == BMM350_OK) && (prepare_memory(&runner) == 0))
+    {
+        if (start_worker(&runner, &thread) == 0)
+        {
+            pthread_join(thread, NULL);
+
+            printf("Memory locked : %s, Pinned to CPU %d : %s, Real-time priority %d : %s\n",
+                   runner.memory_locked ? "yes" : "no",
+                   runner.config.cpu,
+                   runner.pinned ? "yes" : "no",
+                   runner.config.priority,
+                   runner.realtime ? "yes" : "no");
+
+            printf("Samples : %lu, Polls without data ready : %lu\n",
+                   (long unsigned int)runner.count,
+                   (long unsigned int)runner.no_drdy);
+
+            printf("Sensortime gaps : %lu, Samples missed : %lu\n",
+                   (long unsigned int)runner.gaps,
+                   (long unsigned int)runner.missed);
+
+            report_latency(&runner);
+
+            rslt = runner.rslt;
+        }
+
+        free(runner.samples);
+    }
+
+    if (dev.read != NULL)
+    {
+        (void)bmm350_set_powermode(BMM350_SUSPEND_MODE, &dev);
+    }
+
+    bmm350_linux_interface_deinit(&intf);
+
+    return rslt;
+}
+
+/*!
+ *  @brief This internal API prepares memory.
+ */
+static int prepare_memory(struct rt_runner *runner)
+{
+    int ret = 0;
+
+    runner->samples = calloc(SAMPLE_COUNT, sizeof(struct rt_sample));
+
+    if (runner->samples == NULL)
+    {
+        printf("Could not allocate the sample buffer\n");
+        ret = -1;
+    }
+    else
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        {
+            runner->memory_locked = 1;
+        }
+        else
+        {
+            printf("mlockall failed (%s), continuing with unlocked memory\n", strerror(errno));
+        }
+
+        /* Touch every page of the buffer so no page fault happens during acquisition */
+        memset(runner->samples, 0, SAMPLE_COUNT * sizeof(struct rt_sample));
+    }
+
+    return ret;
+}
+
+/*!
+ *  @brief This internal API starts the worker with the configured affinity and policy.
+ */
+static int start_worker(struct rt_runner *runner, pthread_t *thread)
+{
+    int ret;
+    pthread_attr_t attr;
+    struct sched_param param;
+    cpu_set_t cpus;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, WORKER_STACK_SIZE);
+
+    if (runner->config.cpu >= 0)
+    {
+        CPU_ZERO(&cpus);
+        CPU_SET(runner->config.cpu, &cpus);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+
+    if (runner->config.policy != SCHED_OTHER)
+    {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = runner->config.priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, runner->config.policy);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    runner->pinned = (runner->config.cpu >= 0);
+    runner->realtime = (runner->config.policy != SCHED_OTHER);
+
+    ret = pthread_create(thread, &attr, worker, runner);
+
+    if (ret == EPERM)
+    {
+        /* No CAP_SYS_NICE or RLIMIT_RTPRIO: fall back to normal scheduling, keep the affinity */
+        printf("Real-time policy refused (%s), falling back to SCHED_OTHER\n", strerror(ret));
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        runner->realtime = 0;
+        ret = pthread_create(thread, &attr, worker, runner);
+    }
+
+    if (ret == EINVAL)
+    {
+        /* CPU not available: fall back to no pinning */
+        printf("CPU %d not available, running without pinning\n", runner->config.cpu);
+        pthread_attr_destroy(&attr);
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, WORKER_STACK_SIZE);
+        runner->pinned = 0;
+        runner->realtime = 0;
+        ret = pthread_create(thread, &attr, worker, runner);
+    }
+
+    if (ret != 0)
+    {
+        printf("Could not start the worker thread : %s\n", strerror(ret));
+    }
+
+    pthread_attr_destroy(&attr);
+
+    return ret;
+}
+
+/*!
+ *  @brief Worker thread.
+ */
+static void *worker(void *arg)
+{
+    struct rt_runner *runner = (struct rt_runner *)arg;
+    struct timespec next, now;
+    struct rt_sample *sample;
+    uint8_t int_status;
+    uint32_t missed;
+    int64_t latency;
+
+    /* Prefault the stack used by the driver calls */
+    volatile uint8_t stack_touch[16 * 1024];
+
+    memset((void *)stack_touch, 0, sizeof(stack_touch));
+
+    runner->rslt = BMM350_OK;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while ((runner->count < SAMPLE_COUNT) && (runner->rslt == BMM350_OK))
+    {
+        next.tv_nsec += runner->config.period_ns;
+
+        if (next.tv_nsec >= NSEC_PER_SEC)
+        {
+            next.tv_nsec -= NSEC_PER_SEC;
+            next.tv_sec++;
+        }
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+        {
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        latency = ((int64_t)(now.tv_sec - next.tv_sec) * NSEC_PER_SEC) + (now.tv_nsec - next.tv_nsec);
+
+        /* Existing data ready and burst read path of the driver */
+        int_status = 0;
+        runner->rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, &int_status, 1, runner->dev);
+
+        if ((runner->rslt == BMM350_OK) && (int_status & BMM350_DRDY_DATA_REG_MSK))
+        {
+            sample = &runner->samples[runner->count];
+            runner->rslt = bmm350_get_compensated_mag_xyz_temp_sensortime(&sample->data,
+                                                                          &sample->sensortime,
+                                                                          runner->dev);
+            sample->latency_ns = (uint32_t)((latency > 0) ? latency : 0);
+            runner->count++;
+
+            /* A step of more than one sample period in the sensortime means samples were missed */
+            if (runner->rslt == BMM350_OK)
+            {
+                runner->rslt = bmm350_extend_sensortime(sample->sensortime,
+                                                        ODR_PERIOD_TICKS,
+                                                        &missed,
+                                                        &runner->timeline);
+
+                if (missed != 0)
+                {
+                    runner->gaps++;
+                    runner->missed += missed;
+                }
+            }
+        }
+        else
+        {
+            runner->no_drdy++;
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ *  @brief Comparison function for sorting the latencies
+ */
+static int compare_latency(const void *a, const void *b)
+{
+    uint32_t la = ((const struct rt_sample *)a)->latency_ns;
+    uint32_t lb = ((const struct rt_sample *)b)->latency_ns;
+
+    return (la > lb) - (la < lb);
+}
+
+/*!
+ *  @brief This internal API prints the wake-up latency statistics.
+ */
+static void report_latency(struct rt_runner *runner)
+{
+    uint32_t indx;
+    uint64_t sum = 0;
+
+    if (runner->count > 0)
+    {
+        for (indx = 0; indx < runner->count; indx++)
+        {
+            sum += runner->samples[indx].latency_ns;
+        }
+
+        /* Sorting reorders the samples; done after acquisition */
+        qsort(runner->samples, runner->count, sizeof(struct rt_sample), compare_latency);
+
+        printf("Wake-up latency(us) : min %.1f, mean %.1f, p99 %.1f, max %.1f\n",
+               runner->samples[0].latency_ns / 1000.0,
+               (double)sum / runner->count / 1000.0,
+               runner->samples[(runner->count * 99) / 100].latency_ns / 1000.0,
+               runner->samples[runner->count - 1].latency_ns / 1000.0);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  bmm350_shared_bus.c
+*
+* @brief This file contains reading of magnetometer data on a Linux i2c-dev bus that
+* is shared with other processes, and reports the bus contention.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bmm350.h"
+#include "linux_common.h"
+
+/******************************************************************************/
+/*!                   Macro Definitions                                       */
+
+#define SAMPLE_COUNT        UINT16_C(1000)
+
+/*! Number of samples between two contention reports */
+#define REPORT_INTERVAL     UINT16_C(100)
+
+/******************************************************************************/
+/*!            Functions                                                      */
+
+/* This function starts the execution of program */
+int main(int argc, char *argv[])
+{
+    /* Status of api are returned to this variable */
+    int8_t rslt;
+
+    /* Sensor initialization configuration */
+    struct bmm350_dev dev = { 0 };
+    struct bmm350_linux_intf intf = { 0 };
+
+    const char *bus_path = "/dev/i2c-1";
+    const char *shm_name = "/bmm350_i2c-1";
+    uint8_t dev_addr = BMM350_I2C_ADSEL_SET_LOW;
+
+    uint8_t int_status;
+    uint16_t samples = 0;
+    uint32_t sensortime;
+
+    struct bmm350_mag_temp_data mag_temp_data = { 0 };
+
+    if (argc > 1)
+    {
+        bus_path = argv[1];
+    }
+
+    if (argc > 2)
+    {
+        shm_name = argv[2];
+    }
+
+    if (argc > 3)
+    {
+        dev_addr = (uint8_t)strtoul(argv[3], NULL, 0);
+    }
+
+    rslt = bmm350_linux_interface_init(bus_path, dev_addr, &intf, &dev);
+    bmm350_linux_print_result("bmm350_linux_interface_init", rslt);
+
+    /* All processes on this bus must use the same shared memory name */
+    if (rslt == BMM350_OK)
+    {
+        rslt = bmm350_linux_shared_bus_open(shm_name, &intf, &dev);
+        bmm350_linux_print_result("bmm350_linux_shared_bus_open", rslt);
+    }
+
+    if (rslt == BMM350_OK)
+    {
+        /* Initialize BMM350 */
+        rslt = bmm350_init(&dev);
+        bmm350_linux_print_result("bmm350_init", rslt);
+
+        printf("Read : 0x00 : BMM350 Chip ID : 0x%X\n", dev.chip_id);
+
+        /* Enable data ready interrupt */
+        rslt = bmm350_enable_interrupt(BMM350_ENABLE_INTERRUPT, &dev);
+        bmm350_linux_print_result("bmm350_enable_interrupt", rslt);
+
+        /* Set ODR and performance */
+        rslt = bmm350_set_odr_performance(BMM350_DATA_RATE_100HZ, BMM350_AVERAGING_4, &dev);
+        bmm350_linux_print_result("bmm350_set_odr_performance", rslt);
+
+        rslt = bmm350_set_powermode(BMM350_NORMAL_MODE, &dev);
+        bmm350_linux_print_result("bmm350_set_powermode", rslt);
+
+        printf("Samples, Locks, Contended, Wait total(us), Wait max(us), Owner dead recoveries\n");
+
+        while ((rslt == BMM350_OK) && (samples < SAMPLE_COUNT))
+        {
+            int_status = 0;
+
+            /* Get data ready interrupt status */
+            rslt = bmm350_get_regs(BMM350_REG_INT_STATUS, &int_status, 1, &dev);
+            bmm350_linux_print_result("bmm350_get_regs", rslt);
+
+            if (int_status & BMM350_DRDY_DATA_REG_MSK)
+            {
+                /* One burst read holds the bus once for data and sensortime */
+                rslt = bmm350_get_compensated_mag_xyz_temp_sensortime(&mag_temp_data, &sensortime, &dev);
+                bmm350_linux_print_result("bmm350_get_compensated_mag_xyz_temp_sensortime", rslt);
+
+                samples++;
+
+                if ((samples % REPORT_INTERVAL) == 0)
+                {
+                    printf("%u, %lu, %lu, %lu, %lu, %lu\n",
+                           samples,
+                           (long unsigned int)dev.bus_stats.lock_count,
+                           (long unsigned int)dev.bus_stats.contended_count,
+                           (long unsigned int)dev.bus_stats.wait_time_us,
+                           (long unsigned int)dev.bus_stats.max_wait_us,
+                           (long unsigned int)intf.shared_bus->owner_dead_count);
+                }
+            }
+            else
+            {
+                /* Sleep outside the bus lock */
+                rslt = bmm350_delay_us(1000, &dev);
+            }
+        }
+
+        rslt = bmm350_set_powermode(BMM350_SUSPEND_MODE, &dev);
+        bmm350_linux_print_result("bmm350_set_powermode", rslt);
+    }
+
+    bmm350_linux_interface_deinit(&intf);
+
+    return rslt;
+}
@@ -0,0 +1,377 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  linux_common.c
+*
+*/
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "bmm350.h"
+#include "linux_common.h"
+
+/******************************************************************************/
+/*!                Macro definition                                           */
+
+/*! Write buffer size: register address and the largest register write */
+#define LINUX_I2C_WRITE_BUFFER_LENGTH  UINT8_C(128)
+
+/*! Poll period while waiting for another process to initialize the shared lock */
+#define LINUX_SHARED_BUS_POLL_US       UINT32_C(1000)
+
+/******************************************************************************/
+/*!                Static function definition                                 */
+
+/*!
+ * @brief This internal API returns the monotonic time in microseconds
+ */
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+/******************************************************************************/
+/*!                User interface functions                                   */
+
+/*!
+ * I2C read function map to i2c-dev. Address write and data read are issued as one
+ * combined transfer with a repeated start.
+ */
+static BMM350_INTF_RET_TYPE linux_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    struct bmm350_linux_intf *intf = (struct bmm350_linux_intf *)intf_ptr;
+    struct i2c_msg msgs[2];
+    struct i2c_rdwr_ioctl_data xfer;
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+
+    msgs[0].addr = intf->dev_addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg_addr;
+
+    msgs[1].addr = intf->dev_addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = (uint16_t)length;
+    msgs[1].buf = reg_data;
+
+    xfer.msgs = msgs;
+    xfer.nmsgs = 2;
+
+    if (ioctl(intf->fd, I2C_RDWR, &xfer) != 2)
+    {
+        rslt = BMM350_E_COM_FAIL;
+    }
+
+    return rslt;
+}
+
+/*!
+ * I2C write function map to i2c-dev
+ */
+static BMM350_INTF_RET_TYPE linux_i2c_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    struct bmm350_linux_intf *intf = (struct bmm350_linux_intf *)intf_ptr;
+    uint8_t buffer[LINUX_I2C_WRITE_BUFFER_LENGTH];
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+
+    if (length < LINUX_I2C_WRITE_BUFFER_LENGTH)
+    {
+        buffer[0] = reg_addr;
+        memcpy(&buffer[1], reg_data, length);
+
+        if (write(intf->fd, buffer, length + 1) != (ssize_t)(length + 1))
+        {
+            rslt = BMM350_E_COM_FAIL;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_INVALID_INPUT;
+    }
+
+    return rslt;
+}
+
+/*!
+ * Delay function map to the Linux host
+ */
+static void linux_delay(uint32_t period, void *intf_ptr)
+{
+    struct timespec ts;
+
+    (void)intf_ptr;
+
+    ts.tv_sec = period / 1000000;
+    ts.tv_nsec = (long)(period % 1000000) * 1000;
+
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+    {
+    }
+}
+
+/*!
+ * Bus lock function map to the process-shared mutex
+ */
+static BMM350_INTF_RET_TYPE linux_bus_lock(uint32_t *wait_us, void *intf_ptr)
+{
+    struct bmm350_linux_intf *intf = (struct bmm350_linux_intf *)intf_ptr;
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+    uint64_t start_us;
+    int ret;
+
+    *wait_us = 0;
+
+    /* Only read the clock when the bus is contended */
+    ret = pthread_mutex_trylock(&intf->shared_bus->mutex);
+
+    if (ret == EBUSY)
+    {
+        start_us = monotonic_us();
+        ret = pthread_mutex_lock(&intf->shared_bus->mutex);
+        *wait_us = (uint32_t)(monotonic_us() - start_us);
+    }
+
+    if (ret == EOWNERDEAD)
+    {
+        /* Previous owner died holding the bus. Its transfer was a single ioctl, so the bus is usable. */
+        intf->shared_bus->owner_dead_count++;
+        ret = pthread_mutex_consistent(&intf->shared_bus->mutex);
+    }
+
+    if (ret != 0)
+    {
+        rslt = BMM350_E_COM_FAIL;
+    }
+
+    return rslt;
+}
+
+/*!
+ * Bus unlock function map to the process-shared mutex
+ */
+static BMM350_INTF_RET_TYPE linux_bus_unlock(void *intf_ptr)
+{
+    struct bmm350_linux_intf *intf = (struct bmm350_linux_intf *)intf_ptr;
+    BMM350_INTF_RET_TYPE rslt = BMM350_INTF_RET_SUCCESS;
+
+    if (pthread_mutex_unlock(&intf->shared_bus->mutex) != 0)
+    {
+        rslt = BMM350_E_COM_FAIL;
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief Function to open an i2c-dev bus and map the bmm350_dev callbacks to it.
+ */
+int8_t bmm350_linux_interface_init(const char *bus_path,
+                                   uint8_t dev_addr,
+                                   struct bmm350_linux_intf *intf,
+                                   struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+
+    if ((bus_path != NULL) && (intf != NULL) && (dev != NULL))
+    {
+        intf->dev_addr = dev_addr;
+        intf->shared_bus = NULL;
+        intf->fd = open(bus_path, O_RDWR);
+
+        if (intf->fd < 0)
+        {
+            printf("Could not open %s : %s\n", bus_path, strerror(errno));
+            rslt = BMM350_E_COM_FAIL;
+        }
+        else if (ioctl(intf->fd, I2C_SLAVE, (unsigned long)dev_addr) < 0)
+        {
+            printf("Could not select I2C address 0x%X : %s\n", dev_addr, strerror(errno));
+            rslt = BMM350_E_COM_FAIL;
+        }
+        else
+        {
+            dev->intf_ptr = intf;
+            dev->read = linux_i2c_read;
+            dev->write = linux_i2c_write;
+            dev->delay_us = linux_delay;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief Function to share the bus with other processes.
+ */
+int8_t bmm350_linux_shared_bus_open(const char *shm_name, struct bmm350_linux_intf *intf, struct bmm350_dev *dev)
+{
+    int8_t rslt = BMM350_OK;
+    int fd;
+    int creator = 1;
+    pthread_mutexattr_t attr;
+    void *shm;
+
+    if ((shm_name != NULL) && (intf != NULL) && (dev != NULL))
+    {
+        fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, 0660);
+
+        if ((fd < 0) && (errno == EEXIST))
+        {
+            creator = 0;
+            fd = shm_open(shm_name, O_RDWR, 0660);
+        }
+
+        if ((fd < 0) || (creator && (ftruncate(fd, sizeof(struct bmm350_linux_shared_bus)) < 0)))
+        {
+            printf("Could not open shared memory %s : %s\n", shm_name, strerror(errno));
+            rslt = BMM350_E_COM_FAIL;
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            /* Wait until the creator has sized the object */
+            struct stat st;
+
+            do
+            {
+                fstat(fd, &st);
+                if (st.st_size < (off_t)sizeof(struct bmm350_linux_shared_bus))
+                {
+                    linux_delay(LINUX_SHARED_BUS_POLL_US, NULL);
+                }
+            } while (st.st_size < (off_t)sizeof(struct bmm350_linux_shared_bus));
+
+            shm = mmap(NULL, sizeof(struct bmm350_linux_shared_bus), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+            if (shm == MAP_FAILED)
+            {
+                printf("Could not map shared memory %s : %s\n", shm_name, strerror(errno));
+                rslt = BMM350_E_COM_FAIL;
+            }
+            else
+            {
+                intf->shared_bus = (struct bmm350_linux_shared_bus *)shm;
+            }
+        }
+
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        if (rslt == BMM350_OK)
+        {
+            if (creator)
+            {
+                pthread_mutexattr_init(&attr);
+                pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+                pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+                pthread_mutex_init(&intf->shared_bus->mutex, &attr);
+                pthread_mutexattr_destroy(&attr);
+
+                __sync_synchronize();
+                intf->shared_bus->initialized = 1;
+            }
+            else
+            {
+                while (!intf->shared_bus->initialized)
+                {
+                    linux_delay(LINUX_SHARED_BUS_POLL_US, NULL);
+                }
+
+                __sync_synchronize();
+            }
+
+            dev->bus_lock = linux_bus_lock;
+            dev->bus_unlock = linux_bus_unlock;
+        }
+    }
+    else
+    {
+        rslt = BMM350_E_NULL_PTR;
+    }
+
+    return rslt;
+}
+
+/*!
+ *  @brief Function to close the bus and unmap the shared bus lock.
+ */
+void bmm350_linux_interface_deinit(struct bmm350_linux_intf *intf)
+{
+    if (intf != NULL)
+    {
+        if (intf->shared_bus != NULL)
+        {
+            munmap(intf->shared_bus, sizeof(struct bmm350_linux_shared_bus));
+            intf->shared_bus = NULL;
+        }
+
+        if (intf->fd >= 0)
+        {
+            close(intf->fd);
+            intf->fd = -1;
+        }
+    }
+}
+
+/*!
+ *  @brief Prints the execution status of the APIs.
+ */
+void bmm350_linux_print_result(const char api_name[], int8_t rslt)
+{
+    if (rslt != BMM350_OK)
+    {
+        printf("%s Error [%d]\n", api_name, rslt);
+    }
+}
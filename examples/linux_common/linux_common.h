@@ -0,0 +1,141 @@
+/**
+* Copyright (c) 2023 Bosch Sensortec GmbH. All rights reserved.
+*
+* BSD-3-Clause
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its
+*    contributors may be used to endorse or promote products derived from
+*    this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+* STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+* IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @file  linux_common.h
+*
+*/
+
+#ifndef _LINUX_COMMON_H
+#define _LINUX_COMMON_H
+
+/*! CPP guard */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+#include "bmm350.h"
+
+/******************************************************************************/
+/*!                Structure definition                                       */
+
+/*!
+ * @brief Bus lock shared between processes, placed in POSIX shared memory
+ */
+struct bmm350_linux_shared_bus
+{
+    /*! Robust, process-shared mutex guarding the bus */
+    pthread_mutex_t mutex;
+
+    /*! Set once the mutex has been initialized by the first process */
+    volatile uint32_t initialized;
+
+    /*! Number of times the lock was recovered from a process that died holding it */
+    volatile uint32_t owner_dead_count;
+};
+
+/*!
+ * @brief Linux i2c-dev interface descriptor, linked through bmm350_dev.intf_ptr
+ */
+struct bmm350_linux_intf
+{
+    /*! File descriptor of the i2c-dev bus */
+    int fd;
+
+    /*! I2C device address */
+    uint8_t dev_addr;
+
+    /*! Shared bus lock, NULL if the bus is not shared */
+    struct bmm350_linux_shared_bus *shared_bus;
+};
+
+/***************************************************************************/
+
+/*!                 User function prototypes
+ ****************************************************************************/
+
+/*!
+ *  @brief Function to open an i2c-dev bus and map the bmm350_dev callbacks to it.
+ *
+ *  @param[in] bus_path    : Path of the i2c-dev bus, e.g. /dev/i2c-1
+ *  @param[in] dev_addr    : I2C device address
+ *  @param[out] intf       : Linux interface descriptor
+ *  @param[out] dev        : Structure instance of bmm350_dev
+ *
+ *  @return Status of execution
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+int8_t bmm350_linux_interface_init(const char *bus_path,
+                                   uint8_t dev_addr,
+                                   struct bmm350_linux_intf *intf,
+                                   struct bmm350_dev *dev);
+
+/*!
+ *  @brief Function to share the bus with other processes. The lock lives in the POSIX shared
+ *  memory object shm_name, which all processes using the bus have to agree on. The mutex is
+ *  robust: if a process dies while holding it, the next process recovers it.
+ *
+ *  @param[in] shm_name    : Name of the shared memory object, e.g. /bmm350_i2c-1
+ *  @param[in,out] intf    : Linux interface descriptor
+ *  @param[out] dev        : Structure instance of bmm350_dev
+ *
+ *  @return Status of execution
+ *  @retval 0 -> Success
+ *  @retval < 0 -> Failure Info
+ */
+int8_t bmm350_linux_shared_bus_open(const char *shm_name, struct bmm350_linux_intf *intf, struct bmm350_dev *dev);
+
+/*!
+ *  @brief Function to close the bus and unmap the shared bus lock.
+ *
+ *  @param[in,out] intf    : Linux interface descriptor
+ *
+ *  @return void.
+ */
+void bmm350_linux_interface_deinit(struct bmm350_linux_intf *intf);
+
+/*!
+ *  @brief Prints the execution status of the APIs.
+ *
+ *  @param[in] api_name : Name of the API whose execution status has to be printed.
+ *  @param[in] rslt     : Error code returned by the API whose execution status has to be printed.
+ *
+ *  @return void.
+ */
+void bmm350_linux_print_result(const char api_name[], int8_t rslt);
+
+#ifdef __cplusplus
+}
+#endif /* End of CPP guard */
+
+#endif /* _LINUX_COMMON_H */